@@ -0,0 +1,113 @@
+#include "AdapterCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#define ADAPTER_CACHE_ENTRY_BYTES (32u)
+
+namespace
+{
+    void PutLE(std::vector<uint8_t>& bytes, const uint64_t value, const size_t size)
+    {
+        for (size_t i = 0u; i < size; ++i)
+            bytes.push_back(static_cast<uint8_t>(value >> (8u * i)));
+    }
+
+    uint64_t GetLE(const uint8_t* bytes, const size_t size)
+    {
+        uint64_t value = 0u;
+        for (size_t i = 0u; i < size; ++i)
+            value |= static_cast<uint64_t>(bytes[i]) << (8u * i);
+        return value;
+    }
+}
+
+const AdapterCache::Entry* AdapterCache::Find(const AdapterKey& key) const
+{
+    const auto entry = std::find_if(m_entries.begin(), m_entries.end(), [&key](const Entry& e) { return e.Key == key; });
+    return entry != m_entries.end() ? &*entry : nullptr;
+}
+
+void AdapterCache::Set(const AdapterKey& key, const uint32_t maxFeatureLevel)
+{
+    const Entry* existing = Find(key);
+    if (existing && existing->MaxFeatureLevel == maxFeatureLevel)
+        return;
+
+    Remove(key);
+    if (m_entries.size() >= ADAPTER_CACHE_MAX_ENTRIES)
+        m_entries.erase(m_entries.begin());
+    m_entries.push_back(Entry{ key, maxFeatureLevel });
+    m_dirty = true;
+}
+
+void AdapterCache::Remove(const AdapterKey& key)
+{
+    const auto end = std::remove_if(m_entries.begin(), m_entries.end(), [&key](const Entry& e) { return e.Key == key; });
+    if (end == m_entries.end())
+        return;
+
+    m_entries.erase(end, m_entries.end());
+    m_dirty = true;
+}
+
+bool AdapterCache::Load(const std::filesystem::path& path)
+{
+    m_entries.clear();
+    m_dirty = false;
+
+    std::ifstream inFile(path, std::ios::in | std::ios::binary);
+    if (!inFile.is_open() || !inFile.good())
+        return false;
+
+    const std::vector<uint8_t> bytes{ std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>() };
+    if (bytes.size() < 12u || GetLE(bytes.data(), 4u) != ADAPTER_CACHE_MAGIC || GetLE(bytes.data() + 4u, 4u) != ADAPTER_CACHE_VERSION)
+        return false;
+
+    const uint64_t count = GetLE(bytes.data() + 8u, 4u);
+    if (count > ADAPTER_CACHE_MAX_ENTRIES || bytes.size() != 12u + count * ADAPTER_CACHE_ENTRY_BYTES)
+        return false;
+
+    for (const uint8_t* entry = bytes.data() + 12u; entry != bytes.data() + bytes.size(); entry += ADAPTER_CACHE_ENTRY_BYTES)
+    {
+        Entry e{};
+        e.Key.VendorId = static_cast<uint32_t>(GetLE(entry, 4u));
+        e.Key.DeviceId = static_cast<uint32_t>(GetLE(entry + 4u, 4u));
+        e.Key.SubSysId = static_cast<uint32_t>(GetLE(entry + 8u, 4u));
+        e.Key.Revision = static_cast<uint32_t>(GetLE(entry + 12u, 4u));
+        e.Key.DriverVersion = GetLE(entry + 16u, 8u);
+        e.MaxFeatureLevel = static_cast<uint32_t>(GetLE(entry + 24u, 4u));
+        m_entries.push_back(e);
+    }
+    return true;
+}
+
+bool AdapterCache::Save(const std::filesystem::path& path)
+{
+    std::vector<uint8_t> bytes;
+    PutLE(bytes, ADAPTER_CACHE_MAGIC, 4u);
+    PutLE(bytes, ADAPTER_CACHE_VERSION, 4u);
+    PutLE(bytes, m_entries.size(), 4u);
+    for (const Entry& entry : m_entries)
+    {
+        PutLE(bytes, entry.Key.VendorId, 4u);
+        PutLE(bytes, entry.Key.DeviceId, 4u);
+        PutLE(bytes, entry.Key.SubSysId, 4u);
+        PutLE(bytes, entry.Key.Revision, 4u);
+        PutLE(bytes, entry.Key.DriverVersion, 8u);
+        PutLE(bytes, entry.MaxFeatureLevel, 4u);
+        PutLE(bytes, 0u, 4u); // Reserved
+    }
+
+    std::ofstream outFile(path, std::ios::trunc | std::ios::out | std::ios::binary);
+    if (!outFile.is_open() || !outFile.good())
+        return false;
+
+    outFile.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!outFile.good())
+        return false;
+
+    m_dirty = false;
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#define ADAPTER_CACHE_MAGIC (0x41534644u) // "DFSA"
+#define ADAPTER_CACHE_VERSION (1u)
+#define ADAPTER_CACHE_MAX_ENTRIES (64u)    // Oldest entries are dropped past this, e.g. after many driver updates
+
+// What an adapter is, a new driver makes it a different adapter
+struct AdapterKey
+{
+    uint32_t VendorId;
+    uint32_t DeviceId;
+    uint32_t SubSysId;
+    uint32_t Revision;
+    uint64_t DriverVersion;
+
+    bool operator==(const AdapterKey& other) const
+    {
+        return VendorId == other.VendorId && DeviceId == other.DeviceId && SubSysId == other.SubSysId
+            && Revision == other.Revision && DriverVersion == other.DriverVersion;
+    }
+};
+
+// What bring-up found out about each adapter on earlier runs: whether a D3D12 device can be
+// created on it and the highest feature level it has, as a D3D_FEATURE_LEVEL value. Lets the
+// next run pick its adapter without creating devices on the ones that failed, and create the
+// device straight at its highest feature level without querying it again. Only definite failures
+// are kept, and adapters skipped for one are still tried when no other adapter works.
+class AdapterCache
+{
+public:
+    struct Entry
+    {
+        AdapterKey Key;
+        uint32_t MaxFeatureLevel; // 0 when device creation said the adapter has no D3D12 (DXGI_ERROR_UNSUPPORTED)
+    };
+
+    // Null when the adapter hasn't been seen
+    const Entry* Find(const AdapterKey& key) const;
+    void Set(const AdapterKey& key, const uint32_t maxFeatureLevel);
+    void Remove(const AdapterKey& key);
+
+    bool IsDirty() const { return m_dirty; }
+
+    // A missing or unreadable file is an empty cache
+    bool Load(const std::filesystem::path& path);
+    bool Save(const std::filesystem::path& path);
+
+private:
+    std::vector<Entry> m_entries; // Most recently set last
+    bool m_dirty = false;
+};
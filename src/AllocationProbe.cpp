@@ -0,0 +1,205 @@
+#include "AllocationProbe.h"
+#include "FormatInfo.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    struct UsageName
+    {
+        uint32_t Usage;
+        const char* Name;
+    };
+
+    constexpr UsageName s_usageNames[] =
+    {
+        { AllocationUsage_RenderTarget, "RT" },
+        { AllocationUsage_DepthStencil, "DS" },
+        { AllocationUsage_UnorderedAccess, "UAV" },
+        { AllocationUsage_SmallAlignment, "Small" },
+    };
+
+    // Every field of a desc D3D12 can create fits in 60 bits: 8 format, 2 dimension, 4 usage,
+    // 15 + 15 width/height (max 16384), 12 depth or array size (max 2048), 4 mip levels (max 15)
+    bool PackAllocationProbeKey(const AllocationProbeDesc& probe, uint64_t& outKey)
+    {
+        const TextureDesc& desc = probe.Desc;
+        if (static_cast<uint32_t>(desc.Format) >= (1u << 8) || probe.Usage >= (1u << 4) || desc.Width >= (1u << 15) || desc.Height >= (1u << 15)
+            || desc.DepthOrArraySize >= (1u << 12) || desc.MipLevels >= (1u << 4) || desc.SampleCount != 1u)
+            return false;
+
+        outKey = static_cast<uint64_t>(desc.Format)
+            | static_cast<uint64_t>(desc.Dimension) << 8
+            | static_cast<uint64_t>(probe.Usage) << 10
+            | static_cast<uint64_t>(desc.Width) << 14
+            | static_cast<uint64_t>(desc.Height) << 29
+            | static_cast<uint64_t>(desc.DepthOrArraySize) << 44
+            | static_cast<uint64_t>(desc.MipLevels) << 56;
+        return true;
+    }
+
+    bool IsColumnSupported(const std::vector<FormatSupport>& supportFlags, const uint32_t usageBit)
+    {
+        for (size_t column = 0u; column < supportFlags.size(); ++column)
+        {
+            if ((1u << column) == usageBit)
+                return supportFlags[column] == FormatSupport::PASS;
+        }
+        return false;
+    }
+}
+
+ReplayAllocationProvider::ReplayAllocationProvider(const std::vector<AllocationRecord>& records)
+{
+    m_recorded.reserve(records.size());
+    for (const AllocationRecord& record : records)
+    {
+        uint64_t key = 0u;
+        if (record.Info.SizeInBytes != UINT64_MAX && PackAllocationProbeKey(record.Probe, key))
+            m_recorded[key] = record.Info;
+    }
+}
+
+bool ReplayAllocationProvider::QueryAllocationInfo(const AllocationProbeDesc* descs, const size_t count, AllocationInfo* outInfos)
+{
+    for (size_t i = 0u; i < count; ++i)
+    {
+        uint64_t key = 0u;
+        if (!PackAllocationProbeKey(descs[i], key))
+            return false;
+
+        const auto found = m_recorded.find(key);
+        if (found == m_recorded.end())
+            return false;
+
+        outInfos[i] = found->second;
+    }
+    return true;
+}
+
+void AppendAllocationProbeDescs(const SupportTable& table, std::vector<AllocationProbeDesc>& outDescs)
+{
+    std::vector<DXGI_FORMAT> formats;
+    formats.reserve(table.size());
+    for (const auto& [format, supportFlags] : table)
+    {
+        if (IsColumnSupported(supportFlags, FormatUsage_Texture2D) && GetFormatInfo(format).Channels != 0u)
+            formats.push_back(format);
+    }
+    std::sort(formats.begin(), formats.end());
+
+    // Streaming budgets care about the sizes textures actually ship at, the small one shows where 4 KB placement kicks in
+    constexpr uint32_t sizes[] = { 64u, 256u, 1024u, 4096u };
+    for (const DXGI_FORMAT format : formats)
+    {
+        const std::vector<FormatSupport>& supportFlags = table.at(format);
+        const FormatInfo& info = GetFormatInfo(format);
+
+        std::vector<uint32_t> usages{ AllocationUsage_None, AllocationUsage_SmallAlignment };
+        if (IsColumnSupported(supportFlags, FormatUsage_RenderTarget))
+            usages.push_back(AllocationUsage_RenderTarget);
+        if (IsColumnSupported(supportFlags, FormatUsage_DepthStencil))
+            usages.push_back(AllocationUsage_DepthStencil);
+
+        // Typed UAV support isn't in the table, leave out the formats that can never be written by a shader
+        constexpr uint8_t noUAVFlags = FormatInfoFlags_Depth | FormatInfoFlags_BlockCompressed | FormatInfoFlags_Video | FormatInfoFlags_Palette;
+        if (!(info.Flags & noUAVFlags) && info.Numeric != FormatNumeric::SRGB && info.PlaneCount == 1u)
+            usages.push_back(AllocationUsage_UnorderedAccess);
+
+        for (const uint32_t size : sizes)
+        {
+            TextureDesc desc{ format, TextureDimension::Texture2D, size, size, 1u, 1u, 1u };
+            const uint32_t fullMipCount = CalculateFullMipCount(desc);
+            for (const uint32_t mipLevels : { 1u, fullMipCount })
+            {
+                // Shapes D3D12 rejects anyway, e.g. odd sizes of subsampled formats, would only split batches
+                desc.MipLevels = mipLevels;
+                TextureFootprint footprint{};
+                if (!CalculateTextureFootprint(desc, footprint))
+                    continue;
+
+                for (const uint32_t usage : usages)
+                    outDescs.push_back(AllocationProbeDesc{ desc, usage });
+            }
+        }
+    }
+}
+
+AllocationProbeStats RunAllocationProbe(AllocationInfoProvider& provider, const std::vector<AllocationProbeDesc>& descs,
+    std::vector<AllocationRecord>& outRecords, const size_t batchSize, const std::atomic<bool>* cancel)
+{
+    AllocationProbeStats stats{ descs.size(), 0u, 0u };
+    outRecords.resize(descs.size());
+
+    std::vector<AllocationInfo> infos(std::min(descs.size(), std::max<size_t>(batchSize, 1u)));
+    std::vector<std::pair<size_t, size_t>> pending; // [first, count) ranges still to query
+    for (size_t first = 0u; first < descs.size(); first += infos.size())
+        pending.emplace_back(first, std::min(infos.size(), descs.size() - first));
+    std::reverse(pending.begin(), pending.end());
+
+    while (!pending.empty())
+    {
+        if (cancel && cancel->load(std::memory_order_relaxed))
+            break;
+
+        const auto [first, count] = pending.back();
+        pending.pop_back();
+
+        stats.Calls++;
+        if (provider.QueryAllocationInfo(&descs[first], count, infos.data()))
+        {
+            for (size_t i = 0u; i < count; ++i)
+                outRecords[first + i] = AllocationRecord{ descs[first + i], infos[i] };
+        }
+        else if (count == 1u)
+        {
+            outRecords[first] = AllocationRecord{ descs[first], { UINT64_MAX, 0u } };
+            stats.Rejected++;
+        }
+        else
+        {
+            // Second half pushed first so records still come back in desc order
+            const size_t half = count / 2u;
+            pending.emplace_back(first + half, count - half);
+            pending.emplace_back(first, half);
+        }
+    }
+
+    return stats;
+}
+
+std::string AllocationUsageToString(const uint32_t usage)
+{
+    std::string names;
+    for (const UsageName& usageName : s_usageNames)
+    {
+        if (!(usage & usageName.Usage))
+            continue;
+
+        if (!names.empty())
+            names += '|';
+        names += usageName.Name;
+    }
+    return names.empty() ? "None" : names;
+}
+
+uint32_t AllocationUsageFromString(const std::string& usage)
+{
+    uint32_t flags = AllocationUsage_None;
+    size_t start = 0u;
+    while (start < usage.size())
+    {
+        size_t end = usage.find('|', start);
+        if (end == std::string::npos)
+            end = usage.size();
+
+        for (const UsageName& usageName : s_usageNames)
+        {
+            if (usage.compare(start, end - start, usageName.Name) == 0)
+                flags |= usageName.Usage;
+        }
+        start = end + 1u;
+    }
+    return flags;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SupportTable.h"
+#include "TextureFootprint.h"
+
+// Descs per GetResourceAllocationInfo1 call
+#define ALLOCATION_PROBE_BATCH_SIZE (512u)
+
+// Resource flags a probe desc is created with
+enum AllocationUsageFlags : uint32_t
+{
+    AllocationUsage_None            = 0,
+    AllocationUsage_RenderTarget    = 1 << 0,
+    AllocationUsage_DepthStencil    = 1 << 1,
+    AllocationUsage_UnorderedAccess = 1 << 2,
+    AllocationUsage_SmallAlignment  = 1 << 3, // Ask for 4 KB placement, drivers answer 64 KB where the texture isn't eligible
+};
+
+struct AllocationProbeDesc
+{
+    TextureDesc Desc;
+    uint32_t Usage;
+};
+
+struct AllocationInfo
+{
+    uint64_t SizeInBytes;
+    uint64_t Alignment;
+};
+
+// What the driver said one desc needs in a heap. SizeInBytes is UINT64_MAX where it rejected the desc.
+struct AllocationRecord
+{
+    AllocationProbeDesc Probe;
+    AllocationInfo Info;
+};
+
+struct AllocationProbeStats
+{
+    size_t Descs;
+    size_t Calls;    // Provider calls, batches plus the retries that isolated rejected descs
+    size_t Rejected;
+};
+
+// Answers a whole batch of descs at once, like ID3D12Device4::GetResourceAllocationInfo1.
+// D3D12App has the device version, ReplayAllocationProvider answers from an exported recording.
+class AllocationInfoProvider
+{
+public:
+    virtual ~AllocationInfoProvider() = default;
+
+    // Fills one info per desc. False when any desc in the batch was rejected, the device doesn't say which.
+    virtual bool QueryAllocationInfo(const AllocationProbeDesc* descs, const size_t count, AllocationInfo* outInfos) = 0;
+};
+
+// Plays back an exported recording so the probe stage runs without a device, e.g. on Linux.
+// Descs that weren't recorded, or were rejected when recording, fail their batch as they would on the device.
+class ReplayAllocationProvider : public AllocationInfoProvider
+{
+public:
+    explicit ReplayAllocationProvider(const std::vector<AllocationRecord>& records);
+
+    bool QueryAllocationInfo(const AllocationProbeDesc* descs, const size_t count, AllocationInfo* outInfos) override;
+
+private:
+    std::unordered_map<uint64_t, AllocationInfo> m_recorded; // Keyed by PackAllocationProbeKey()
+};
+
+// Every Texture2D-capable format in the table x a few representative sizes, with and without mips,
+// x each of the flags it supports. Formats are sorted so exports diff cleanly between runs.
+void AppendAllocationProbeDescs(const SupportTable& table, std::vector<AllocationProbeDesc>& outDescs);
+
+// Issues descs in batches of batchSize. A rejected batch is split in half until the rejected
+// descs are found, so a handful of bad descs cost a few extra calls rather than one call each.
+// Stops between calls once cancel is set, the records are incomplete then.
+AllocationProbeStats RunAllocationProbe(AllocationInfoProvider& provider, const std::vector<AllocationProbeDesc>& descs,
+    std::vector<AllocationRecord>& outRecords, const size_t batchSize = ALLOCATION_PROBE_BATCH_SIZE,
+    const std::atomic<bool>* cancel = nullptr);
+
+// "RT|DS|UAV|Small", "None" for no flags
+std::string AllocationUsageToString(const uint32_t usage);
+uint32_t AllocationUsageFromString(const std::string& usage);
@@ -0,0 +1,595 @@
+#include "ArrowExport.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <fstream>
+
+#include "FleetAggregate.h"
+#include "Trace.h"
+#include "Utils.h"
+
+#define ARROW_EXPORT_ALIGNMENT (8u)
+#define ARROW_METADATA_VERSION_V5 (4)
+
+namespace
+{
+    // Just enough of a FlatBuffers builder for Arrow's metadata. Like the real one it writes back
+    // to front, so whatever an offset points at is already written, and positions count from
+    // the end of the buffer until it's finished.
+    class FlatBufferBuilder
+    {
+    public:
+        FlatBufferBuilder()
+            : m_buffer(1024u), m_head(m_buffer.size()), m_minAlignment(4u), m_tableStart(0u) {}
+
+        uint32_t GetSize() const { return static_cast<uint32_t>(m_buffer.size() - m_head); }
+
+        template <typename T>
+        void Prepend(const T value)
+        {
+            Align(sizeof(T), sizeof(T));
+            PrependBytes(&value, sizeof(T));
+        }
+
+        // uoffset from where it's written to target
+        void PrependOffset(const uint32_t target)
+        {
+            Align(sizeof(uint32_t), sizeof(uint32_t));
+            Prepend<uint32_t>(GetSize() + sizeof(uint32_t) - target);
+        }
+
+        uint32_t CreateString(const std::string& str)
+        {
+            Align(str.size() + 1u, sizeof(uint32_t));
+            const char terminator = '\0';
+            PrependBytes(&terminator, 1u);
+            PrependBytes(str.data(), str.size());
+            Prepend<uint32_t>(static_cast<uint32_t>(str.size()));
+            return GetSize();
+        }
+
+        template <typename T>
+        uint32_t CreateStructVector(const std::vector<T>& items)
+        {
+            Align(items.size() * sizeof(T), std::max<size_t>(alignof(T), sizeof(uint32_t)));
+            for (size_t i = items.size(); i-- > 0u;)
+                PrependBytes(&items[i], sizeof(T));
+            Prepend<uint32_t>(static_cast<uint32_t>(items.size()));
+            return GetSize();
+        }
+
+        uint32_t CreateOffsetVector(const std::vector<uint32_t>& targets)
+        {
+            Align(targets.size() * sizeof(uint32_t), sizeof(uint32_t));
+            for (size_t i = targets.size(); i-- > 0u;)
+                PrependOffset(targets[i]);
+            Prepend<uint32_t>(static_cast<uint32_t>(targets.size()));
+            return GetSize();
+        }
+
+        // Children have to be created before their table is started
+        void StartTable()
+        {
+            m_fields.clear();
+            m_tableStart = GetSize();
+        }
+
+        template <typename T>
+        void AddScalar(const uint16_t slot, const T value)
+        {
+            Prepend(value);
+            m_fields.push_back({ slot, GetSize() });
+        }
+
+        void AddOffset(const uint16_t slot, const uint32_t target)
+        {
+            PrependOffset(target);
+            m_fields.push_back({ slot, GetSize() });
+        }
+
+        // The vtable goes right before the table, which points back at it with a signed offset
+        uint32_t EndTable()
+        {
+            Prepend<int32_t>(0);
+            const uint32_t table = GetSize();
+
+            uint16_t slotCount = 0u;
+            for (const Field& field : m_fields)
+                slotCount = std::max(slotCount, static_cast<uint16_t>(field.Slot + 1u));
+            std::vector<uint16_t> vtable(2u + slotCount, 0u);
+            vtable[0] = static_cast<uint16_t>(vtable.size() * sizeof(uint16_t));
+            vtable[1] = static_cast<uint16_t>(table - m_tableStart);
+            for (const Field& field : m_fields)
+                vtable[2u + field.Slot] = static_cast<uint16_t>(table - field.Position);
+
+            for (size_t i = vtable.size(); i-- > 0u;)
+                Prepend<uint16_t>(vtable[i]);
+            const int32_t vtableOffset = static_cast<int32_t>(GetSize() - table);
+            std::memcpy(&m_buffer[m_buffer.size() - table], &vtableOffset, sizeof(vtableOffset));
+            return table;
+        }
+
+        std::vector<uint8_t> Finish(const uint32_t root)
+        {
+            Align(sizeof(uint32_t), m_minAlignment);
+            PrependOffset(root);
+            return std::vector<uint8_t>(m_buffer.begin() + m_head, m_buffer.end());
+        }
+
+    private:
+        struct Field
+        {
+            uint16_t Slot;
+            uint32_t Position;
+        };
+
+        // Pads so the position after prepending size more bytes is a multiple of alignment
+        void Align(const size_t size, const size_t alignment)
+        {
+            m_minAlignment = std::max(m_minAlignment, alignment);
+            const size_t padding = (alignment - (GetSize() + size) % alignment) % alignment;
+            Reserve(padding);
+            m_head -= padding;
+            std::memset(&m_buffer[m_head], 0, padding);
+        }
+
+        void PrependBytes(const void* data, const size_t size)
+        {
+            Reserve(size);
+            m_head -= size;
+            std::memcpy(&m_buffer[m_head], data, size);
+        }
+
+        void Reserve(const size_t size)
+        {
+            if (m_head >= size)
+                return;
+
+            const size_t used = GetSize();
+            std::vector<uint8_t> grown(std::max(m_buffer.size() * 2u, used + size));
+            std::memcpy(grown.data() + grown.size() - used, m_buffer.data() + m_head, used);
+            m_head = grown.size() - used;
+            m_buffer.swap(grown);
+        }
+
+        std::vector<uint8_t> m_buffer;
+        size_t m_head; // Start of the written bytes, they run to the end of m_buffer
+        size_t m_minAlignment;
+        uint32_t m_tableStart;
+        std::vector<Field> m_fields;
+    };
+
+    // Structs of Message.fbs and File.fbs, laid out the way FlatBuffers lays them out
+    struct FieldNode
+    {
+        int64_t Length;
+        int64_t NullCount;
+    };
+
+    struct BufferRegion
+    {
+        int64_t Offset;
+        int64_t Length;
+    };
+
+    struct Block
+    {
+        int64_t Offset;
+        int32_t MetadataLength;
+        int32_t Padding;
+        int64_t BodyLength;
+    };
+
+    // Union tags of Schema.fbs and Message.fbs
+    enum ArrowTypeTag : uint8_t
+    {
+        ArrowTypeTag_Int = 2,
+        ArrowTypeTag_Utf8 = 5,
+        ArrowTypeTag_Bool = 6,
+    };
+
+    enum ArrowMessageTag : uint8_t
+    {
+        ArrowMessageTag_Schema = 1,
+        ArrowMessageTag_DictionaryBatch = 2,
+        ArrowMessageTag_RecordBatch = 3,
+    };
+
+    size_t AlignUp(const size_t size)
+    {
+        return (size + ARROW_EXPORT_ALIGNMENT - 1u) & ~static_cast<size_t>(ARROW_EXPORT_ALIGNMENT - 1u);
+    }
+
+    void SetBit(std::vector<uint8_t>& bits, const size_t index, const bool value)
+    {
+        if (index / 8u >= bits.size())
+            bits.push_back(0u);
+        bits[index / 8u] |= static_cast<uint8_t>(static_cast<uint32_t>(value) << (index % 8u));
+    }
+
+    size_t CountSetBits(const uint8_t* bits, const size_t byteCount)
+    {
+        size_t count = 0u;
+        for (size_t i = 0u; i < byteCount; ++i)
+            count += std::bitset<8>(bits[i]).count();
+        return count;
+    }
+
+    uint32_t CreateIntType(FlatBufferBuilder& builder, const int32_t bitWidth, const bool isSigned)
+    {
+        builder.StartTable();
+        builder.AddScalar<int32_t>(0u, bitWidth);
+        builder.AddScalar<uint8_t>(1u, isSigned ? 1u : 0u);
+        return builder.EndTable();
+    }
+
+    uint32_t CreateEmptyTable(FlatBufferBuilder& builder)
+    {
+        builder.StartTable();
+        return builder.EndTable();
+    }
+
+    // Dictionary ids are column indices
+    uint32_t CreateSchema(FlatBufferBuilder& builder, const std::vector<std::string>& names, const std::vector<ArrowType>& types)
+    {
+        std::vector<uint32_t> fields;
+        for (size_t column = 0u; column < names.size(); ++column)
+        {
+            const uint32_t name = builder.CreateString(names[column]);
+            const uint32_t children = builder.CreateOffsetVector({});
+
+            uint8_t typeTag = ArrowTypeTag_Bool;
+            uint32_t type = 0u;
+            uint32_t dictionary = 0u;
+            switch (types[column])
+            {
+            case ArrowType::Bool:
+                type = CreateEmptyTable(builder);
+                break;
+            case ArrowType::UInt32:
+                typeTag = ArrowTypeTag_Int;
+                type = CreateIntType(builder, 32, false);
+                break;
+            case ArrowType::String:
+            {
+                typeTag = ArrowTypeTag_Utf8;
+                type = CreateEmptyTable(builder);
+                const uint32_t indexType = CreateIntType(builder, 32, true);
+                builder.StartTable();
+                builder.AddScalar<int64_t>(0u, static_cast<int64_t>(column));
+                builder.AddOffset(1u, indexType);
+                builder.AddScalar<uint8_t>(2u, 0u);
+                dictionary = builder.EndTable();
+                break;
+            }
+            }
+
+            builder.StartTable();
+            builder.AddOffset(0u, name);
+            builder.AddScalar<uint8_t>(1u, 1u); // Nullable
+            builder.AddScalar<uint8_t>(2u, typeTag);
+            builder.AddOffset(3u, type);
+            if (dictionary)
+                builder.AddOffset(4u, dictionary);
+            builder.AddOffset(5u, children);
+            fields.push_back(builder.EndTable());
+        }
+
+        const uint32_t fieldVector = builder.CreateOffsetVector(fields);
+        builder.StartTable();
+        builder.AddScalar<int16_t>(0u, 0); // Little endian
+        builder.AddOffset(1u, fieldVector);
+        return builder.EndTable();
+    }
+
+    uint32_t CreateRecordBatch(FlatBufferBuilder& builder, const int64_t length, const std::vector<FieldNode>& nodes, const std::vector<BufferRegion>& buffers)
+    {
+        const uint32_t nodeVector = builder.CreateStructVector(nodes);
+        const uint32_t bufferVector = builder.CreateStructVector(buffers);
+        builder.StartTable();
+        builder.AddScalar<int64_t>(0u, length);
+        builder.AddOffset(1u, nodeVector);
+        builder.AddOffset(2u, bufferVector);
+        return builder.EndTable();
+    }
+
+    std::vector<uint8_t> FinishMessage(FlatBufferBuilder& builder, const uint8_t headerTag, const uint32_t header, const size_t bodyLength)
+    {
+        builder.StartTable();
+        builder.AddScalar<int16_t>(0u, ARROW_METADATA_VERSION_V5);
+        builder.AddScalar<uint8_t>(1u, headerTag);
+        builder.AddOffset(2u, header);
+        builder.AddScalar<int64_t>(3u, static_cast<int64_t>(bodyLength));
+        return builder.Finish(builder.EndTable());
+    }
+
+    // A message body, buffers padded to 8 bytes, and where each one went
+    class MessageBody
+    {
+    public:
+        void AddBuffer(const void* data, const size_t size)
+        {
+            m_buffers.push_back({ static_cast<int64_t>(m_bytes.size()), static_cast<int64_t>(size) });
+            m_bytes.insert(m_bytes.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+            m_bytes.resize(AlignUp(m_bytes.size()), 0u);
+        }
+
+        void AddNode(const size_t length, const size_t nullCount)
+        {
+            m_nodes.push_back({ static_cast<int64_t>(length), static_cast<int64_t>(nullCount) });
+        }
+
+        const std::vector<uint8_t>& GetBytes() const { return m_bytes; }
+        const std::vector<FieldNode>& GetNodes() const { return m_nodes; }
+        const std::vector<BufferRegion>& GetBuffers() const { return m_buffers; }
+
+    private:
+        std::vector<uint8_t> m_bytes;
+        std::vector<FieldNode> m_nodes;
+        std::vector<BufferRegion> m_buffers;
+    };
+
+    // Encapsulated message: continuation marker, metadata length, the metadata padded to 8 bytes, then the body
+    Block AppendMessage(std::vector<uint8_t>& file, const std::vector<uint8_t>& metadata, const std::vector<uint8_t>& body)
+    {
+        const size_t offset = file.size();
+        const uint32_t continuation = 0xFFFFFFFFu;
+        const int32_t metadataLength = static_cast<int32_t>(AlignUp(sizeof(continuation) + sizeof(int32_t) + metadata.size())
+            - sizeof(continuation) - sizeof(int32_t));
+        file.insert(file.end(), reinterpret_cast<const uint8_t*>(&continuation), reinterpret_cast<const uint8_t*>(&continuation) + sizeof(continuation));
+        file.insert(file.end(), reinterpret_cast<const uint8_t*>(&metadataLength), reinterpret_cast<const uint8_t*>(&metadataLength) + sizeof(metadataLength));
+        file.insert(file.end(), metadata.begin(), metadata.end());
+        file.resize(offset + sizeof(continuation) + sizeof(int32_t) + metadataLength, 0u);
+        file.insert(file.end(), body.begin(), body.end());
+        return Block{ static_cast<int64_t>(offset), static_cast<int32_t>(sizeof(continuation) + sizeof(int32_t) + metadataLength), 0,
+            static_cast<int64_t>(body.size()) };
+    }
+}
+
+size_t ArrowTableWriter::GetColumn(const std::string& name, const ArrowType type)
+{
+    for (size_t column = 0u; column < m_columns.size(); ++column)
+    {
+        if (m_columns[column].Name == name)
+            return column;
+    }
+
+    m_columns.push_back(Column{ name, type, 0u, {}, {}, {}, {} });
+    for (size_t row = 0u; row < m_rowCount; ++row)
+        AppendNull(m_columns.back());
+    return m_columns.size() - 1u;
+}
+
+ArrowTableWriter::Column* ArrowTableWriter::BeginValue(const size_t column)
+{
+    Column& target = m_columns[column];
+    if (target.Length > m_rowCount)
+        return nullptr;
+
+    SetBit(target.Validity, target.Length, true);
+    return &target;
+}
+
+void ArrowTableWriter::AppendBool(const size_t column, const bool value)
+{
+    if (Column* target = BeginValue(column))
+        SetBit(target->Values, target->Length++, value);
+}
+
+void ArrowTableWriter::AppendUInt32(const size_t column, const uint32_t value)
+{
+    if (Column* target = BeginValue(column))
+    {
+        target->Values.insert(target->Values.end(), reinterpret_cast<const uint8_t*>(&value), reinterpret_cast<const uint8_t*>(&value) + sizeof(value));
+        target->Length++;
+    }
+}
+
+void ArrowTableWriter::AppendString(const size_t column, const std::string& value)
+{
+    if (Column* target = BeginValue(column))
+    {
+        const auto found = target->DictionaryLookup.emplace(value, static_cast<int32_t>(target->Dictionary.size()));
+        if (found.second)
+            target->Dictionary.push_back(value);
+
+        const int32_t index = found.first->second;
+        target->Values.insert(target->Values.end(), reinterpret_cast<const uint8_t*>(&index), reinterpret_cast<const uint8_t*>(&index) + sizeof(index));
+        target->Length++;
+    }
+}
+
+void ArrowTableWriter::FinishRow()
+{
+    m_rowCount++;
+    for (Column& column : m_columns)
+    {
+        if (column.Length < m_rowCount)
+            AppendNull(column);
+    }
+}
+
+void ArrowTableWriter::AppendNull(Column& column)
+{
+    SetBit(column.Validity, column.Length, false);
+    if (column.Type == ArrowType::Bool)
+        SetBit(column.Values, column.Length, false);
+    else
+        column.Values.resize(column.Values.size() + sizeof(uint32_t), 0u);
+    column.Length++;
+}
+
+bool ArrowTableWriter::Write(const std::filesystem::path& path) const
+{
+    TRACE_ZONE("ArrowTableWriter::Write");
+    std::vector<std::string> names;
+    std::vector<ArrowType> types;
+    for (const Column& column : m_columns)
+    {
+        names.push_back(column.Name);
+        types.push_back(column.Type);
+    }
+
+    // Magic padded to 8 bytes, then the same messages as the streaming format
+    static constexpr char magic[] = "ARROW1";
+    std::vector<uint8_t> file(magic, magic + 6);
+    file.resize(8u, 0u);
+    {
+        FlatBufferBuilder builder;
+        AppendMessage(file, FinishMessage(builder, ArrowMessageTag_Schema, CreateSchema(builder, names, types), 0u), {});
+    }
+
+    // Every dictionary up front, the file format can't replace them between batches
+    std::vector<Block> dictionaryBlocks;
+    for (size_t column = 0u; column < m_columns.size(); ++column)
+    {
+        if (m_columns[column].Type != ArrowType::String)
+            continue;
+
+        std::vector<int32_t> offsets(1u, 0);
+        std::string characters;
+        for (const std::string& value : m_columns[column].Dictionary)
+        {
+            characters += value;
+            offsets.push_back(static_cast<int32_t>(characters.size()));
+        }
+
+        MessageBody body;
+        body.AddNode(m_columns[column].Dictionary.size(), 0u);
+        body.AddBuffer(nullptr, 0u);
+        body.AddBuffer(offsets.data(), offsets.size() * sizeof(int32_t));
+        body.AddBuffer(characters.data(), characters.size());
+
+        FlatBufferBuilder builder;
+        const uint32_t data = CreateRecordBatch(builder, static_cast<int64_t>(m_columns[column].Dictionary.size()), body.GetNodes(), body.GetBuffers());
+        builder.StartTable();
+        builder.AddScalar<int64_t>(0u, static_cast<int64_t>(column));
+        builder.AddOffset(1u, data);
+        const uint32_t dictionaryBatch = builder.EndTable();
+        dictionaryBlocks.push_back(AppendMessage(file, FinishMessage(builder, ArrowMessageTag_DictionaryBatch, dictionaryBatch, body.GetBytes().size()), body.GetBytes()));
+    }
+
+    // Batches slice every column's buffers, bitmaps on byte boundaries
+    std::vector<Block> batchBlocks;
+    for (size_t firstRow = 0u; firstRow < m_rowCount; firstRow += ARROW_EXPORT_BATCH_ROWS)
+    {
+        const size_t rows = std::min<size_t>(ARROW_EXPORT_BATCH_ROWS, m_rowCount - firstRow);
+        const size_t bitmapBytes = (rows + 7u) / 8u;
+        MessageBody body;
+        for (const Column& column : m_columns)
+        {
+            const uint8_t* validity = column.Validity.data() + firstRow / 8u;
+            const size_t nullCount = rows - CountSetBits(validity, bitmapBytes);
+            body.AddNode(rows, nullCount);
+            body.AddBuffer(validity, nullCount ? bitmapBytes : 0u);
+            if (column.Type == ArrowType::Bool)
+                body.AddBuffer(column.Values.data() + firstRow / 8u, bitmapBytes);
+            else
+                body.AddBuffer(column.Values.data() + firstRow * sizeof(uint32_t), rows * sizeof(uint32_t));
+        }
+
+        FlatBufferBuilder builder;
+        const uint32_t recordBatch = CreateRecordBatch(builder, static_cast<int64_t>(rows), body.GetNodes(), body.GetBuffers());
+        batchBlocks.push_back(AppendMessage(file, FinishMessage(builder, ArrowMessageTag_RecordBatch, recordBatch, body.GetBytes().size()), body.GetBytes()));
+    }
+
+    // End-of-stream marker, then the footer indexing the messages so readers can seek straight to a batch
+    const uint32_t endOfStream[2] = { 0xFFFFFFFFu, 0u };
+    file.insert(file.end(), reinterpret_cast<const uint8_t*>(endOfStream), reinterpret_cast<const uint8_t*>(endOfStream) + sizeof(endOfStream));
+
+    FlatBufferBuilder builder;
+    const uint32_t schema = CreateSchema(builder, names, types);
+    const uint32_t dictionaries = builder.CreateStructVector(dictionaryBlocks);
+    const uint32_t recordBatches = builder.CreateStructVector(batchBlocks);
+    builder.StartTable();
+    builder.AddScalar<int16_t>(0u, ARROW_METADATA_VERSION_V5);
+    builder.AddOffset(1u, schema);
+    builder.AddOffset(2u, dictionaries);
+    builder.AddOffset(3u, recordBatches);
+    const std::vector<uint8_t> footer = builder.Finish(builder.EndTable());
+    const int32_t footerLength = static_cast<int32_t>(footer.size());
+    file.insert(file.end(), footer.begin(), footer.end());
+    file.insert(file.end(), reinterpret_cast<const uint8_t*>(&footerLength), reinterpret_cast<const uint8_t*>(&footerLength) + sizeof(footerLength));
+    file.insert(file.end(), magic, magic + 6);
+
+    std::ofstream outFile(path, std::ios::binary | std::ios::trunc | std::ios::out);
+    if (!outFile.is_open() || !outFile.good())
+        return false;
+
+    outFile.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return outFile.good();
+}
+
+void AppendSupportReportRows(ArrowTableWriter& table, const SupportReport& report, const uint32_t weight)
+{
+    const size_t adapterColumn = table.GetColumn("adapter", ArrowType::String);
+    const size_t vendorColumn = table.GetColumn("vendor_id", ArrowType::UInt32);
+    const size_t deviceColumn = table.GetColumn("device_id", ArrowType::UInt32);
+    const size_t driverColumn = table.GetColumn("driver", ArrowType::String);
+    const size_t countColumn = table.GetColumn("count", ArrowType::UInt32);
+    const size_t formatColumn = table.GetColumn("format", ArrowType::String);
+    std::vector<size_t> capabilityColumns;
+    for (const std::string& capability : report.Capabilities)
+        capabilityColumns.push_back(table.GetColumn(capability, ArrowType::Bool));
+
+    std::vector<DXGI_FORMAT> formats;
+    for (const auto& [format, supportFlags] : report.Table)
+        formats.push_back(format);
+    std::sort(formats.begin(), formats.end());
+
+    const std::string driver = DriverVersionToString(report.Adapter.DriverVersion);
+    for (const DXGI_FORMAT format : formats)
+    {
+        table.AppendString(adapterColumn, report.Adapter.Name);
+        table.AppendUInt32(vendorColumn, report.Adapter.VendorId);
+        table.AppendUInt32(deviceColumn, report.Adapter.DeviceId);
+        table.AppendString(driverColumn, driver);
+        table.AppendUInt32(countColumn, weight);
+        table.AppendString(formatColumn, D3DFormatToString(format));
+
+        const std::vector<FormatSupport>& supportFlags = report.Table.at(format);
+        for (size_t column = 0u; column < capabilityColumns.size() && column < supportFlags.size(); ++column)
+        {
+            if (supportFlags[column] != FormatSupport::UNKN)
+                table.AppendBool(capabilityColumns[column], supportFlags[column] == FormatSupport::PASS);
+        }
+        table.FinishRow();
+    }
+}
+
+void AppendFleetAggregateRows(ArrowTableWriter& table, const FleetAggregate& fleet)
+{
+    const size_t vendorIdColumn = table.GetColumn("vendor_id", ArrowType::UInt32);
+    const size_t vendorColumn = table.GetColumn("vendor", ArrowType::String);
+    const size_t reportsColumn = table.GetColumn("reports", ArrowType::UInt32);
+    const size_t formatColumn = table.GetColumn("format", ArrowType::String);
+    std::vector<size_t> passColumns;
+    std::vector<size_t> knownColumns;
+    for (const std::string& capability : fleet.GetCapabilities())
+    {
+        passColumns.push_back(table.GetColumn(capability + " pass", ArrowType::UInt32));
+        knownColumns.push_back(table.GetColumn(capability + " known", ArrowType::UInt32));
+    }
+
+    // The whole fleet as vendor 0, then each vendor
+    for (size_t scope = 0u; scope <= fleet.GetVendorCount(); ++scope)
+    {
+        const bool whole = scope == 0u;
+        const size_t vendor = scope - 1u;
+        for (size_t row = 0u; row < fleet.GetFormats().size(); ++row)
+        {
+            table.AppendUInt32(vendorIdColumn, whole ? 0u : fleet.GetVendorId(vendor));
+            table.AppendString(vendorColumn, whole ? "Fleet" : VendorIdToString(fleet.GetVendorId(vendor)));
+            table.AppendUInt32(reportsColumn, whole ? static_cast<uint32_t>(fleet.GetReportCount()) : fleet.GetVendorReportCount(vendor));
+            table.AppendString(formatColumn, D3DFormatToString(fleet.GetFormats()[row]));
+            for (size_t capability = 0u; capability < passColumns.size(); ++capability)
+            {
+                const FleetAggregate::Cell& cell = whole ? fleet.GetCell(row, capability) : fleet.GetVendorCell(vendor, row, capability);
+                table.AppendUInt32(passColumns[capability], cell.Pass);
+                table.AppendUInt32(knownColumns[capability], cell.Known);
+            }
+            table.FinishRow();
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SupportTable.h"
+
+class FleetAggregate;
+
+#define ARROW_EXPORT_BATCH_ROWS (65536u) // Rows per record batch, a multiple of 8 so bitmaps split on byte boundaries
+
+enum class ArrowType
+{
+    Bool,
+    UInt32,
+    String, // Dictionary-encoded, int32 indices into the distinct values in first-seen order
+};
+
+// Columns built up row by row and written as an Apache Arrow IPC file, the format pandas,
+// Polars and DuckDB memory map without converting anything. Every column is nullable:
+// values not appended before FinishRow() are null, as are rows before a column was added.
+// Booleans are bitmaps, strings are dictionary-encoded so repeated names are stored once.
+class ArrowTableWriter
+{
+public:
+    // The column with this name, added when there isn't one
+    size_t GetColumn(const std::string& name, const ArrowType type);
+
+    // The first value appended to a column per row wins
+    void AppendBool(const size_t column, const bool value);
+    void AppendUInt32(const size_t column, const uint32_t value);
+    void AppendString(const size_t column, const std::string& value);
+    void FinishRow();
+
+    size_t GetRowCount() const { return m_rowCount; }
+
+    bool Write(const std::filesystem::path& path) const;
+
+private:
+    struct Column
+    {
+        std::string Name;
+        ArrowType Type;
+        size_t Length;
+        std::vector<uint8_t> Validity; // Bit per row
+        std::vector<uint8_t> Values;   // Bit per row for Bool, else 4 bytes per row
+        std::vector<std::string> Dictionary;
+        std::unordered_map<std::string, int32_t> DictionaryLookup;
+    };
+
+    Column* BeginValue(const size_t column); // Null when the row already has a value
+    static void AppendNull(Column& column);
+
+    std::vector<Column> m_columns;
+    size_t m_rowCount = 0u;
+};
+
+// One row per format of the report: adapter, vendor_id, device_id, driver, count (the weight,
+// how many machines sent this report), format, then a bool per capability, null for UNKN and
+// for capabilities the report doesn't have
+void AppendSupportReportRows(ArrowTableWriter& table, const SupportReport& report, const uint32_t weight = 1u);
+
+// One row per format for the whole fleet, vendor_id 0, then the same per vendor: vendor_id,
+// vendor, reports, format, then "<capability> pass" and "<capability> known" counts
+void AppendFleetAggregateRows(ArrowTableWriter& table, const FleetAggregate& fleet);
@@ -0,0 +1,143 @@
+#include "CapabilityHeader.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <sstream>
+#include <unordered_set>
+
+namespace
+{
+    constexpr size_t s_maxCapabilities = 64u;
+
+    // Names the generated header declares itself
+    const char* const s_reservedNames[] = { "Capability", "FormatCaps", "FormatCount", "GetCaps", "Supports" };
+
+    std::string ToSingleLine(std::string text)
+    {
+        std::replace(text.begin(), text.end(), '\r', ' ');
+        std::replace(text.begin(), text.end(), '\n', ' ');
+        return text;
+    }
+}
+
+std::string CapabilityToIdentifier(const std::string& capability)
+{
+    std::string identifier;
+    bool upperNext = true;
+    for (const char c : capability)
+    {
+        if (!std::isalnum(static_cast<unsigned char>(c)))
+        {
+            upperNext = true;
+            continue;
+        }
+
+        identifier += upperNext ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : c;
+        upperNext = false;
+    }
+
+    if (identifier.empty() || std::isdigit(static_cast<unsigned char>(identifier[0])))
+        identifier.insert(0, "Cap");
+    return identifier;
+}
+
+std::string GenerateCapabilityHeader(const SupportReport& profile, const char* namespaceName)
+{
+    const size_t capabilityCount = std::min(profile.Capabilities.size(), s_maxCapabilities);
+    const bool wideMasks = capabilityCount > 32u;
+    const char* maskType = wideMasks ? "uint64_t" : "uint32_t";
+    const int hexDigits = wideMasks ? 16 : 8;
+
+    std::unordered_set<std::string> usedNames(std::begin(s_reservedNames), std::end(s_reservedNames));
+    std::vector<std::string> identifiers;
+    for (size_t capability = 0u; capability < capabilityCount; ++capability)
+    {
+        const std::string base = CapabilityToIdentifier(profile.Capabilities[capability]);
+        std::string identifier = base;
+        for (uint32_t suffix = 2u; !usedNames.insert(identifier).second; ++suffix)
+            identifier = base + std::to_string(suffix);
+        identifiers.push_back(identifier);
+    }
+
+    // Dense up to the last format in the report, anything past it reads as no support
+    DXGI_FORMAT lastFormat = DXGI_FORMAT_UNKNOWN;
+    for (const auto& [format, supportFlags] : profile.Table)
+        lastFormat = std::max(lastFormat, format);
+
+    std::stringstream ss;
+    ss << "// Generated by DXGI Format Support Exporter, do not edit.\n";
+    ss << "// Profile: " << ToSingleLine(profile.Adapter.Name) << '\n';
+    if (profile.Adapter.VendorId != 0u)
+    {
+        char adapterLine[128];
+        std::snprintf(adapterLine, sizeof(adapterLine), "// Vendor 0x%04X (%s), device 0x%04X, driver %s\n", profile.Adapter.VendorId,
+            VendorIdToString(profile.Adapter.VendorId), profile.Adapter.DeviceId, DriverVersionToString(profile.Adapter.DriverVersion).c_str());
+        ss << adapterLine;
+    }
+    ss << "#pragma once\n";
+    ss << "#include <cstdint>\n";
+    ss << "#include <dxgiformat.h>\n\n";
+    ss << "namespace " << namespaceName << "\n{\n";
+
+    ss << "    enum Capability : " << maskType << "\n    {\n";
+    for (size_t capability = 0u; capability < capabilityCount; ++capability)
+    {
+        ss << "        Capability_" << identifiers[capability] << " = " << (wideMasks ? "1ull" : "1u") << " << " << capability << ", // "
+           << ToSingleLine(profile.Capabilities[capability]) << '\n';
+    }
+    ss << "    };\n\n";
+
+    ss << "    // Indexed by DXGI_FORMAT, bit i is Capability i\n";
+    ss << "    inline constexpr " << maskType << " FormatCaps[] =\n    {\n";
+    for (uint32_t format = 0u; format <= static_cast<uint32_t>(lastFormat); ++format)
+    {
+        uint64_t mask = 0u;
+        std::string passNames;
+        const auto found = profile.Table.find(static_cast<DXGI_FORMAT>(format));
+        if (found != profile.Table.end())
+        {
+            const size_t columns = std::min(found->second.size(), capabilityCount);
+            for (size_t column = 0u; column < columns; ++column)
+            {
+                if (found->second[column] != FormatSupport::PASS)
+                    continue;
+
+                mask |= 1ull << column;
+                passNames += ' ';
+                passNames += identifiers[column];
+            }
+        }
+
+        char maskText[32];
+        std::snprintf(maskText, sizeof(maskText), "0x%0*llX%s", hexDigits, static_cast<unsigned long long>(mask), wideMasks ? "ull" : "u");
+
+        const char* name = D3DFormatToString(static_cast<DXGI_FORMAT>(format));
+        ss << "        " << maskText << ", // ";
+        if (std::string(name) != "Unknown format")
+            ss << name;
+        else
+            ss << format;
+        if (!passNames.empty())
+            ss << ':' << passNames;
+        ss << '\n';
+    }
+    ss << "    };\n";
+    ss << "    inline constexpr uint32_t FormatCount = static_cast<uint32_t>(sizeof(FormatCaps) / sizeof(FormatCaps[0]));\n\n";
+
+    ss << "    constexpr " << maskType << " GetCaps(const DXGI_FORMAT format)\n    {\n";
+    ss << "        return static_cast<uint32_t>(format) < FormatCount ? FormatCaps[format] : 0u;\n    }\n\n";
+    ss << "    // True when the format has every capability in caps\n";
+    ss << "    constexpr bool Supports(const DXGI_FORMAT format, const " << maskType << " caps)\n    {\n";
+    ss << "        return (GetCaps(format) & caps) == caps;\n    }\n\n";
+
+    for (size_t capability = 0u; capability < capabilityCount; ++capability)
+    {
+        ss << "    template <DXGI_FORMAT Format> inline constexpr bool " << identifiers[capability] << " = Supports(Format, Capability_"
+           << identifiers[capability] << ");\n";
+    }
+    ss << "}\n";
+
+    return ss.str();
+}
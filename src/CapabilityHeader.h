@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+
+#include "SupportTable.h"
+
+// Writes a report as a C++17 header engine code can branch on at compile time, e.g.
+//     if constexpr (Caps::RenderTarget<DXGI_FORMAT_R11G11B10_FLOAT>)
+// One constexpr capability mask per format, indexed by the DXGI_FORMAT value, with a variable
+// template per capability and Supports()/GetCaps() for runtime formats. Output only depends on
+// the report, formats in enum order and one line each, so regenerated headers diff cleanly.
+// UNKN cells are generated as unsupported.
+std::string GenerateCapabilityHeader(const SupportReport& profile, const char* namespaceName = "Caps");
+
+// Capability column name as an identifier, e.g. "Texture Cube" -> "TextureCube". Always starts with
+// an upper case letter so it can't be a keyword.
+std::string CapabilityToIdentifier(const std::string& capability);
@@ -0,0 +1,231 @@
+#include "ComparisonView.h"
+#include "FormatSearch.h"
+#include "StatusBadge.h"
+#include "Utils.h"
+
+#include "../ImGui/imgui.h"
+
+#include <algorithm>
+
+ComparisonView::ComparisonView()
+    : m_collapseIdentical(false)
+    , m_rowHeaderWidth(0.0f)
+{
+}
+
+void ComparisonView::SetSources(const std::vector<ReportSource>& sources)
+{
+    m_reportNames.clear();
+    m_capabilities.clear();
+    m_formats.clear();
+
+    // Line up capabilities by name, reports don't have to share the same columns
+    std::unordered_map<std::string, size_t> capabilityIndices;
+    std::vector<std::vector<size_t>> columnToCapability(sources.size());
+    for (size_t report = 0u; report < sources.size(); ++report)
+    {
+        m_reportNames.emplace_back(sources[report].Name);
+        for (const char* capability : sources[report].Capabilities)
+        {
+            const auto inserted = capabilityIndices.emplace(capability, m_capabilities.size());
+            if (inserted.second)
+                m_capabilities.emplace_back(capability);
+
+            columnToCapability[report].push_back(inserted.first->second);
+        }
+
+        for (const auto& [format, supportFlags] : *sources[report].Table)
+            m_formats.push_back(format);
+    }
+
+    std::sort(m_formats.begin(), m_formats.end());
+    m_formats.erase(std::unique(m_formats.begin(), m_formats.end()), m_formats.end());
+
+    std::unordered_map<DXGI_FORMAT, size_t> rowIndices;
+    for (size_t row = 0u; row < m_formats.size(); ++row)
+        rowIndices[m_formats[row]] = row;
+
+    const size_t reportCount = m_reportNames.size();
+    const size_t capabilityCount = m_capabilities.size();
+    m_cells.assign(m_formats.size() * reportCount * capabilityCount, FormatSupport::UNKN);
+    for (size_t report = 0u; report < sources.size(); ++report)
+    {
+        for (const auto& [format, supportFlags] : *sources[report].Table)
+        {
+            FormatSupport* rowCells = &m_cells[(rowIndices[format] * reportCount + report) * capabilityCount];
+            const size_t columns = std::min(supportFlags.size(), columnToCapability[report].size());
+            for (size_t column = 0u; column < columns; ++column)
+                rowCells[columnToCapability[report][column]] = supportFlags[column];
+        }
+    }
+
+    m_rowDiffers.assign(m_formats.size(), false);
+    for (size_t row = 0u; row < m_formats.size(); ++row)
+    {
+        for (size_t report = 1u; report < reportCount && !m_rowDiffers[row]; ++report)
+        {
+            for (size_t capability = 0u; capability < capabilityCount; ++capability)
+            {
+                if (GetCell(row, report, capability) != GetCell(row, 0u, capability))
+                {
+                    m_rowDiffers[row] = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    m_rowHeaderWidth = 0.0f;
+}
+
+void ComparisonView::Draw(const StatusBadgeRenderer& badges, const FormatSearchIndex& search)
+{
+    ImGui::Checkbox("Collapse identical rows", &m_collapseIdentical);
+    ImGui::SameLine();
+    ImGui::Text("%zu reports, %zu formats, %zu capabilities", m_reportNames.size(), m_formats.size(), m_capabilities.size());
+
+    const size_t reportCount = m_reportNames.size();
+    const size_t capabilityCount = m_capabilities.size();
+    const size_t columnCount = reportCount * capabilityCount;
+    if (columnCount == 0u)
+    {
+        ImGui::Text("Nothing to compare, import some '.csv' files");
+        return;
+    }
+
+    m_visibleRows.clear();
+    for (uint32_t row = 0u; row < m_formats.size(); ++row)
+    {
+        if (search.IsVisible(m_formats[row]) && (!m_collapseIdentical || m_rowDiffers[row]))
+            m_visibleRows.push_back(row);
+    }
+
+    const ImGuiStyle& style = ImGui::GetStyle();
+    if (m_rowHeaderWidth <= 0.0f)
+    {
+        for (const DXGI_FORMAT format : m_formats)
+            m_rowHeaderWidth = std::max(m_rowHeaderWidth, ImGui::CalcTextSize(D3DFormatToString(format)).x);
+        m_rowHeaderWidth += style.CellPadding.x * 2.0f;
+    }
+
+    const ImVec2 badgeSize = badges.GetSize();
+    const float cellWidth = badgeSize.x + 2.0f;
+    const float cellHeight = badgeSize.y + 2.0f;
+    const float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+    const float headerHeight = lineHeight * 2.0f;
+
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0.0f, 0.0f });
+    ImGui::BeginChild("##Comparison", ImVec2{ 0.0f, 0.0f }, ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGui::PopStyleVar();
+
+    // Only the extents go through layout, the cells are written straight to the draw list
+    ImGui::Dummy(ImVec2{ m_rowHeaderWidth + columnCount * cellWidth, headerHeight + m_visibleRows.size() * cellHeight });
+
+    const ImVec2 windowPos = ImGui::GetWindowPos();
+    const ImVec2 windowSize = ImGui::GetWindowSize();
+    const float scrollX = ImGui::GetScrollX();
+    const float scrollY = ImGui::GetScrollY();
+    const ImVec2 viewMin = windowPos;
+    const ImVec2 viewMax{ windowPos.x + windowSize.x - (ImGui::GetScrollMaxY() > 0.0f ? style.ScrollbarSize : 0.0f),
+                          windowPos.y + windowSize.y - (ImGui::GetScrollMaxX() > 0.0f ? style.ScrollbarSize : 0.0f) };
+    const ImVec2 cellsMin{ viewMin.x + m_rowHeaderWidth, viewMin.y + headerHeight };
+
+    // Visible window of the grid
+    const size_t firstColumn = static_cast<size_t>(scrollX / cellWidth);
+    const size_t lastColumn = std::min(columnCount, static_cast<size_t>((scrollX + viewMax.x - cellsMin.x) / cellWidth) + 1u);
+    const size_t firstRow = static_cast<size_t>(scrollY / cellHeight);
+    const size_t lastRow = std::min(m_visibleRows.size(), static_cast<size_t>((scrollY + viewMax.y - cellsMin.y) / cellHeight) + 1u);
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const ImU32 differsColor = ImGui::GetColorU32(ImVec4{ 1.0f, 0.8f, 0.0f, 1.0f });
+    const ImU32 headerColor = ImGui::GetColorU32(ImGuiCol_TableHeaderBg);
+    const ImU32 borderColor = ImGui::GetColorU32(ImGuiCol_TableBorderStrong);
+    const ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+    const ImFont* font = ImGui::GetFont();
+    const float fontSize = ImGui::GetFontSize();
+
+    // Cells, outlined where they disagree with the target report
+    drawList->PushClipRect(cellsMin, viewMax, true);
+    for (size_t visibleRow = firstRow; visibleRow < lastRow; ++visibleRow)
+    {
+        const size_t row = m_visibleRows[visibleRow];
+        const float y = cellsMin.y + visibleRow * cellHeight - scrollY;
+        for (size_t column = firstColumn; column < lastColumn; ++column)
+        {
+            const size_t report = column / capabilityCount;
+            const size_t capability = column % capabilityCount;
+            const float x = cellsMin.x + column * cellWidth - scrollX;
+
+            const FormatSupport support = GetCell(row, report, capability);
+            if (report != 0u && support != GetCell(row, 0u, capability))
+                drawList->AddRectFilled(ImVec2{ x, y }, ImVec2{ x + cellWidth, y + cellHeight }, differsColor);
+
+            badges.DrawBadge(*drawList, ImVec2{ x + 1.0f, y + 1.0f }, ImVec2{ x + cellWidth - 1.0f, y + cellHeight - 1.0f }, support);
+        }
+    }
+    drawList->PopClipRect();
+
+    // Frozen column headers: report name across its group, then one capability per column
+    drawList->PushClipRect(ImVec2{ cellsMin.x, viewMin.y }, ImVec2{ viewMax.x, cellsMin.y }, true);
+    drawList->AddRectFilled(ImVec2{ cellsMin.x, viewMin.y }, ImVec2{ viewMax.x, cellsMin.y }, headerColor);
+    for (size_t report = firstColumn / capabilityCount; report * capabilityCount < lastColumn; ++report)
+    {
+        const float groupMinX = cellsMin.x + report * capabilityCount * cellWidth - scrollX;
+        const float groupMaxX = groupMinX + capabilityCount * cellWidth;
+        const ImVec4 clipRect{ groupMinX, viewMin.y, groupMaxX - style.CellPadding.x, viewMin.y + lineHeight };
+
+        // Keep the name readable while the group is partly scrolled out
+        const ImVec2 namePos{ std::max(groupMinX, cellsMin.x) + style.CellPadding.x, viewMin.y + style.CellPadding.y };
+        drawList->AddText(font, fontSize, namePos, textColor, m_reportNames[report].c_str(), nullptr, 0.0f, &clipRect);
+        drawList->AddLine(ImVec2{ groupMinX, viewMin.y }, ImVec2{ groupMinX, cellsMin.y }, borderColor);
+    }
+    for (size_t column = firstColumn; column < lastColumn; ++column)
+    {
+        const float x = cellsMin.x + column * cellWidth - scrollX;
+        const ImVec4 clipRect{ x, viewMin.y + lineHeight, x + cellWidth - 1.0f, cellsMin.y };
+        drawList->AddText(font, fontSize, ImVec2{ x + 1.0f, viewMin.y + lineHeight }, textColor, m_capabilities[column % capabilityCount].c_str(), nullptr, 0.0f, &clipRect);
+    }
+    drawList->PopClipRect();
+
+    // Frozen row headers
+    drawList->PushClipRect(ImVec2{ viewMin.x, cellsMin.y }, ImVec2{ cellsMin.x, viewMax.y }, true);
+    drawList->AddRectFilled(ImVec2{ viewMin.x, cellsMin.y }, ImVec2{ cellsMin.x, viewMax.y }, headerColor);
+    for (size_t visibleRow = firstRow; visibleRow < lastRow; ++visibleRow)
+    {
+        const float y = cellsMin.y + visibleRow * cellHeight - scrollY;
+        const ImVec2 textPos{ viewMin.x + style.CellPadding.x, y + (cellHeight - fontSize) * 0.5f };
+        drawList->AddText(textPos, m_rowDiffers[m_visibleRows[visibleRow]] ? differsColor : textColor, D3DFormatToString(m_formats[m_visibleRows[visibleRow]]));
+    }
+    drawList->PopClipRect();
+
+    drawList->AddRectFilled(viewMin, cellsMin, headerColor);
+    drawList->AddText(ImVec2{ viewMin.x + style.CellPadding.x, viewMin.y + lineHeight }, textColor, "DXGI Format");
+
+    if (ImGui::IsWindowHovered())
+    {
+        const ImVec2 mouse = ImGui::GetIO().MousePos;
+        if (mouse.x >= cellsMin.x && mouse.y >= cellsMin.y && mouse.x < viewMax.x && mouse.y < viewMax.y)
+        {
+            const size_t column = static_cast<size_t>((mouse.x - cellsMin.x + scrollX) / cellWidth);
+            const size_t visibleRow = static_cast<size_t>((mouse.y - cellsMin.y + scrollY) / cellHeight);
+            if (column < columnCount && visibleRow < m_visibleRows.size())
+                DrawTooltip(m_visibleRows[visibleRow], column);
+        }
+    }
+
+    ImGui::EndChild();
+}
+
+void ComparisonView::DrawTooltip(const size_t row, const size_t column) const
+{
+    const size_t report = column / m_capabilities.size();
+    const size_t capability = column % m_capabilities.size();
+
+    ImGui::BeginTooltip();
+    ImGui::Text("%s", D3DFormatToString(m_formats[row]));
+    ImGui::Text("%s: %s", m_capabilities[capability].c_str(), FormatSupportEnumToString(GetCell(row, report, capability)));
+    ImGui::Text("Report: %s", m_reportNames[report].c_str());
+    if (report != 0u)
+        ImGui::Text("Target (%s): %s", m_reportNames[0].c_str(), FormatSupportEnumToString(GetCell(row, 0u, capability)));
+    ImGui::EndTooltip();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SupportTable.h"
+
+class FormatSearchIndex;
+class StatusBadgeRenderer;
+
+// Side-by-side view of several support tables, one column group per report.
+// Tables are merged once into a dense [format][report][capability] grid whenever the
+// set of reports changes. Drawing is virtualised on both axes: only the rows and columns
+// inside the scrolled viewport are written to the draw list, the rest only contribute to
+// the scroll extents. ImGui tables are not used as they top out at 512 columns.
+class ComparisonView
+{
+public:
+    ComparisonView();
+
+    // sources[0] is the target, cells that differ from it are highlighted
+    void SetSources(const std::vector<ReportSource>& sources);
+    size_t GetReportCount() const { return m_reportNames.size(); }
+
+    void Draw(const StatusBadgeRenderer& badges, const FormatSearchIndex& search);
+
+private:
+    FormatSupport GetCell(const size_t row, const size_t report, const size_t capability) const
+    {
+        return m_cells[(row * m_reportNames.size() + report) * m_capabilities.size() + capability];
+    }
+    void DrawTooltip(const size_t row, const size_t column) const;
+
+    std::vector<std::string> m_reportNames;
+    std::vector<std::string> m_capabilities; // Union of every report's capabilities, in first-seen order
+    std::vector<DXGI_FORMAT> m_formats;      // Union of every report's formats, in enum order
+    std::vector<FormatSupport> m_cells;
+    std::vector<bool> m_rowDiffers;          // Any report disagrees with the target on this format
+
+    std::vector<uint32_t> m_visibleRows;     // Rows left after search and collapsing, rebuilt per frame
+    bool m_collapseIdentical;
+    float m_rowHeaderWidth;                  // Measured lazily as it needs the font
+};
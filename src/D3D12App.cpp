@@ -1,6 +1,10 @@
 ﻿#include "D3D12App.h"
 
 #include "Win32Application.h"
+#include "AdapterCache.h"
+#include "ReportCollector.h"
+#include "ReportIO.h"
+#include "Trace.h"
 #include "Utils.h"
 
 #include "d3dx12.h"
@@ -8,7 +12,83 @@
 #include "../ImGui/backends/imgui_impl_dx12.h"
 #include "../ImGui/backends/imgui_impl_win32.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
+#include <thread>
+
+#define ADAPTER_CACHE_PATH "DFSE_Adapters.cache"     // Next to the exports, see AdapterCache.h
+#define FONT_ATLAS_CACHE_PATH "DFSE_FontAtlas.cache" // See FontAtlasCache.h
+
+namespace
+{
+    // Driver version 0 when the adapter doesn't report one
+    AdapterKey GetAdapterKey(IDXGIAdapter1* adapter, const DXGI_ADAPTER_DESC1& desc, bool& outHasUmdVersion)
+    {
+        LARGE_INTEGER umdVersion{};
+        outHasUmdVersion = SUCCEEDED(adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &umdVersion));
+        return AdapterKey{ desc.VendorId, desc.DeviceId, desc.SubSysId, desc.Revision,
+            outHasUmdVersion ? static_cast<uint64_t>(umdVersion.QuadPart) : 0u };
+    }
+
+    D3D12_RESOURCE_DESC ToResourceDesc(const TextureDesc& desc)
+    {
+        D3D12_RESOURCE_DESC resourceDesc{};
+        resourceDesc.Dimension = desc.Dimension == TextureDimension::Texture1D ? D3D12_RESOURCE_DIMENSION_TEXTURE1D
+            : (desc.Dimension == TextureDimension::Texture2D ? D3D12_RESOURCE_DIMENSION_TEXTURE2D : D3D12_RESOURCE_DIMENSION_TEXTURE3D);
+        resourceDesc.Width = desc.Width;
+        resourceDesc.Height = desc.Height;
+        resourceDesc.DepthOrArraySize = static_cast<UINT16>(desc.DepthOrArraySize);
+        resourceDesc.MipLevels = static_cast<UINT16>(desc.MipLevels);
+        resourceDesc.Format = desc.Format;
+        resourceDesc.SampleDesc = { desc.SampleCount, 0u };
+        resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        return resourceDesc;
+    }
+
+    // One GetResourceAllocationInfo1 call per batch
+    class DeviceAllocationProvider : public AllocationInfoProvider
+    {
+    public:
+        explicit DeviceAllocationProvider(ID3D12Device4* device)
+            : m_device(device)
+        {
+        }
+
+        bool QueryAllocationInfo(const AllocationProbeDesc* descs, const size_t count, AllocationInfo* outInfos) override
+        {
+            m_resourceDescs.resize(count);
+            m_allocationInfos.resize(count);
+            for (size_t i = 0u; i < count; ++i)
+            {
+                D3D12_RESOURCE_DESC& resourceDesc = m_resourceDescs[i];
+                resourceDesc = ToResourceDesc(descs[i].Desc);
+                if (descs[i].Usage & AllocationUsage_RenderTarget)
+                    resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+                if (descs[i].Usage & AllocationUsage_DepthStencil)
+                    resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+                if (descs[i].Usage & AllocationUsage_UnorderedAccess)
+                    resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+                if (descs[i].Usage & AllocationUsage_SmallAlignment)
+                    resourceDesc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+            }
+
+            const D3D12_RESOURCE_ALLOCATION_INFO total = m_device->GetResourceAllocationInfo1(0u, static_cast<UINT>(count), m_resourceDescs.data(),
+                m_allocationInfos.data());
+            if (total.SizeInBytes == UINT64_MAX)
+                return false;
+
+            for (size_t i = 0u; i < count; ++i)
+                outInfos[i] = AllocationInfo{ m_allocationInfos[i].SizeInBytes, m_allocationInfos[i].Alignment };
+            return true;
+        }
+
+    private:
+        ID3D12Device4* m_device;
+        std::vector<D3D12_RESOURCE_DESC> m_resourceDescs;
+        std::vector<D3D12_RESOURCE_ALLOCATION_INFO1> m_allocationInfos;
+    };
+}
 
 D3D12App::D3D12App(const uint32_t clientWidth, const uint32_t clientHeight)
     : m_width(clientWidth)
@@ -34,26 +114,121 @@ D3D12App::D3D12App(const uint32_t clientWidth, const uint32_t clientHeight)
     m_imguiLayer.BindBackend(*this);
 }
 
-void D3D12App::Initialise()
+// Startup runs as a small task graph, the main thread only doing what needs the window:
+//   worker: adapter, device and sync objects
+//   worker: font atlas rasterization
+//   worker: once the device is there, the format support table, streamed to the UI row by
+//           row, then the allocation probe and collector send
+//   main:   window, swap chain once the device is there, ImGui once the atlas is there
+// Nothing on screen waits for the probe worker, so time to first frame is the longest chain
+// without it rather than the sum of every stage. The main thread never blocks on a worker, the
+// message loop polls PollInitialise() so the window keeps answering while they run.
+void D3D12App::StartInitialise()
+{
+    TRACE_ZONE("StartInitialise");
+    m_deviceTask = std::async(std::launch::async, [this]()
+    {
+        SetTraceThreadName("Startup device");
+        CreateDeviceAndQueue();
+        CreateSyncObjects();
+    });
+
+    // Nothing in here touches the ImGui context, it's created with this atlas once the window exists
+    m_fontAtlasTask = std::async(std::launch::async, [this]()
+    {
+        SetTraceThreadName("Startup font atlas");
+        TRACE_ZONE("Build font atlas");
+        m_imguiLayer.Initialise(m_fontAtlas, FONT_ATLAS_CACHE_PATH);
+
+        // The renderer backend uploads RGBA, convert now rather than in the first frame
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        m_fontAtlas.GetTexDataAsRGBA32(&pixels, &width, &height);
+    });
+}
+
+bool D3D12App::PollInitialise()
 {
-    CreateDeviceAndQueue();
-    CreateSyncObjects();
-    CreateSwapChain();
+    if (m_initialised)
+        return true;
+    if (m_startupFailed)
+        return false;
+    if (!m_deviceTask.valid() && !m_swapChain)
+        StartInitialise();
+
+    const auto isReady = [](const std::future<void>& task) { return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+    if (!m_swapChain)
+    {
+        if (!isReady(m_deviceTask))
+            return false;
+
+        TRACE_ZONE("Device ready");
+        try
+        {
+            m_deviceTask.get();
+        }
+        catch (const WorkerFailure& failure)
+        {
+            // Reported from here so the quit message reaches this thread's loop
+            m_startupFailed = true;
+            ReportFailure(failure.Code);
+            return false;
+        }
+        m_probeTask = std::async(std::launch::async, [this]()
+        {
+            SetTraceThreadName("Startup probe");
+            SupportTable table;
+            CreateFormatSupportTable(table);
+            ProbeAllocationInfo(table);
+
+            // Nothing to send when no collector is listening, the table is still there to export by hand
+            if (m_collectorPort != 0u && !m_cancelProbe.load(std::memory_order_relaxed))
+                SendFormatSupportTable(table);
+        });
+
+        CreateSwapChain();
+    }
+
+    if (!isReady(m_fontAtlasTask))
+        return false;
+
+    TRACE_ZONE("Font atlas ready");
+    m_fontAtlasTask.get();
     InitialiseImGui();
-    CreateFormatSupportTable();
+    m_initialised = true;
+    return true;
 }
 
 void D3D12App::Shutdown()
 {
-    ImGui_ImplDX12_Shutdown();
-    ImGui_ImplWin32_Shutdown();
-    ImGui::DestroyContext();
+    TRACE_ZONE("Shutdown");
+    if (m_probeTask.valid())
+    {
+        m_cancelProbe.store(true, std::memory_order_relaxed);
+        m_probeTask.wait();
+    }
+
+    // The window may close before startup finished, the workers still use this object
+    if (m_deviceTask.valid())
+        m_deviceTask.wait();
+    if (m_fontAtlasTask.valid())
+        m_fontAtlasTask.wait();
 
-    CloseHandle(m_fenceEvent);
+    if (m_initialised)
+    {
+        ImGui_ImplDX12_Shutdown();
+        ImGui_ImplWin32_Shutdown();
+        ImGui::DestroyContext();
+    }
+
+    if (m_fenceEvent != INVALID_HANDLE_VALUE)
+        CloseHandle(m_fenceEvent);
 }
 
 void D3D12App::BeginFrame()
 {
+    TRACE_ZONE("BeginFrame");
     HandleEvents();
 
     // Reset command allocator. Must be done *after* the GPU is finished with it
@@ -69,6 +244,8 @@ void D3D12App::BeginFrame()
     m_cmdList->OMSetRenderTargets(1u, &m_backBufferRTHandles[m_backBufferIdx], FALSE, nullptr);
     m_cmdList->SetDescriptorHeaps(1u, m_imGuiDescriptorHeap.GetAddressOf());
 
+    // The first frame also uploads the font atlas
+    TRACE_ZONE("ImGui NewFrame");
     ImGui_ImplWin32_NewFrame();
     ImGui_ImplDX12_NewFrame();
     ImGui::NewFrame();
@@ -76,21 +253,42 @@ void D3D12App::BeginFrame()
 
 void D3D12App::OnRender()
 {
-    if (m_minimized)
+    m_frameScheduler.ConsumeFrame();
+    if (m_minimized || !m_initialised)
         return;
 
+    TRACE_ZONE("Frame");
+    ConsumeSupportTableRows();
     BeginFrame();
 
     m_imguiLayer.OnRender();
 
     EndFrame();
+
+    // Keep the text caret blinking while a text box is focused
+    if (ImGui::GetIO().WantTextInput)
+        m_frameScheduler.RequestFrameIn(std::chrono::milliseconds(400));
 }
 
 void D3D12App::OnResize(const uint32_t width, const uint32_t height, const bool minimized)
 {
     m_minimized = minimized;
+
+    // The window is shown while startup is still running, the swap chain is then made at this size
+    if (!m_swapChain)
+    {
+        if (!minimized && width != 0u && height != 0u)
+        {
+            m_width = width;
+            m_height = height;
+            m_viewport = D3D12_VIEWPORT{ 0.0f, 0.0f, static_cast<float>(m_width), static_cast<float>(m_height) };
+            m_scissor = D3D12_RECT{ 0u, 0u, static_cast<LONG>(m_width), static_cast<LONG>(m_height) };
+        }
+        return;
+    }
     if ((width != m_width || height != m_height) && !minimized)
     {
+        TRACE_ZONE("Resize swap chain");
         // Flush GPU commands
         WaitForGPU();
 
@@ -111,9 +309,12 @@ void D3D12App::OnResize(const uint32_t width, const uint32_t height, const bool
         // Reset the frame index to the current back buffer index.
         m_backBufferIdx = m_swapChain->GetCurrentBackBufferIndex();
 
-        // Update variables to match new size
-        ImGuiIO& io = ImGui::GetIO();
-        io.DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+        // Update variables to match new size, ImGui may still be waiting for its font atlas
+        if (m_initialised)
+        {
+            ImGuiIO& io = ImGui::GetIO();
+            io.DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+        }
 
         m_width = width;
         m_height = height;
@@ -124,41 +325,80 @@ void D3D12App::OnResize(const uint32_t width, const uint32_t height, const bool
     }
 }
 
+SupportReport D3D12App::BuildSupportReport(const SupportTable& table) const
+{
+    SupportReport report{ m_gpuInfo, {}, table };
+    report.Capabilities.assign(m_tableHeaders.begin() + 1, m_tableHeaders.end());
+    return report;
+}
+
 bool D3D12App::ExportFormatSupportTable()
 {
-    std::ofstream outFile("DXGI_Output.csv", std::ios::trunc | std::ios::out);
-    if (!outFile.is_open() || !outFile.good())
-        return false;
+    TRACE_ZONE("ExportFormatSupportTable");
+    return ExportSupportReportCSV("DXGI_Output.csv", BuildSupportReport(m_supportTable));
+}
 
-    std::stringstream ss;
-    for (const char* tableHeader : m_tableHeaders)
-    {
-        ss << tableHeader << ',';
-    }
-    ss << '\n';
+bool D3D12App::SendFormatSupportTable(const SupportTable& table)
+{
+    TRACE_ZONE("SendFormatSupportTable");
+    ReportSender sender;
+    return sender.Connect(m_collectorPort) && sender.Send(BuildSupportReport(table)) && sender.Flush();
+}
 
+bool D3D12App::ExportCopyableFootprints()
+{
+    TRACE_ZONE("ExportCopyableFootprints");
+    std::vector<TextureDesc> descs;
     for (const auto& [format, supportFlags] : m_supportTable)
+        AppendFootprintValidationDescs(format, descs);
+
+    std::vector<FootprintRecord> records;
+    records.reserve(descs.size());
+    for (const TextureDesc& desc : descs)
     {
-        ss << D3DFormatToString(format) << ',';
+        const D3D12_RESOURCE_DESC resourceDesc = ToResourceDesc(desc);
 
-        for (const FormatSupport flag : supportFlags)
+        const UINT arraySize = desc.Dimension == TextureDimension::Texture3D ? 1u : desc.DepthOrArraySize;
+        const UINT subresourceCount = desc.MipLevels * arraySize * std::max<UINT>(1u, D3D12GetFormatPlaneCount(m_device.Get(), desc.Format));
+
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(subresourceCount);
+        std::vector<UINT> numRows(subresourceCount);
+        std::vector<UINT64> rowSizes(subresourceCount);
+        UINT64 totalBytes = UINT64_MAX;
+        m_device->GetCopyableFootprints(&resourceDesc, 0u, subresourceCount, 0u, layouts.data(), numRows.data(), rowSizes.data(), &totalBytes);
+
+        FootprintRecord record{ desc, totalBytes, {} };
+        if (totalBytes != UINT64_MAX)
         {
-            ss << FormatSupportEnumToString(flag) << ',';
+            for (UINT i = 0u; i < subresourceCount; ++i)
+            {
+                const D3D12_SUBRESOURCE_FOOTPRINT& footprint = layouts[i].Footprint;
+                record.Layouts.push_back(SubresourceFootprint{ layouts[i].Offset, footprint.Format, footprint.Width, footprint.Height, footprint.Depth,
+                    footprint.RowPitch, numRows[i], rowSizes[i] });
+            }
         }
-
-        ss << '\n';
+        records.push_back(std::move(record));
     }
 
-    outFile << ss.str().c_str();
+    return ExportFootprintRecordsCSV("DXGI_Footprints.csv", records);
+}
 
-    outFile.close();
-    return true;
+bool D3D12App::ExportAllocationInfo()
+{
+    TRACE_ZONE("ExportAllocationInfo");
+    if (!IsAllocationInfoReady())
+        return false;
+    return ExportAllocationRecordsCSV("DXGI_AllocationInfo.csv", m_gpuInfo, m_allocationRecords);
 }
 
 void D3D12App::EndFrame()
 {
-    ImGui::Render();
-    ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), m_cmdList.Get());
+    TRACE_ZONE("EndFrame");
+    {
+        TRACE_ZONE("ImGui Render");
+        ImGui::Render();
+        ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), m_cmdList.Get());
+    }
 
     const auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(m_backBufferTargets[m_backBufferIdx].Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
     m_cmdList->ResourceBarrier(1, &barrier);
@@ -166,7 +406,10 @@ void D3D12App::EndFrame()
     D3D_VERIFY(m_cmdList->Close());
     m_cmdQueue->ExecuteCommandLists(1u, reinterpret_cast<ID3D12CommandList**>(m_cmdList.GetAddressOf()));
 
-    m_swapChain->Present(1u, 0u);
+    {
+        TRACE_ZONE("Present");
+        m_swapChain->Present(1u, 0u);
+    }
 
     MoveToNextFrame();
 }
@@ -183,6 +426,7 @@ void D3D12App::MoveToNextFrame()
     // If the next frame is not ready to be rendered yet, wait until it is ready.
     if (m_fence->GetCompletedValue() < m_fenceValues[m_backBufferIdx])
     {
+        TRACE_ZONE("Wait for back buffer");
         D3D_VERIFY(m_fence->SetEventOnCompletion(m_fenceValues[m_backBufferIdx], m_fenceEvent));
         WaitForSingleObjectEx(m_fenceEvent, INFINITE, FALSE);
     }
@@ -193,6 +437,7 @@ void D3D12App::MoveToNextFrame()
 
 void D3D12App::WaitForGPU()
 {
+    TRACE_ZONE("WaitForGPU");
     // Schedule a Signal command in the queue.
     D3D_VERIFY(m_cmdQueue->Signal(m_fence.Get(), m_fenceValues[m_backBufferIdx]));
 
@@ -204,17 +449,32 @@ void D3D12App::WaitForGPU()
     m_fenceValues[m_backBufferIdx]++;
 }
 
-void D3D12App::CreateFormatSupportTable()
+void D3D12App::CreateFormatSupportTable(SupportTable& outTable)
 {
+    TRACE_ZONE("CreateFormatSupportTable");
     // Cast the last enum we care about to int to get its index in the enum list.
     const size_t numberFormats = static_cast<size_t>(DXGI_FORMAT_B4G4R4A4_UNORM);
+
+    // The formats the UI calls common go first, the rest follow in enum order
+    const std::vector<DXGI_FORMAT>& commonFormats = m_imguiLayer.GetCommonFormats();
+    std::vector<DXGI_FORMAT> probeOrder(commonFormats);
     for (size_t i = 0u; i < numberFormats; ++i)
     {
-        D3D12_FEATURE_DATA_FORMAT_SUPPORT formatSupport = { static_cast<DXGI_FORMAT>(i), D3D12_FORMAT_SUPPORT1_NONE, D3D12_FORMAT_SUPPORT2_NONE };
+        if (std::find(commonFormats.begin(), commonFormats.end(), static_cast<DXGI_FORMAT>(i)) == commonFormats.end())
+            probeOrder.push_back(static_cast<DXGI_FORMAT>(i));
+    }
+
+    for (const DXGI_FORMAT format : probeOrder)
+    {
+        // The table is left incomplete, nothing reads it once the app is shutting down
+        if (m_cancelProbe.load(std::memory_order_relaxed))
+            return;
+
+        std::vector<FormatSupport> supportFlags(SUPPORT_FLAGS_COUNT, FormatSupport::UNKN); // Could not check feature support
+        D3D12_FEATURE_DATA_FORMAT_SUPPORT formatSupport = { format, D3D12_FORMAT_SUPPORT1_NONE, D3D12_FORMAT_SUPPORT2_NONE };
         if (SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT, &formatSupport, sizeof(formatSupport))))
         {
             // Note: If you wish to add anything here, also update "m_tableHeaders" in ImGuiLayer.cpp
-            std::array<FormatSupport, SUPPORT_FLAGS_COUNT> supportFlags{};
             supportFlags[0] = (formatSupport.Support1 & D3D12_FORMAT_SUPPORT1_TEXTURE1D ? FormatSupport::PASS : FormatSupport::FAIL);
             supportFlags[1] = (formatSupport.Support1 & D3D12_FORMAT_SUPPORT1_TEXTURE2D ? FormatSupport::PASS : FormatSupport::FAIL);
             supportFlags[2] = (formatSupport.Support1 & D3D12_FORMAT_SUPPORT1_TEXTURE3D ? FormatSupport::PASS : FormatSupport::FAIL);
@@ -223,19 +483,59 @@ void D3D12App::CreateFormatSupportTable()
             supportFlags[5] = (formatSupport.Support1 & D3D12_FORMAT_SUPPORT1_DEPTH_STENCIL ? FormatSupport::PASS : FormatSupport::FAIL);
             supportFlags[6] = (formatSupport.Support1 & D3D12_FORMAT_SUPPORT1_DISPLAY ? FormatSupport::PASS : FormatSupport::FAIL);
             supportFlags[7] = (formatSupport.Support1 & D3D12_FORMAT_SUPPORT1_MIP ? FormatSupport::PASS : FormatSupport::FAIL);
-
-            m_supportTable[static_cast<DXGI_FORMAT>(i)] = supportFlags;
         }
-        else
+        outTable[format] = supportFlags;
+
+        // The queue holds more rows than there are formats, so this only spins if the UI has stalled
+        SupportTableRow row{ format, std::move(supportFlags) };
+        while (!m_supportTableRows.TryPush(std::move(row)) && !m_cancelProbe.load(std::memory_order_relaxed))
+            std::this_thread::yield();
+        Win32App::RequestRedraw();
+    }
+
+    SupportTableRow last{ DXGI_FORMAT_UNKNOWN, {} };
+    while (!m_supportTableRows.TryPush(std::move(last)))
+        std::this_thread::yield();
+    Win32App::RequestRedraw();
+}
+
+void D3D12App::ConsumeSupportTableRows()
+{
+    if (m_supportTableComplete)
+        return;
+
+    TRACE_ZONE("ConsumeSupportTableRows");
+    bool changed = false;
+    SupportTableRow row;
+    while (m_supportTableRows.TryPop(row))
+    {
+        if (row.Flags.empty())
         {
-            // Could not check feature support
-            std::array<FormatSupport, SUPPORT_FLAGS_COUNT> supportFlags{};
-            supportFlags.fill(FormatSupport::UNKN);
-            m_supportTable[static_cast<DXGI_FORMAT>(i)] = supportFlags;
+            m_supportTableComplete = true;
+            continue;
         }
 
+        m_supportTable[row.Format] = std::move(row.Flags);
+        changed = true;
     }
 
+    if (changed)
+        m_supportTableVersion++;
+}
+
+void D3D12App::ProbeAllocationInfo(const SupportTable& table)
+{
+    TRACE_ZONE("ProbeAllocationInfo");
+    std::vector<AllocationProbeDesc> descs;
+    AppendAllocationProbeDescs(table, descs);
+
+    DeviceAllocationProvider provider(m_device.Get());
+    RunAllocationProbe(provider, descs, m_allocationRecords, ALLOCATION_PROBE_BATCH_SIZE, &m_cancelProbe);
+    if (!m_cancelProbe.load(std::memory_order_relaxed))
+    {
+        m_allocationInfoReady.store(true, std::memory_order_release);
+        Win32App::RequestRedraw();
+    }
 }
 
 D3D_FEATURE_LEVEL D3D12App::FindHighestSupportedFLForDevice(ID3D12Device* device) const
@@ -253,7 +553,7 @@ D3D_FEATURE_LEVEL D3D12App::FindHighestSupportedFLForDevice(ID3D12Device* device
     };
 
     D3D_FEATURE_LEVEL maxSupportedFeatureLevel = D3D_FEATURE_LEVEL_11_0;
-    if (SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_FEATURE_LEVELS, &featureLevels, sizeof(featureLevels))))
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_FEATURE_LEVELS, &featureLevels, sizeof(featureLevels))))
     {
         maxSupportedFeatureLevel = featureLevels.MaxSupportedFeatureLevel;
     }
@@ -275,62 +575,136 @@ const char* D3D12App::FeatureLevelToString(const D3D_FEATURE_LEVEL FL) const
 
 void D3D12App::CreateDeviceAndQueue()
 {
+    TRACE_ZONE("CreateDeviceAndQueue");
     constexpr uint32_t factoryFlags{ 0u };
-    D3D_VERIFY(CreateDXGIFactory2(factoryFlags, IID_PPV_ARGS(&m_factory)));
+    D3D_VERIFY_WORKER(CreateDXGIFactory2(factoryFlags, IID_PPV_ARGS(&m_factory)));
 
-    // Find the highest performance adapter
-    ComPtr<IDXGIAdapter1> adapter;
-    for (UINT adapterIndex = 0;
-        DXGI_ERROR_NOT_FOUND != m_factory->EnumAdapterByGpuPreference(adapterIndex, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE,
-            IID_PPV_ARGS(&adapter)); ++adapterIndex)
+    AdapterCache adapterCache;
     {
-        DXGI_ADAPTER_DESC1 desc;
-        D3D_VERIFY(adapter->GetDesc1(&desc));
-
-        if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE)  // Don't select the Basic Render Driver adapter.
-            continue;
+        TRACE_ZONE("Load adapter cache");
+        adapterCache.Load(ADAPTER_CACHE_PATH);
+    }
 
-        // Check to see if the adapter supports Direct3D 12,
-        // but don't create the actual device yet.
-        if (SUCCEEDED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, _uuidof(ID3D12Device8), nullptr)))
+    // Take the highest performance adapter a D3D12 device can be created on, creating it once.
+    // The feature level passed to D3D12CreateDevice is only a minimum, a device made at 11_0
+    // already has everything the adapter supports, so it's never recreated at a higher one.
+    {
+        TRACE_ZONE("Find adapter");
+        const auto tryAdapter = [this, &adapterCache](IDXGIAdapter1* adapter, const DXGI_ADAPTER_DESC1& desc, const AdapterKey& key,
+            const bool hasUmdVersion, const AdapterCache::Entry* cached)
         {
+            // Known adapters are created straight at their highest feature level, which also catches a cache that no longer holds
+            HRESULT hr = E_FAIL;
+            if (cached && cached->MaxFeatureLevel != 0u)
+            {
+                TRACE_ZONE("Create device at cached feature level");
+                hr = D3D12CreateDevice(adapter, static_cast<D3D_FEATURE_LEVEL>(cached->MaxFeatureLevel), IID_PPV_ARGS(&m_device));
+            }
+            if (FAILED(hr))
+            {
+                TRACE_ZONE("Create device at 11_0");
+                hr = D3D12CreateDevice(adapter, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&m_device));
+                cached = nullptr;
+            }
+            if (FAILED(hr))
+            {
+                // Only a definite "no D3D12 here" is worth remembering, anything else (out of memory, a device
+                // removed mid-update, ...) may well work next run
+                if (hr == DXGI_ERROR_UNSUPPORTED)
+                    adapterCache.Set(key, 0u);
+                return false;
+            }
+
+            m_maxFL = cached ? static_cast<D3D_FEATURE_LEVEL>(cached->MaxFeatureLevel) : FindHighestSupportedFLForDevice(m_device.Get());
+            adapterCache.Set(key, static_cast<uint32_t>(m_maxFL));
+
             m_gpuInfo.VRAMBytes = desc.DedicatedVideoMemory;
             m_gpuInfo.SharedSystemMemBytes = desc.SharedSystemMemory;
             const std::wstring gpuName(desc.Description);
             m_gpuInfo.Name = UTF16toUTF8(gpuName);
-            break;
+            m_gpuInfo.VendorId = desc.VendorId;
+            m_gpuInfo.DeviceId = desc.DeviceId;
+            if (hasUmdVersion)
+                m_gpuInfo.DriverVersion = key.DriverVersion;
+            m_gpuInfo.MaxFeatureLevel = D3DFeatureLevelToString(m_maxFL);
+            return true;
+        };
+
+        ComPtr<IDXGIAdapter1> adapter;
+        std::vector<ComPtr<IDXGIAdapter1>> skippedAdapters; // Cached as unsupported, only tried when nothing else works
+        for (UINT adapterIndex = 0;
+            DXGI_ERROR_NOT_FOUND != m_factory->EnumAdapterByGpuPreference(adapterIndex, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE,
+                IID_PPV_ARGS(&adapter)); ++adapterIndex)
+        {
+            DXGI_ADAPTER_DESC1 desc;
+            D3D_VERIFY_WORKER(adapter->GetDesc1(&desc));
+
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE)  // Don't select the Basic Render Driver adapter.
+                continue;
+
+            bool hasUmdVersion = false;
+            const AdapterKey key = GetAdapterKey(adapter.Get(), desc, hasUmdVersion);
+
+            // Skip adapters that had no D3D12 with this driver before
+            const AdapterCache::Entry* cached = adapterCache.Find(key);
+            if (cached && cached->MaxFeatureLevel == 0u)
+            {
+                skippedAdapters.push_back(adapter);
+                continue;
+            }
+
+            if (tryAdapter(adapter.Get(), desc, key, hasUmdVersion, cached))
+                break;
+        }
+
+        // The cache may be wrong, e.g. a feature update added D3D12 without a new driver version.
+        // Rather than fail start-up on its word, probe the skipped adapters for real.
+        for (size_t i = 0u; !m_device && i < skippedAdapters.size(); ++i)
+        {
+            TRACE_ZONE("Probe skipped adapter");
+            IDXGIAdapter1* skipped = skippedAdapters[i].Get();
+            DXGI_ADAPTER_DESC1 desc;
+            D3D_VERIFY_WORKER(skipped->GetDesc1(&desc));
+
+            bool hasUmdVersion = false;
+            const AdapterKey key = GetAdapterKey(skipped, desc, hasUmdVersion);
+            tryAdapter(skipped, desc, key, hasUmdVersion, nullptr);
         }
     }
 
-    // Create device at lowest feature level for D3D12. 
-    D3D_VERIFY(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&m_device)));
-    m_maxFL = FindHighestSupportedFLForDevice(m_device.Get());
-    m_gpuInfo.MaxFeatureLevel = D3DFeatureLevelToString(m_maxFL);
+    // Results are only written when this run learned something new
+    if (adapterCache.IsDirty())
+    {
+        TRACE_ZONE("Save adapter cache");
+        adapterCache.Save(ADAPTER_CACHE_PATH);
+    }
 
-    // Recreate our device with the highest feature level this device has
-    m_device.Detach();
-    D3D_VERIFY(D3D12CreateDevice(adapter.Get(), m_maxFL, IID_PPV_ARGS(&m_device)));
+    // No adapter has D3D12, nothing below can run
+    if (!m_device)
+        throw WorkerFailure{ DXGI_ERROR_UNSUPPORTED };
 
     // Create the command queue.
+    TRACE_ZONE("Create queue and command lists");
     D3D12_COMMAND_QUEUE_DESC queueDesc;
     queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
     queueDesc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
     queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
     queueDesc.NodeMask = 0u;
-    D3D_VERIFY(m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_cmdQueue)));
+    D3D_VERIFY_WORKER(m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_cmdQueue)));
 
     m_cmdAllocators.resize(m_backBufferCount);
     for (auto& allocator : m_cmdAllocators)
     {
-        D3D_VERIFY(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&allocator)));
+        D3D_VERIFY_WORKER(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&allocator)));
     }
-    D3D_VERIFY(m_device->CreateCommandList(0u, D3D12_COMMAND_LIST_TYPE_DIRECT, m_cmdAllocators[0].Get(), nullptr, IID_PPV_ARGS(&m_cmdList)));
-    D3D_VERIFY(m_cmdList->Close());
+    D3D_VERIFY_WORKER(m_device->CreateCommandList(0u, D3D12_COMMAND_LIST_TYPE_DIRECT, m_cmdAllocators[0].Get(), nullptr, IID_PPV_ARGS(&m_cmdList)));
+    D3D_VERIFY_WORKER(m_cmdList->Close());
 }
 
 void D3D12App::CreateSyncObjects()
 {
-    D3D_VERIFY(m_device->CreateFence(0u, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+    TRACE_ZONE("CreateSyncObjects");
+    D3D_VERIFY_WORKER(m_device->CreateFence(0u, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
     m_fenceEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
     m_fenceValues.resize(m_backBufferCount);
     m_fenceValues[m_backBufferIdx]++;
@@ -338,6 +712,7 @@ void D3D12App::CreateSyncObjects()
 
 void D3D12App::CreateSwapChain()
 {
+    TRACE_ZONE("CreateSwapChain");
     DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
     swapChainDesc.BufferCount = m_backBufferCount;
     swapChainDesc.Width = m_width;
@@ -383,6 +758,7 @@ void D3D12App::CreateSwapChain()
 
 void D3D12App::CreateRenderTargets()
 {
+    TRACE_ZONE("CreateRenderTargets");
     m_backBufferTargets.resize(m_backBufferCount);
     for (uint8_t i = 0u; i < m_backBufferCount; ++i)
     {
@@ -393,8 +769,9 @@ void D3D12App::CreateRenderTargets()
 
 void D3D12App::InitialiseImGui()
 {
+    TRACE_ZONE("InitialiseImGui");
     IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
+    ImGui::CreateContext(&m_fontAtlas);
 
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
@@ -428,25 +805,43 @@ void D3D12App::HandleEvents()
     {
         m_openFileDialogue = false;
 
-        // Buffer to store filepath in
-        wchar_t szFileName[MAX_PATH] = { L"\0" };
+        // Buffer to store filepaths in, big enough for a multi-selection
+        std::vector<wchar_t> fileNames(32768u, L'\0');
 
         OPENFILENAME ofn;
         ZeroMemory(&ofn, sizeof(ofn));
         ofn.lStructSize = sizeof(ofn);
         ofn.hwndOwner = Win32App::GetHandle();
         ofn.lpstrFilter = L"Comma Seperated Value Files (*.csv)\0*.csv\0All Files (*.*)\0*.*\0";
-        ofn.lpstrFile = szFileName;
-        ofn.nMaxFile = MAX_PATH;
-        ofn.Flags = OFN_EXPLORER | OFN_FILEMUSTEXIST | OFN_HIDEREADONLY;
+        ofn.lpstrFile = fileNames.data();
+        ofn.nMaxFile = static_cast<DWORD>(fileNames.size());
+        ofn.Flags = OFN_EXPLORER | OFN_FILEMUSTEXIST | OFN_HIDEREADONLY | OFN_ALLOWMULTISELECT;
         ofn.lpstrDefExt = L"csv";
 
         if (GetOpenFileNameW(&ofn))
         {
-            m_tableHeaders.clear();
-            m_supportTable.clear();
-
-            // TODO: something useful with the filename stored in szFileName 
+            // A single selection is one full path, a multi-selection is the folder followed by each file name
+            std::vector<std::filesystem::path> paths;
+            const std::filesystem::path first(fileNames.data());
+            for (const wchar_t* name = fileNames.data() + first.native().size() + 1u; *name != L'\0'; name += wcslen(name) + 1u)
+                paths.push_back(first / name);
+            if (paths.empty())
+                paths.push_back(first);
+
+            TRACE_ZONE("Import reports");
+            bool importFailed = false;
+            for (const std::filesystem::path& path : paths)
+            {
+                SupportReport report;
+                if (ImportSupportReportCSV(path, report))
+                    m_importedReports.push_back(std::move(report));
+                else
+                    importFailed = true;
+            }
+            m_importedReportsVersion++;
+
+            if (importFailed)
+                MessageBoxW(NULL, L"One or more files could not be read as an exported '.csv' file", L"Import error", MB_OK | MB_ICONWARNING);
         }
     }
 
@@ -1,9 +1,9 @@
 #pragma once
-#include <array>
+#include <atomic>
 #include <cstdint>
+#include <future>
 #include <string>
 #include <vector>
-#include <unordered_map>
 
 // D3D12 / DXGI stuff
 #pragma comment(lib, "dxgi")
@@ -12,46 +12,55 @@
 #include <wrl/client.h>
 using Microsoft::WRL::ComPtr;
 
-// Corresponds number of bit flags checked in CreateFormatSupportTable()
-// or the number of column headers minus one
-#define SUPPORT_FLAGS_COUNT (8)
-
+#include "AllocationProbe.h"
+#include "FrameScheduler.h"
 #include "ImGuiLayer.h"
+#include "SPSCQueue.h"
+#include "UIBackend.h"
 
-struct GPUInfo
-{
-    size_t VRAMBytes; 
-    size_t SharedSystemMemBytes; // GPU resources in RAM aka things in upload heaps
-    std::string MaxFeatureLevel;
-    std::string Name;
+#define SUPPORT_ROW_QUEUE_SIZE (128u) // Rows in flight from the probe worker to the UI, more than there are formats
 
-    GPUInfo()
-        : VRAMBytes(0), SharedSystemMemBytes(0) {}
-};
-
-class D3D12App
+class D3D12App : public UIBackend
 {
 public:
     D3D12App(const uint32_t clientWidth, const uint32_t clientHeight);
 
-    void Initialise(); // Creates resources & setups ImGui
+    void StartInitialise(); // Starts the stages that don't need the window on workers, call before creating it
+    // Creates the rest of the resources & sets up ImGui once the window exists. Never blocks, call it from the
+    // message loop until it returns true, each call picks up whichever startup stages have finished.
+    // A worker's failure is reported from here, posting the quit to the calling thread's message loop.
+    bool PollInitialise();
+    bool IsInitialised() const { return m_initialised; }
     void Shutdown();
 
     void OnRender();
     void OnResize(const uint32_t width, const uint32_t height, const bool minimized);
 
-    uint32_t GetWidth() const { return m_width; }
-    uint32_t GetHeight() const { return m_height; }
+    uint32_t GetWidth() const override { return m_width; }
+    uint32_t GetHeight() const override { return m_height; }
+
+    FrameScheduler& GetFrameScheduler() { return m_frameScheduler; }
 
-    const GPUInfo& GetGPUInfo() const { return m_gpuInfo; }
-    bool ExportFormatSupportTable();
+    // Sends the report to a dfse_collector on this port once the table is built, 0 to not
+    void SetCollectorPort(const uint16_t port) { m_collectorPort = port; }
+
+    const GPUInfo& GetGPUInfo() const override { return m_gpuInfo; }
+    bool ExportFormatSupportTable() override;
+    bool ExportCopyableFootprints() override;
+    bool ExportAllocationInfo() override;
+    bool IsAllocationInfoReady() const override { return m_allocationInfoReady.load(std::memory_order_acquire); }
 
     // Events
-    void OpenFileDialogue() { m_openFileDialogue = true; }
-    void SendFileSaveErrorEvent() { m_fileSaveError = true; }
+    void OpenFileDialogue() override { m_openFileDialogue = true; }
+    void SendFileSaveErrorEvent() override { m_fileSaveError = true; }
     
-    const std::vector<const char*>& GetTableHeaders() const { return m_tableHeaders; }
-    const std::unordered_map<DXGI_FORMAT, std::array<FormatSupport, SUPPORT_FLAGS_COUNT>>& GetSupportTable() const { return m_supportTable; }
+    const std::vector<const char*>& GetTableHeaders() const override { return m_tableHeaders; }
+    const SupportTable& GetSupportTable() const override { return m_supportTable; }
+    uint32_t GetSupportTableVersion() const override { return m_supportTableVersion; }
+    bool IsSupportTableComplete() const override { return m_supportTableComplete; }
+
+    const std::vector<SupportReport>& GetImportedReports() const override { return m_importedReports; }
+    uint32_t GetImportedReportsVersion() const override { return m_importedReportsVersion; }
 private:
     D3D_FEATURE_LEVEL FindHighestSupportedFLForDevice(ID3D12Device* device) const;
     const char* FeatureLevelToString(const D3D_FEATURE_LEVEL FL) const;
@@ -69,16 +78,46 @@ private:
     void MoveToNextFrame();
     void WaitForGPU();
 
-    void CreateFormatSupportTable();
+    // Probe worker: streams each format's row to the UI as soon as it's probed, common formats first
+    void CreateFormatSupportTable(SupportTable& outTable);
+    void ConsumeSupportTableRows(); // UI thread, moves the rows probed so far into m_supportTable
+
+    SupportReport BuildSupportReport(const SupportTable& table) const;
+    bool SendFormatSupportTable(const SupportTable& table);
+    void ProbeAllocationInfo(const SupportTable& table); // Heap sizes and alignments of the supported formats, see AllocationProbe.h
 
     GPUInfo m_gpuInfo;
     ImGuiLayer m_imguiLayer;
+    ImFontAtlas m_fontAtlas; // Shared with the ImGui context, outlives it
+    FrameScheduler m_frameScheduler;
 
     bool m_fileSaveError : 1;
     bool m_openFileDialogue : 1;
     std::vector<const char*> m_tableHeaders;
-    std::unordered_map<DXGI_FORMAT, std::array<FormatSupport, SUPPORT_FLAGS_COUNT>> m_supportTable;
+    SupportTable m_supportTable;
+    uint32_t m_supportTableVersion = 0u;
+
+    struct SupportTableRow
+    {
+        DXGI_FORMAT Format;
+        std::vector<FormatSupport> Flags; // Empty for the last row, which only marks the table as complete
+    };
+    SPSCQueue<SupportTableRow, SUPPORT_ROW_QUEUE_SIZE> m_supportTableRows;
+    bool m_supportTableComplete = false;
+    std::vector<AllocationRecord> m_allocationRecords; // Written by the probe worker, read once m_allocationInfoReady is set
+    std::atomic<bool> m_allocationInfoReady{ false };
+    uint16_t m_collectorPort = 0u;
+    std::vector<SupportReport> m_importedReports;
+    uint32_t m_importedReportsVersion = 0u;
     
+    // Startup task graph, see StartInitialise()
+    std::future<void> m_deviceTask;
+    std::future<void> m_fontAtlasTask;
+    std::future<void> m_probeTask; // Support table, then allocation probe and collector send, nothing on screen waits for it
+    std::atomic<bool> m_cancelProbe{ false }; // Set by Shutdown(), the probe worker stops at its next format or batch
+    bool m_initialised = false;
+    bool m_startupFailed = false; // A worker's failure was reported and the quit posted, nothing more to start
+
     uint32_t m_width;
     uint32_t m_height;
     bool m_minimized;
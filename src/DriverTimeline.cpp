@@ -0,0 +1,309 @@
+#include "DriverTimeline.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+    void PutVarint(std::vector<uint8_t>& bytes, uint64_t value)
+    {
+        while (value >= 0x80u)
+        {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80u));
+            value >>= 7u;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint64_t GetVarint(const uint8_t*& bytes)
+    {
+        uint64_t value = 0u;
+        for (uint32_t shift = 0u;; shift += 7u)
+        {
+            const uint8_t byte = *bytes++;
+            value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+            if (!(byte & 0x80u))
+                return value;
+        }
+    }
+
+    // Pass and known masks of one report's formats, by timeline row
+    void GetReportMasks(const SupportReport& report, const std::vector<DXGI_FORMAT>& formats, const std::vector<std::string>& capabilities,
+        std::vector<DriverTimeline::RowState>& outRows)
+    {
+        std::vector<size_t> columnToCapability(report.Capabilities.size(), DRIVER_TIMELINE_MAX_CAPABILITIES);
+        for (size_t column = 0u; column < report.Capabilities.size(); ++column)
+        {
+            const auto found = std::find(capabilities.begin(), capabilities.end(), report.Capabilities[column]);
+            if (found != capabilities.end())
+                columnToCapability[column] = found - capabilities.begin();
+        }
+
+        for (DriverTimeline::RowState& row : outRows)
+        {
+            row.Pass = 0u;
+            row.Known = 0u;
+        }
+        for (const auto& [format, supportFlags] : report.Table)
+        {
+            const size_t row = std::lower_bound(formats.begin(), formats.end(), format) - formats.begin();
+            const size_t columns = std::min(supportFlags.size(), columnToCapability.size());
+            for (size_t column = 0u; column < columns; ++column)
+            {
+                if (columnToCapability[column] >= DRIVER_TIMELINE_MAX_CAPABILITIES || supportFlags[column] == FormatSupport::UNKN)
+                    continue;
+
+                const uint64_t bit = 1ull << columnToCapability[column];
+                outRows[row].Known |= bit;
+                outRows[row].Pass |= supportFlags[column] == FormatSupport::PASS ? bit : 0u;
+            }
+        }
+    }
+}
+
+void DriverTimeline::Build(const std::vector<const SupportReport*>& reports)
+{
+    m_formats.clear();
+    m_capabilities.clear();
+    m_versionCount = 0u;
+    m_deltas.clear();
+    m_keyframes.clear();
+    m_keyframeRows.clear();
+
+    // Driver order, the first report of a driver only
+    std::vector<const SupportReport*> versions = reports;
+    std::stable_sort(versions.begin(), versions.end(),
+        [](const SupportReport* a, const SupportReport* b) { return a->Adapter.DriverVersion < b->Adapter.DriverVersion; });
+    versions.erase(std::unique(versions.begin(), versions.end(),
+        [](const SupportReport* a, const SupportReport* b) { return a->Adapter.DriverVersion == b->Adapter.DriverVersion; }), versions.end());
+    if (versions.empty())
+        return;
+
+    m_vendorId = versions.front()->Adapter.VendorId;
+    m_deviceId = versions.front()->Adapter.DeviceId;
+    m_name = versions.back()->Adapter.Name;
+    for (const SupportReport* report : versions)
+    {
+        for (const std::string& capability : report->Capabilities)
+        {
+            if (m_capabilities.size() < DRIVER_TIMELINE_MAX_CAPABILITIES && std::find(m_capabilities.begin(), m_capabilities.end(), capability) == m_capabilities.end())
+                m_capabilities.push_back(capability);
+        }
+        for (const auto& [format, supportFlags] : report->Table)
+            m_formats.push_back(format);
+    }
+    std::sort(m_formats.begin(), m_formats.end());
+    m_formats.erase(std::unique(m_formats.begin(), m_formats.end()), m_formats.end());
+
+    const size_t keyframeBytes = m_formats.size() * sizeof(RowState) + sizeof(Keyframe);
+    std::vector<RowState> rows(m_formats.size(), RowState{});
+    std::vector<RowState> previous(m_formats.size(), RowState{});
+    uint64_t previousDriver = 0u;
+    size_t deltaBytesSinceKeyframe = 0u;
+    for (const SupportReport* report : versions)
+    {
+        GetReportMasks(*report, m_formats, m_capabilities, rows);
+        const uint64_t driver = report->Adapter.DriverVersion;
+        for (size_t row = 0u; row < rows.size(); ++row)
+        {
+            rows[row].Regressed = previous[row].Regressed | (previous[row].EverPass & rows[row].Known & ~rows[row].Pass);
+            rows[row].EverPass = previous[row].EverPass | rows[row].Pass;
+        }
+
+        if (m_versionCount == 0u)
+        {
+            m_keyframes.push_back(Keyframe{ 0u, driver, 0u });
+            m_keyframeRows.insert(m_keyframeRows.end(), rows.begin(), rows.end());
+        }
+        else
+        {
+            const size_t deltaStart = m_deltas.size();
+            PutVarint(m_deltas, driver - previousDriver);
+
+            uint64_t changedRows = 0u;
+            for (size_t row = 0u; row < rows.size(); ++row)
+                changedRows += (rows[row].Pass != previous[row].Pass || rows[row].Known != previous[row].Known) ? 1u : 0u;
+            PutVarint(m_deltas, changedRows);
+
+            size_t nextRow = 0u;
+            for (size_t row = 0u; row < rows.size(); ++row)
+            {
+                if (rows[row].Pass == previous[row].Pass && rows[row].Known == previous[row].Known)
+                    continue;
+
+                PutVarint(m_deltas, row - nextRow);
+                PutVarint(m_deltas, rows[row].Pass ^ previous[row].Pass);
+                PutVarint(m_deltas, rows[row].Known ^ previous[row].Known);
+                nextRow = row + 1u;
+            }
+
+            deltaBytesSinceKeyframe += m_deltas.size() - deltaStart;
+            if (deltaBytesSinceKeyframe >= keyframeBytes)
+            {
+                m_keyframes.push_back(Keyframe{ m_versionCount, driver, m_deltas.size() });
+                m_keyframeRows.insert(m_keyframeRows.end(), rows.begin(), rows.end());
+                deltaBytesSinceKeyframe = 0u;
+            }
+        }
+
+        previous.swap(rows);
+        previousDriver = driver;
+        m_versionCount++;
+    }
+}
+
+size_t DriverTimeline::GetEncodedBytes() const
+{
+    return m_deltas.size() + m_keyframes.size() * sizeof(Keyframe) + m_keyframeRows.size() * sizeof(RowState);
+}
+
+void DriverTimeline::Replay(const std::function<void(const size_t version, const uint64_t driverVersion, const std::vector<RowState>& rows)>& callback) const
+{
+    if (m_versionCount == 0u)
+        return;
+
+    std::vector<RowState> rows;
+    uint64_t driverVersion = 0u;
+    ReplayFrom(0u, m_versionCount - 1u, rows, driverVersion, [&](const size_t version)
+    {
+        callback(version, driverVersion, rows);
+        return false;
+    });
+}
+
+uint64_t DriverTimeline::GetDriverVersion(const size_t version) const
+{
+    std::vector<RowState> rows;
+    uint64_t driverVersion = 0u;
+    if (version < m_versionCount)
+        ReplayFrom(FindKeyframe(version), version, rows, driverVersion, nullptr);
+    return driverVersion;
+}
+
+FormatSupport DriverTimeline::GetSupport(const size_t version, const size_t row, const size_t capability) const
+{
+    if (version >= m_versionCount || row >= m_formats.size() || capability >= m_capabilities.size())
+        return FormatSupport::UNKN;
+
+    std::vector<RowState> rows;
+    uint64_t driverVersion = 0u;
+    ReplayFrom(FindKeyframe(version), version, rows, driverVersion, nullptr);
+
+    const uint64_t bit = 1ull << capability;
+    if (!(rows[row].Known & bit))
+        return FormatSupport::UNKN;
+    return (rows[row].Pass & bit) ? FormatSupport::PASS : FormatSupport::FAIL;
+}
+
+bool DriverTimeline::FindFirstPass(const size_t row, const size_t capability, size_t& outVersion) const
+{
+    return FindFirst(row, capability, false, outVersion);
+}
+
+bool DriverTimeline::FindFirstRegression(const size_t row, const size_t capability, size_t& outVersion) const
+{
+    return FindFirst(row, capability, true, outVersion);
+}
+
+void DriverTimeline::ReplayFrom(const size_t keyframe, const size_t lastVersion, std::vector<RowState>& rows, uint64_t& driverVersion,
+    const std::function<bool(const size_t version)>& callback) const
+{
+    const Keyframe& start = m_keyframes[keyframe];
+    rows.assign(m_keyframeRows.begin() + keyframe * m_formats.size(), m_keyframeRows.begin() + (keyframe + 1u) * m_formats.size());
+    driverVersion = start.DriverVersion;
+    if (callback && callback(start.Version))
+        return;
+
+    // Unchanged rows can't newly regress or pass, so only the changed ones need updating
+    const uint8_t* bytes = m_deltas.data() + start.DeltaOffset;
+    for (size_t version = start.Version + 1u; version <= lastVersion; ++version)
+    {
+        driverVersion += GetVarint(bytes);
+        const uint64_t changedRows = GetVarint(bytes);
+        size_t row = 0u;
+        for (uint64_t change = 0u; change < changedRows; ++change, ++row)
+        {
+            row += static_cast<size_t>(GetVarint(bytes));
+            RowState& state = rows[row];
+            state.Pass ^= GetVarint(bytes);
+            state.Known ^= GetVarint(bytes);
+            state.Regressed |= state.EverPass & state.Known & ~state.Pass;
+            state.EverPass |= state.Pass;
+        }
+
+        if (callback && callback(version))
+            return;
+    }
+}
+
+size_t DriverTimeline::FindKeyframe(const size_t version) const
+{
+    const auto found = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), version,
+        [](const size_t v, const Keyframe& keyframe) { return v < keyframe.Version; });
+    return static_cast<size_t>(found - m_keyframes.begin()) - 1u;
+}
+
+bool DriverTimeline::FindFirst(const size_t row, const size_t capability, const bool regression, size_t& outVersion) const
+{
+    if (m_versionCount == 0u || row >= m_formats.size() || capability >= m_capabilities.size())
+        return false;
+
+    const uint64_t bit = 1ull << capability;
+    const auto isSet = [regression, bit](const RowState& state) { return ((regression ? state.Regressed : state.EverPass) & bit) != 0u; };
+
+    // Both flags only ever get set, so the first keyframe that has it bounds the span to replay
+    size_t low = 0u;
+    size_t high = m_keyframes.size();
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2u;
+        if (isSet(m_keyframeRows[middle * m_formats.size() + row]))
+            high = middle;
+        else
+            low = middle + 1u;
+    }
+    if (low == 0u)
+    {
+        outVersion = 0u;
+        return true;
+    }
+
+    const size_t lastVersion = low < m_keyframes.size() ? m_keyframes[low].Version : m_versionCount - 1u;
+    std::vector<RowState> rows;
+    uint64_t driverVersion = 0u;
+    bool found = false;
+    ReplayFrom(low - 1u, lastVersion, rows, driverVersion, [&](const size_t version)
+    {
+        found = isSet(rows[row]);
+        outVersion = version;
+        return found;
+    });
+    return found;
+}
+
+void DriverTimelineSet::Build(const std::vector<SupportReport>& reports)
+{
+    TRACE_ZONE("DriverTimelineSet::Build");
+    std::map<uint64_t, std::vector<const SupportReport*>> adapters;
+    for (const SupportReport& report : reports)
+        adapters[(static_cast<uint64_t>(report.Adapter.VendorId) << 32u) | report.Adapter.DeviceId].push_back(&report);
+
+    m_timelines.clear();
+    m_timelines.resize(adapters.size());
+    size_t timeline = 0u;
+    for (const auto& [key, adapterReports] : adapters)
+        m_timelines[timeline++].Build(adapterReports);
+}
+
+const DriverTimeline* DriverTimelineSet::Find(const uint32_t vendorId, const uint32_t deviceId) const
+{
+    const auto found = std::lower_bound(m_timelines.begin(), m_timelines.end(), std::make_pair(vendorId, deviceId),
+        [](const DriverTimeline& timeline, const std::pair<uint32_t, uint32_t>& key)
+        {
+            return std::make_pair(timeline.GetVendorId(), timeline.GetDeviceId()) < key;
+        });
+    if (found == m_timelines.end() || found->GetVendorId() != vendorId || found->GetDeviceId() != deviceId)
+        return nullptr;
+    return &*found;
+}
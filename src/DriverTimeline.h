@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "SupportTable.h"
+
+#define DRIVER_TIMELINE_MAX_CAPABILITIES (64u)
+
+// How one adapter's format support changed across driver versions. Versions are kept in
+// driver order, each as a delta against the one before it: the driver version as a varint
+// step, a varint count of the formats whose masks changed, then per changed format a varint
+// row step and the XOR of its PASS and known masks. A driver that changed nothing costs the
+// two varints, a few bytes. Keyframes of the full state are taken whenever the deltas since
+// the last one outgrow a keyframe, so reaching any version replays a bounded amount.
+// Keyframes also carry which cells have ever passed and ever regressed (FAIL after a PASS),
+// both only ever grow along the timeline, so "first driver where X appeared or regressed" is
+// a binary search over the keyframes and one replay of the span it lands in.
+class DriverTimeline
+{
+public:
+    struct RowState
+    {
+        uint64_t Pass;      // Bit per capability
+        uint64_t Known;     // PASS or FAIL, UNKN and missing columns aren't
+        uint64_t EverPass;  // Passed at this version or any earlier one
+        uint64_t Regressed; // Failed at this version or an earlier one after passing before it
+    };
+
+    // Reports of one adapter in any order, one version per driver, the first report given
+    // for a driver wins. The reports are only read during the call.
+    void Build(const std::vector<const SupportReport*>& reports);
+
+    uint32_t GetVendorId() const { return m_vendorId; }
+    uint32_t GetDeviceId() const { return m_deviceId; }
+    const std::string& GetName() const { return m_name; }
+    const std::vector<DXGI_FORMAT>& GetFormats() const { return m_formats; }      // Rows, union of every version's formats in enum order
+    const std::vector<std::string>& GetCapabilities() const { return m_capabilities; } // In first-seen order
+
+    size_t GetVersionCount() const { return m_versionCount; }
+    size_t GetEncodedBytes() const; // Deltas and keyframes
+    size_t GetDeltaBytes() const { return m_deltas.size(); }
+    size_t GetKeyframeCount() const { return m_keyframes.size(); }
+
+    // Every version in driver order with the full state of every row after it
+    void Replay(const std::function<void(const size_t version, const uint64_t driverVersion, const std::vector<RowState>& rows)>& callback) const;
+
+    uint64_t GetDriverVersion(const size_t version) const;
+    FormatSupport GetSupport(const size_t version, const size_t row, const size_t capability) const;
+
+    // First version where the cell passed, or failed after having passed before. False when it never did.
+    bool FindFirstPass(const size_t row, const size_t capability, size_t& outVersion) const;
+    bool FindFirstRegression(const size_t row, const size_t capability, size_t& outVersion) const;
+
+private:
+    struct Keyframe
+    {
+        size_t Version;
+        uint64_t DriverVersion;
+        size_t DeltaOffset; // Where the next version's delta starts
+    };
+
+    // Decodes versions after keyframe up to and including lastVersion, the callback returning true stops early
+    void ReplayFrom(const size_t keyframe, const size_t lastVersion, std::vector<RowState>& rows, uint64_t& driverVersion,
+        const std::function<bool(const size_t version)>& callback) const;
+    size_t FindKeyframe(const size_t version) const; // Last keyframe at or before it
+    bool FindFirst(const size_t row, const size_t capability, const bool regression, size_t& outVersion) const;
+
+    uint32_t m_vendorId = 0u;
+    uint32_t m_deviceId = 0u;
+    std::string m_name;
+    std::vector<DXGI_FORMAT> m_formats;
+    std::vector<std::string> m_capabilities;
+
+    size_t m_versionCount = 0u;
+    std::vector<uint8_t> m_deltas;       // Versions after the first
+    std::vector<Keyframe> m_keyframes;   // The first version is always one
+    std::vector<RowState> m_keyframeRows; // [keyframe][row]
+};
+
+// A timeline per adapter over a set of reports
+class DriverTimelineSet
+{
+public:
+    void Build(const std::vector<SupportReport>& reports);
+
+    // In vendor then device order
+    const std::vector<DriverTimeline>& GetTimelines() const { return m_timelines; }
+    const DriverTimeline* Find(const uint32_t vendorId, const uint32_t deviceId) const;
+
+private:
+    std::vector<DriverTimeline> m_timelines;
+};
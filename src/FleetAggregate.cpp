@@ -0,0 +1,76 @@
+#include "FleetAggregate.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+void FleetAggregate::Build(const std::vector<ReportSource>& sources)
+{
+    TRACE_ZONE("FleetAggregate::Build");
+    m_reportCount = 0u;
+    m_formats.clear();
+    m_capabilities.clear();
+    m_vendorIds.clear();
+
+    // Line up capabilities by name, reports don't have to share the same columns
+    std::unordered_map<std::string, size_t> capabilityIndices;
+    std::vector<std::vector<size_t>> columnToCapability(sources.size());
+    for (size_t report = 0u; report < sources.size(); ++report)
+    {
+        for (const char* capability : sources[report].Capabilities)
+        {
+            const auto inserted = capabilityIndices.emplace(capability, m_capabilities.size());
+            if (inserted.second)
+                m_capabilities.emplace_back(capability);
+
+            columnToCapability[report].push_back(inserted.first->second);
+        }
+
+        for (const auto& [format, supportFlags] : *sources[report].Table)
+            m_formats.push_back(format);
+
+        m_vendorIds.push_back(sources[report].VendorId);
+    }
+
+    std::sort(m_formats.begin(), m_formats.end());
+    m_formats.erase(std::unique(m_formats.begin(), m_formats.end()), m_formats.end());
+    std::sort(m_vendorIds.begin(), m_vendorIds.end());
+    m_vendorIds.erase(std::unique(m_vendorIds.begin(), m_vendorIds.end()), m_vendorIds.end());
+
+    std::unordered_map<DXGI_FORMAT, size_t> rowIndices;
+    for (size_t row = 0u; row < m_formats.size(); ++row)
+        rowIndices[m_formats[row]] = row;
+
+    const size_t cellCount = m_formats.size() * m_capabilities.size();
+    m_cells.assign(cellCount, Cell{ 0u, 0u });
+    m_vendorCells.assign(m_vendorIds.size() * cellCount, Cell{ 0u, 0u });
+    m_vendorReportCounts.assign(m_vendorIds.size(), 0u);
+
+    for (size_t report = 0u; report < sources.size(); ++report)
+    {
+        // Deduplicated reports count once per copy without being walked again
+        const uint32_t weight = sources[report].Weight;
+        const size_t vendor = std::lower_bound(m_vendorIds.begin(), m_vendorIds.end(), sources[report].VendorId) - m_vendorIds.begin();
+        m_vendorReportCounts[vendor] += weight;
+        m_reportCount += weight;
+
+        Cell* vendorCells = &m_vendorCells[vendor * cellCount];
+        for (const auto& [format, supportFlags] : *sources[report].Table)
+        {
+            const size_t rowOffset = rowIndices[format] * m_capabilities.size();
+            const size_t columns = std::min(supportFlags.size(), columnToCapability[report].size());
+            for (size_t column = 0u; column < columns; ++column)
+            {
+                if (supportFlags[column] == FormatSupport::UNKN)
+                    continue;
+
+                const uint32_t pass = (supportFlags[column] == FormatSupport::PASS) ? weight : 0u;
+                const size_t cell = rowOffset + columnToCapability[report][column];
+                m_cells[cell].Pass += pass;
+                m_cells[cell].Known += weight;
+                vendorCells[cell].Pass += pass;
+                vendorCells[cell].Known += weight;
+            }
+        }
+    }
+}
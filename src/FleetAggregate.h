@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SupportTable.h"
+
+// Pass counts over a set of reports ("the fleet"), per format and capability, with the same
+// counts split by adapter vendor. Built once whenever the set of reports changes, so views
+// only ever read these dense arrays and never walk the reports themselves. A source's Weight
+// counts it that many times.
+class FleetAggregate
+{
+public:
+    struct Cell
+    {
+        uint32_t Pass;  // Reports where the capability passed
+        uint32_t Known; // Reports that answered PASS or FAIL, UNKN and missing columns don't count
+    };
+
+    void Build(const std::vector<ReportSource>& sources);
+
+    size_t GetReportCount() const { return m_reportCount; } // Sum of the source weights
+    const std::vector<DXGI_FORMAT>& GetFormats() const { return m_formats; }
+    const std::vector<std::string>& GetCapabilities() const { return m_capabilities; }
+
+    const Cell& GetCell(const size_t row, const size_t capability) const
+    {
+        return m_cells[row * m_capabilities.size() + capability];
+    }
+
+    // Fraction of the reports that know about this cell which pass it, negative when none do
+    float GetCoverage(const size_t row, const size_t capability) const
+    {
+        const Cell& cell = GetCell(row, capability);
+        return cell.Known ? static_cast<float>(cell.Pass) / static_cast<float>(cell.Known) : -1.0f;
+    }
+
+    // Vendors in ascending id order
+    size_t GetVendorCount() const { return m_vendorIds.size(); }
+    uint32_t GetVendorId(const size_t vendor) const { return m_vendorIds[vendor]; }
+    uint32_t GetVendorReportCount(const size_t vendor) const { return m_vendorReportCounts[vendor]; }
+    const Cell& GetVendorCell(const size_t vendor, const size_t row, const size_t capability) const
+    {
+        return m_vendorCells[(vendor * m_formats.size() + row) * m_capabilities.size() + capability];
+    }
+
+private:
+    size_t m_reportCount = 0u;
+    std::vector<DXGI_FORMAT> m_formats;      // Union of every report's formats, in enum order
+    std::vector<std::string> m_capabilities; // Union of every report's capabilities, in first-seen order
+    std::vector<Cell> m_cells;               // [format][capability]
+
+    std::vector<uint32_t> m_vendorIds;
+    std::vector<uint32_t> m_vendorReportCounts;
+    std::vector<Cell> m_vendorCells;         // [vendor][format][capability]
+};
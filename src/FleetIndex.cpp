@@ -0,0 +1,461 @@
+#include "FleetIndex.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+#include "Utils.h"
+
+#define MACHINE_SET_BITMAP_WORDS (65536u / 64u)
+
+static uint32_t CountBits(const uint64_t word)
+{
+    return static_cast<uint32_t>(std::bitset<64>(word).count());
+}
+
+void MachineSet::Add(const uint32_t id)
+{
+    const uint16_t key = static_cast<uint16_t>(id >> 16u);
+    const uint16_t low = static_cast<uint16_t>(id & 0xFFFFu);
+
+    // Ids usually arrive in increasing order, so the last chunk is the one to check first
+    auto chunk = m_chunks.end();
+    if (!m_chunks.empty() && m_chunks.back().Key == key)
+        chunk = std::prev(m_chunks.end());
+    else if (m_chunks.empty() || m_chunks.back().Key < key)
+        chunk = m_chunks.insert(m_chunks.end(), Chunk{ key, 0u, {}, {} });
+    else
+    {
+        chunk = std::lower_bound(m_chunks.begin(), m_chunks.end(), key, [](const Chunk& c, const uint16_t k) { return c.Key < k; });
+        if (chunk == m_chunks.end() || chunk->Key != key)
+            chunk = m_chunks.insert(chunk, Chunk{ key, 0u, {}, {} });
+    }
+
+    if (chunk->IsBitmap())
+    {
+        uint64_t& word = chunk->Bitmap[low >> 6u];
+        const uint64_t bit = 1ull << (low & 63u);
+        if (!(word & bit))
+        {
+            word |= bit;
+            chunk->Count++;
+        }
+        return;
+    }
+
+    if (chunk->Array.empty() || chunk->Array.back() < low)
+    {
+        chunk->Array.push_back(low);
+    }
+    else
+    {
+        const auto found = std::lower_bound(chunk->Array.begin(), chunk->Array.end(), low);
+        if (*found == low)
+            return;
+        chunk->Array.insert(found, low);
+    }
+
+    chunk->Count++;
+    if (chunk->Count > MACHINE_SET_MAX_ARRAY_SIZE)
+        ToBitmap(*chunk);
+}
+
+bool MachineSet::Contains(const uint32_t id) const
+{
+    const uint16_t key = static_cast<uint16_t>(id >> 16u);
+    const uint16_t low = static_cast<uint16_t>(id & 0xFFFFu);
+    const auto chunk = std::lower_bound(m_chunks.begin(), m_chunks.end(), key, [](const Chunk& c, const uint16_t k) { return c.Key < k; });
+    if (chunk == m_chunks.end() || chunk->Key != key)
+        return false;
+
+    if (chunk->IsBitmap())
+        return ((chunk->Bitmap[low >> 6u] >> (low & 63u)) & 1u) != 0u;
+    return std::binary_search(chunk->Array.begin(), chunk->Array.end(), low);
+}
+
+uint64_t MachineSet::GetCount() const
+{
+    uint64_t count = 0u;
+    for (const Chunk& chunk : m_chunks)
+        count += chunk.Count;
+    return count;
+}
+
+size_t MachineSet::GetMemoryBytes() const
+{
+    size_t bytes = m_chunks.capacity() * sizeof(Chunk);
+    for (const Chunk& chunk : m_chunks)
+        bytes += chunk.Array.capacity() * sizeof(uint16_t) + chunk.Bitmap.capacity() * sizeof(uint64_t);
+    return bytes;
+}
+
+std::vector<uint32_t> MachineSet::ToVector() const
+{
+    std::vector<uint32_t> ids;
+    ids.reserve(static_cast<size_t>(GetCount()));
+    for (const Chunk& chunk : m_chunks)
+    {
+        const uint32_t high = static_cast<uint32_t>(chunk.Key) << 16u;
+        if (!chunk.IsBitmap())
+        {
+            for (const uint16_t low : chunk.Array)
+                ids.push_back(high | low);
+            continue;
+        }
+
+        for (uint32_t word = 0u; word < MACHINE_SET_BITMAP_WORDS; ++word)
+        {
+            for (uint64_t bits = chunk.Bitmap[word]; bits != 0u; bits &= bits - 1u)
+                ids.push_back(high | (word * 64u + CountBits((bits & (~bits + 1u)) - 1u)));
+        }
+    }
+    return ids;
+}
+
+MachineSet MachineSet::Range(const uint32_t count)
+{
+    MachineSet set;
+    for (uint32_t first = 0u; first < count; first += 65536u)
+    {
+        const uint32_t chunkCount = std::min(count - first, 65536u);
+        Chunk chunk{ static_cast<uint16_t>(first >> 16u), chunkCount, {}, {} };
+        if (chunkCount <= MACHINE_SET_MAX_ARRAY_SIZE)
+        {
+            chunk.Array.resize(chunkCount);
+            for (uint32_t low = 0u; low < chunkCount; ++low)
+                chunk.Array[low] = static_cast<uint16_t>(low);
+        }
+        else
+        {
+            chunk.Bitmap.assign(MACHINE_SET_BITMAP_WORDS, 0u);
+            std::fill(chunk.Bitmap.begin(), chunk.Bitmap.begin() + chunkCount / 64u, ~0ull);
+            if (chunkCount % 64u)
+                chunk.Bitmap[chunkCount / 64u] = (1ull << (chunkCount % 64u)) - 1u;
+        }
+        set.m_chunks.push_back(std::move(chunk));
+    }
+    return set;
+}
+
+MachineSet MachineSet::And(const MachineSet& a, const MachineSet& b)
+{
+    return Combine(a, b, Operation::And);
+}
+
+MachineSet MachineSet::Or(const MachineSet& a, const MachineSet& b)
+{
+    return Combine(a, b, Operation::Or);
+}
+
+MachineSet MachineSet::AndNot(const MachineSet& a, const MachineSet& b)
+{
+    return Combine(a, b, Operation::AndNot);
+}
+
+MachineSet MachineSet::Combine(const MachineSet& a, const MachineSet& b, const Operation operation)
+{
+    // Walk both chunk lists by key, a chunk only one side has is kept or dropped as a whole
+    MachineSet result;
+    auto chunkA = a.m_chunks.begin();
+    auto chunkB = b.m_chunks.begin();
+    while (chunkA != a.m_chunks.end() || chunkB != b.m_chunks.end())
+    {
+        if (chunkB == b.m_chunks.end() || (chunkA != a.m_chunks.end() && chunkA->Key < chunkB->Key))
+        {
+            if (operation != Operation::And)
+                result.m_chunks.push_back(*chunkA);
+            ++chunkA;
+        }
+        else if (chunkA == a.m_chunks.end() || chunkB->Key < chunkA->Key)
+        {
+            if (operation == Operation::Or)
+                result.m_chunks.push_back(*chunkB);
+            ++chunkB;
+        }
+        else
+        {
+            Chunk chunk{ chunkA->Key, 0u, {}, {} };
+            if (CombineChunks(*chunkA, *chunkB, operation, chunk))
+                result.m_chunks.push_back(std::move(chunk));
+            ++chunkA;
+            ++chunkB;
+        }
+    }
+    return result;
+}
+
+bool MachineSet::CombineChunks(const Chunk& a, const Chunk& b, const Operation operation, Chunk& outChunk)
+{
+    if (!a.IsBitmap() && !b.IsBitmap())
+    {
+        auto out = std::back_inserter(outChunk.Array);
+        switch (operation)
+        {
+        case Operation::And:    std::set_intersection(a.Array.begin(), a.Array.end(), b.Array.begin(), b.Array.end(), out); break;
+        case Operation::Or:     std::set_union(a.Array.begin(), a.Array.end(), b.Array.begin(), b.Array.end(), out); break;
+        case Operation::AndNot: std::set_difference(a.Array.begin(), a.Array.end(), b.Array.begin(), b.Array.end(), out); break;
+        }
+        outChunk.Count = static_cast<uint32_t>(outChunk.Array.size());
+        if (outChunk.Count > MACHINE_SET_MAX_ARRAY_SIZE)
+            ToBitmap(outChunk);
+        return outChunk.Count != 0u;
+    }
+
+    // A sparse side filtered against a bitmap stays sparse
+    const auto testBit = [](const Chunk& bitmap, const uint16_t low) { return ((bitmap.Bitmap[low >> 6u] >> (low & 63u)) & 1u) != 0u; };
+    if (operation != Operation::Or && !a.IsBitmap())
+    {
+        const bool keepIfSet = operation == Operation::And;
+        std::copy_if(a.Array.begin(), a.Array.end(), std::back_inserter(outChunk.Array),
+            [&](const uint16_t low) { return testBit(b, low) == keepIfSet; });
+        outChunk.Count = static_cast<uint32_t>(outChunk.Array.size());
+        return outChunk.Count != 0u;
+    }
+    if (operation == Operation::And && !b.IsBitmap())
+    {
+        std::copy_if(b.Array.begin(), b.Array.end(), std::back_inserter(outChunk.Array), [&](const uint16_t low) { return testBit(a, low); });
+        outChunk.Count = static_cast<uint32_t>(outChunk.Array.size());
+        return outChunk.Count != 0u;
+    }
+
+    Chunk bitmapA = a;
+    Chunk bitmapB = b;
+    ToBitmap(bitmapA);
+    ToBitmap(bitmapB);
+    outChunk.Bitmap.resize(MACHINE_SET_BITMAP_WORDS);
+    for (uint32_t word = 0u; word < MACHINE_SET_BITMAP_WORDS; ++word)
+    {
+        switch (operation)
+        {
+        case Operation::And:    outChunk.Bitmap[word] = bitmapA.Bitmap[word] & bitmapB.Bitmap[word]; break;
+        case Operation::Or:     outChunk.Bitmap[word] = bitmapA.Bitmap[word] | bitmapB.Bitmap[word]; break;
+        case Operation::AndNot: outChunk.Bitmap[word] = bitmapA.Bitmap[word] & ~bitmapB.Bitmap[word]; break;
+        }
+        outChunk.Count += CountBits(outChunk.Bitmap[word]);
+    }
+    Shrink(outChunk);
+    return outChunk.Count != 0u;
+}
+
+void MachineSet::ToBitmap(Chunk& chunk)
+{
+    if (chunk.IsBitmap())
+        return;
+
+    chunk.Bitmap.assign(MACHINE_SET_BITMAP_WORDS, 0u);
+    for (const uint16_t low : chunk.Array)
+        chunk.Bitmap[low >> 6u] |= 1ull << (low & 63u);
+    chunk.Array = {};
+}
+
+void MachineSet::Shrink(Chunk& chunk)
+{
+    if (!chunk.IsBitmap() || chunk.Count > MACHINE_SET_MAX_ARRAY_SIZE)
+        return;
+
+    chunk.Array.reserve(chunk.Count);
+    for (uint32_t word = 0u; word < MACHINE_SET_BITMAP_WORDS; ++word)
+    {
+        for (uint64_t bits = chunk.Bitmap[word]; bits != 0u; bits &= bits - 1u)
+            chunk.Array.push_back(static_cast<uint16_t>(word * 64u + CountBits((bits & (~bits + 1u)) - 1u)));
+    }
+    chunk.Bitmap = {};
+}
+
+void FleetIndex::Reset()
+{
+    m_capabilities.clear();
+    m_names.clear();
+    m_weights.clear();
+    m_weighted = false;
+    m_all = MachineSet{};
+    m_postings.clear();
+}
+
+uint32_t FleetIndex::AddReport(const ReportSource& source)
+{
+    const uint32_t id = GetMachineCount();
+    m_names.emplace_back(source.Name);
+    m_weights.push_back(source.Weight);
+    m_weighted |= source.Weight != 1u;
+    m_all.Add(id);
+
+    std::vector<size_t> columnToCapability(source.Capabilities.size(), FLEET_INDEX_MAX_CAPABILITIES);
+    for (size_t column = 0u; column < source.Capabilities.size(); ++column)
+    {
+        const auto found = std::find(m_capabilities.begin(), m_capabilities.end(), source.Capabilities[column]);
+        if (found != m_capabilities.end())
+        {
+            columnToCapability[column] = found - m_capabilities.begin();
+        }
+        else if (m_capabilities.size() < FLEET_INDEX_MAX_CAPABILITIES)
+        {
+            columnToCapability[column] = m_capabilities.size();
+            m_capabilities.emplace_back(source.Capabilities[column]);
+        }
+    }
+
+    for (const auto& [format, supportFlags] : *source.Table)
+    {
+        const size_t columns = std::min(supportFlags.size(), columnToCapability.size());
+        for (size_t column = 0u; column < columns; ++column)
+        {
+            if (supportFlags[column] == FormatSupport::PASS && columnToCapability[column] < FLEET_INDEX_MAX_CAPABILITIES)
+                m_postings[GetPostingKey(format, columnToCapability[column])].Add(id);
+        }
+    }
+    return id;
+}
+
+uint64_t FleetIndex::GetWeightedCount(const MachineSet& machines) const
+{
+    if (!m_weighted)
+        return machines.GetCount();
+
+    uint64_t count = 0u;
+    for (const uint32_t id : machines.ToVector())
+        count += m_weights[id];
+    return count;
+}
+
+size_t FleetIndex::GetMemoryBytes() const
+{
+    size_t bytes = m_all.GetMemoryBytes();
+    for (const auto& [key, machines] : m_postings)
+        bytes += sizeof(key) + machines.GetMemoryBytes();
+    return bytes;
+}
+
+const MachineSet& FleetIndex::GetSupporting(const DXGI_FORMAT format, const size_t capability) const
+{
+    static const MachineSet none;
+    const auto found = m_postings.find(GetPostingKey(format, capability));
+    return found != m_postings.end() ? found->second : none;
+}
+
+MachineSet FleetIndex::GetLacking(const DXGI_FORMAT format, const size_t capability) const
+{
+    return MachineSet::AndNot(m_all, GetSupporting(format, capability));
+}
+
+// Recursive descent over: or := and ('|' and)*, and := unary ('&' unary)*, unary := '!' unary | '(' or ')' | term
+class FleetIndex::QueryParser
+{
+public:
+    QueryParser(const FleetIndex& index, const std::string& expression)
+        : m_index(index)
+        , m_expression(expression)
+    {
+    }
+
+    bool Parse(MachineSet& outMachines, std::string& outError)
+    {
+        outMachines = ParseOr();
+        SkipSpaces();
+        if (m_error.empty() && m_position != m_expression.size())
+            m_error = "Unexpected '" + m_expression.substr(m_position, 1) + "'";
+
+        outError = m_error;
+        return m_error.empty();
+    }
+
+private:
+    void SkipSpaces()
+    {
+        while (m_position < m_expression.size() && m_expression[m_position] == ' ')
+            m_position++;
+    }
+
+    bool Accept(const char c)
+    {
+        SkipSpaces();
+        if (m_position < m_expression.size() && m_expression[m_position] == c)
+        {
+            m_position++;
+            return true;
+        }
+        return false;
+    }
+
+    MachineSet ParseOr()
+    {
+        MachineSet machines = ParseAnd();
+        while (m_error.empty() && Accept('|'))
+            machines = MachineSet::Or(machines, ParseAnd());
+        return machines;
+    }
+
+    MachineSet ParseAnd()
+    {
+        MachineSet machines = ParseUnary();
+        while (m_error.empty() && Accept('&'))
+            machines = MachineSet::And(machines, ParseUnary());
+        return machines;
+    }
+
+    MachineSet ParseUnary()
+    {
+        if (Accept('!'))
+            return MachineSet::AndNot(m_index.m_all, ParseUnary());
+
+        if (Accept('('))
+        {
+            MachineSet machines = ParseOr();
+            if (m_error.empty() && !Accept(')'))
+                m_error = "Missing ')'";
+            return machines;
+        }
+
+        return ParseTerm();
+    }
+
+    MachineSet ParseTerm()
+    {
+        SkipSpaces();
+        const size_t start = m_position;
+        while (m_position < m_expression.size() && std::string("&|!()").find(m_expression[m_position]) == std::string::npos)
+            m_position++;
+
+        std::string term = m_expression.substr(start, m_position - start);
+        term.erase(term.find_last_not_of(' ') + 1u);
+        const size_t separator = term.find(':');
+        if (separator == std::string::npos)
+        {
+            m_error = term.empty() ? "Expected a term" : "Expected FORMAT:Capability, got '" + term + "'";
+            return MachineSet{};
+        }
+
+        std::string formatName = term.substr(0u, separator);
+        std::string capabilityName = term.substr(separator + 1u);
+        formatName.erase(formatName.find_last_not_of(' ') + 1u);
+        capabilityName.erase(0u, capabilityName.find_first_not_of(' '));
+        if (formatName.compare(0u, 12u, "DXGI_FORMAT_") != 0)
+            formatName = "DXGI_FORMAT_" + formatName;
+
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        if (!D3DFormatFromString(formatName, format))
+        {
+            m_error = "Unknown format '" + formatName + "'";
+            return MachineSet{};
+        }
+
+        const auto capability = std::find(m_index.m_capabilities.begin(), m_index.m_capabilities.end(), capabilityName);
+        if (capability == m_index.m_capabilities.end())
+        {
+            m_error = "Unknown capability '" + capabilityName + "'";
+            return MachineSet{};
+        }
+
+        return m_index.GetSupporting(format, capability - m_index.m_capabilities.begin());
+    }
+
+    const FleetIndex& m_index;
+    const std::string& m_expression;
+    size_t m_position = 0u;
+    std::string m_error;
+};
+
+bool FleetIndex::Query(const std::string& expression, MachineSet& outMachines, std::string& outError) const
+{
+    return QueryParser(*this, expression).Parse(outMachines, outError);
+}
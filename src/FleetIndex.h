@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FormatInfo.h"
+#include "SupportTable.h"
+
+#define FLEET_INDEX_MAX_CAPABILITIES (64u)
+#define MACHINE_SET_MAX_ARRAY_SIZE (4096u)
+
+// Sorted set of machine ids, roaring style: ids are split by their high 16 bits into chunks
+// which hold the low 16 bits as a sorted array while sparse and as a 65536-bit bitmap once
+// there are more than MACHINE_SET_MAX_ARRAY_SIZE of them, so neither a few ids nor nearly
+// all of them cost much. Ids added in increasing order are appended without a search.
+class MachineSet
+{
+public:
+    void Add(const uint32_t id);
+    bool Contains(const uint32_t id) const;
+
+    bool IsEmpty() const { return m_chunks.empty(); }
+    uint64_t GetCount() const;
+    size_t GetMemoryBytes() const;
+    std::vector<uint32_t> ToVector() const;
+
+    // Every id in [0, count)
+    static MachineSet Range(const uint32_t count);
+
+    static MachineSet And(const MachineSet& a, const MachineSet& b);
+    static MachineSet Or(const MachineSet& a, const MachineSet& b);
+    static MachineSet AndNot(const MachineSet& a, const MachineSet& b);
+
+private:
+    struct Chunk
+    {
+        uint16_t Key;                // High 16 bits of the ids
+        uint32_t Count;
+        std::vector<uint16_t> Array; // Sorted low halves, or empty when the bitmap is in use
+        std::vector<uint64_t> Bitmap;
+
+        bool IsBitmap() const { return !Bitmap.empty(); }
+    };
+
+    enum class Operation { And, Or, AndNot };
+
+    static MachineSet Combine(const MachineSet& a, const MachineSet& b, const Operation operation);
+    static bool CombineChunks(const Chunk& a, const Chunk& b, const Operation operation, Chunk& outChunk);
+    static void ToBitmap(Chunk& chunk);
+    static void Shrink(Chunk& chunk); // Back to an array once sparse again
+
+    std::vector<Chunk> m_chunks; // In ascending key order, never empty ones
+};
+
+// Inverted index from (format, capability) to the machines that PASS it, for "who can't do X"
+// questions over a whole fleet. Every report added is one machine id, in the order added, so
+// the posting lists only ever grow at the end and new reports fold in without a rebuild.
+// A source's Weight is kept per machine for the weighted counts.
+class FleetIndex
+{
+public:
+    void Reset();
+
+    // The new machine's id
+    uint32_t AddReport(const ReportSource& source);
+
+    uint32_t GetMachineCount() const { return static_cast<uint32_t>(m_names.size()); }
+    const std::string& GetMachineName(const uint32_t id) const { return m_names[id]; }
+    uint64_t GetWeightedCount(const MachineSet& machines) const; // Sum of the machines' weights
+    const std::vector<std::string>& GetCapabilities() const { return m_capabilities; }
+    size_t GetMemoryBytes() const;
+
+    const MachineSet& GetAll() const { return m_all; }
+    const MachineSet& GetSupporting(const DXGI_FORMAT format, const size_t capability) const;
+    MachineSet GetLacking(const DXGI_FORMAT format, const size_t capability) const;
+
+    // Boolean query over "FORMAT:Capability" terms with '!', '&', '|' and parentheses,
+    // e.g. "!R11G11B10_FLOAT:Render Target | (BC7_UNORM:Texture2D & !BC6H_UF16:Texture2D)".
+    // A term is the machines where it passed, the DXGI_FORMAT_ prefix is optional.
+    bool Query(const std::string& expression, MachineSet& outMachines, std::string& outError) const;
+
+private:
+    class QueryParser;
+
+    static uint32_t GetPostingKey(const DXGI_FORMAT format, const size_t capability)
+    {
+        return static_cast<uint32_t>(format) * FLEET_INDEX_MAX_CAPABILITIES + static_cast<uint32_t>(capability);
+    }
+
+    std::vector<std::string> m_capabilities; // In first-seen order
+    std::vector<std::string> m_names;        // [machine]
+    std::vector<uint32_t> m_weights;         // [machine]
+    bool m_weighted = false;                 // Any weight other than 1
+    MachineSet m_all;
+    std::unordered_map<uint32_t, MachineSet> m_postings; // [format][capability], PASS only
+};
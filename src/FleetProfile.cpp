@@ -0,0 +1,148 @@
+#include "FleetProfile.h"
+
+#include <algorithm>
+#include <cmath>
+
+void FleetProfileBuilder::Reset()
+{
+    m_reportCount = 0u;
+    m_capabilities.clear();
+    m_seenFormats.reset();
+    m_intersection = {};
+    m_countPlanes.clear();
+}
+
+void FleetProfileBuilder::AddReport(const ReportSource& source)
+{
+    const uint64_t weight = source.Weight;
+    if (weight == 0u)
+        return;
+
+    // Pack the report's PASS cells, one mask per known capability
+    m_reportMasks.assign(m_capabilities.size(), FormatMask{});
+    std::vector<size_t> columnToCapability(source.Capabilities.size(), FLEET_PROFILE_MAX_CAPABILITIES);
+    for (size_t column = 0u; column < source.Capabilities.size(); ++column)
+    {
+        const auto found = std::find(m_capabilities.begin(), m_capabilities.end(), source.Capabilities[column]);
+        if (found != m_capabilities.end())
+        {
+            columnToCapability[column] = found - m_capabilities.begin();
+        }
+        else if (m_capabilities.size() < FLEET_PROFILE_MAX_CAPABILITIES)
+        {
+            // Nothing before this report passed it
+            columnToCapability[column] = m_capabilities.size();
+            m_intersection[m_capabilities.size()] = m_reportCount == 0u ? FormatMask{}.set() : FormatMask{};
+            m_capabilities.emplace_back(source.Capabilities[column]);
+            m_reportMasks.emplace_back();
+        }
+    }
+
+    for (const auto& [format, supportFlags] : *source.Table)
+    {
+        if (static_cast<size_t>(format) >= FORMAT_INFO_MAX_FORMATS)
+            continue;
+
+        m_seenFormats.set(format);
+        const size_t columns = std::min(supportFlags.size(), columnToCapability.size());
+        for (size_t column = 0u; column < columns; ++column)
+        {
+            if (supportFlags[column] == FormatSupport::PASS && columnToCapability[column] < FLEET_PROFILE_MAX_CAPABILITIES)
+                m_reportMasks[columnToCapability[column]].set(format);
+        }
+    }
+
+    m_reportCount += weight;
+    size_t planeCount = m_countPlanes.size() / FLEET_PROFILE_MAX_CAPABILITIES;
+    while (planeCount < 64u && (m_reportCount >> planeCount) != 0u)
+        planeCount++;
+    m_countPlanes.resize(planeCount * FLEET_PROFILE_MAX_CAPABILITIES);
+
+    for (size_t capability = 0u; capability < m_capabilities.size(); ++capability)
+    {
+        const FormatMask& passed = m_reportMasks[capability];
+        m_intersection[capability] &= passed;
+        if (passed.none())
+            continue;
+
+        // Ripple-carry add of weight x passed into the bit-sliced counters, one weight bit at a time
+        for (size_t weightBit = 0u; weightBit < 64u && (weight >> weightBit) != 0u; ++weightBit)
+        {
+            if (!((weight >> weightBit) & 1u))
+                continue;
+
+            FormatMask carry = passed;
+            for (size_t plane = weightBit; carry.any() && plane < planeCount; ++plane)
+            {
+                FormatMask& counter = m_countPlanes[plane * FLEET_PROFILE_MAX_CAPABILITIES + capability];
+                const FormatMask nextCarry = counter & carry;
+                counter ^= carry;
+                carry = nextCarry;
+            }
+        }
+    }
+}
+
+uint64_t FleetProfileBuilder::GetThresholdCount(const double fraction) const
+{
+    const double count = std::ceil(fraction * static_cast<double>(m_reportCount) - 1e-9);
+    return std::max<uint64_t>(1u, std::min(m_reportCount, static_cast<uint64_t>(std::max(0.0, count))));
+}
+
+FormatMask FleetProfileBuilder::BuildMask(const size_t capability, const uint64_t minReports) const
+{
+    if (capability >= m_capabilities.size())
+        return FormatMask{};
+    if (minReports == m_reportCount)
+        return m_intersection[capability];
+
+    const size_t planeCount = m_countPlanes.size() / FLEET_PROFILE_MAX_CAPABILITIES;
+    if (planeCount < 64u && (minReports >> planeCount) != 0u)
+        return FormatMask{};
+
+    // count >= minReports for every format at once, comparing planes from the most significant down
+    FormatMask greater;
+    FormatMask equal = FormatMask{}.set();
+    for (size_t plane = planeCount; plane-- > 0u;)
+    {
+        const FormatMask& counter = GetPlane(plane, capability);
+        if ((minReports >> plane) & 1u)
+        {
+            equal &= counter;
+        }
+        else
+        {
+            greater |= equal & counter;
+            equal &= ~counter;
+        }
+    }
+    return (greater | equal) & m_seenFormats;
+}
+
+uint32_t FleetProfileBuilder::CountFormats(const size_t capability, const uint64_t minReports) const
+{
+    return static_cast<uint32_t>(BuildMask(capability, minReports).count());
+}
+
+void FleetProfileBuilder::BuildReport(const uint64_t minReports, const char* name, SupportReport& outReport) const
+{
+    outReport = SupportReport{};
+    outReport.Adapter.Name = name;
+    outReport.Capabilities = m_capabilities;
+
+    std::vector<FormatMask> masks(m_capabilities.size());
+    for (size_t capability = 0u; capability < m_capabilities.size(); ++capability)
+        masks[capability] = BuildMask(capability, minReports);
+
+    for (size_t format = 0u; format < FORMAT_INFO_MAX_FORMATS; ++format)
+    {
+        if (!m_seenFormats[format])
+            continue;
+
+        std::vector<FormatSupport> supportFlags(m_capabilities.size());
+        for (size_t capability = 0u; capability < m_capabilities.size(); ++capability)
+            supportFlags[capability] = masks[capability][format] ? FormatSupport::PASS : FormatSupport::FAIL;
+
+        outReport.Table[static_cast<DXGI_FORMAT>(format)] = std::move(supportFlags);
+    }
+}
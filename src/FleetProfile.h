@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FormatInfo.h"
+#include "SupportTable.h"
+
+#define FLEET_PROFILE_MAX_CAPABILITIES (64u)
+
+// Folds reports one at a time into packed per-capability format masks, so any number of reports
+// can be streamed through in a fixed amount of memory. The intersection is a running AND. For the
+// k-of-n profiles every capability keeps a bit-sliced pass counter, plane i holding bit i of the
+// count of every format, so adding a report is a few mask AND/XORs and memory only grows with
+// log2 of the number of reports. Thresholds are a bitwise compare against those planes.
+// Capabilities are lined up by name in first-seen order, PASS is the only thing that counts.
+class FleetProfileBuilder
+{
+public:
+    void Reset();
+
+    // Counted source.Weight times
+    void AddReport(const ReportSource& source);
+
+    uint64_t GetReportCount() const { return m_reportCount; }
+    const std::vector<std::string>& GetCapabilities() const { return m_capabilities; }
+
+    // Reports a format has to pass on to be in a profile covering fraction of the fleet, at least one
+    uint64_t GetThresholdCount(const double fraction) const;
+
+    // Formats passing capability on at least minReports reports, the intersection when minReports is the report count
+    FormatMask BuildMask(const size_t capability, const uint64_t minReports) const;
+    uint32_t CountFormats(const size_t capability, const uint64_t minReports) const;
+
+    // The profile as an ordinary report, PASS or FAIL for every format any report had
+    void BuildReport(const uint64_t minReports, const char* name, SupportReport& outReport) const;
+
+private:
+    const FormatMask& GetPlane(const size_t plane, const size_t capability) const
+    {
+        return m_countPlanes[plane * FLEET_PROFILE_MAX_CAPABILITIES + capability];
+    }
+
+    uint64_t m_reportCount = 0u;
+    std::vector<std::string> m_capabilities;
+    FormatMask m_seenFormats{};                                              // Formats any report had
+    std::array<FormatMask, FLEET_PROFILE_MAX_CAPABILITIES> m_intersection{}; // Formats every report passed
+    std::vector<FormatMask> m_countPlanes;                                   // [plane][capability], bit-sliced pass counts
+
+    std::vector<FormatMask> m_reportMasks; // Scratch for the report being added
+};
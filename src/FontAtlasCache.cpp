@@ -0,0 +1,260 @@
+#include "FontAtlasCache.h"
+#include "MappedFile.h"
+#include "ReportStore.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#define FONT_ATLAS_GLYPH_BYTES (40u) // Codepoint, then advance, X0, Y0, X1, Y1, U0, V0, U1, V1
+
+namespace
+{
+    // What the file depends on besides the caller's key: a different ImGui may lay glyphs out differently
+    Hash128 HashCacheKey(const std::string& key)
+    {
+        std::string full = key;
+        full += "|imgui " + std::to_string(IMGUI_VERSION_NUM) + " wchar " + std::to_string(sizeof(ImWchar))
+            + " lines " + std::to_string(IM_DRAWLIST_TEX_LINES_WIDTH_MAX);
+        return HashBytes128(full.data(), full.size(), FONT_ATLAS_CACHE_MAGIC);
+    }
+
+    // The cache never leaves the machine that wrote it, so values are copied in host order
+    class CacheWriter
+    {
+    public:
+        explicit CacheWriter(std::vector<uint8_t>& bytes) : m_bytes(bytes) {}
+
+        template <typename T>
+        void Put(const T& value) { PutBytes(&value, sizeof(T)); }
+        void PutBytes(const void* data, const size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            m_bytes.insert(m_bytes.end(), bytes, bytes + size);
+        }
+
+    private:
+        std::vector<uint8_t>& m_bytes;
+    };
+
+    class CacheReader
+    {
+    public:
+        CacheReader(const uint8_t* bytes, const size_t size) : m_bytes(bytes), m_size(size) {}
+
+        template <typename T>
+        bool Get(T& value) { return GetBytes(&value, sizeof(T)); }
+        bool GetBytes(void* data, const size_t size)
+        {
+            if (m_size - m_offset < size)
+                return false;
+
+            std::memcpy(data, m_bytes + m_offset, size);
+            m_offset += size;
+            return true;
+        }
+        const uint8_t* Skip(const size_t size)
+        {
+            if (m_size - m_offset < size)
+                return nullptr;
+
+            const uint8_t* data = m_bytes + m_offset;
+            m_offset += size;
+            return data;
+        }
+        size_t GetOffset() const { return m_offset; }
+
+    private:
+        const uint8_t* m_bytes;
+        size_t m_size;
+        size_t m_offset = 0u;
+    };
+
+    bool ReadAtlas(CacheReader& reader, const Hash128& key, ImFontAtlas& atlas)
+    {
+        uint32_t magic = 0u;
+        uint32_t version = 0u;
+        Hash128 fileKey{};
+        if (!reader.Get(magic) || magic != FONT_ATLAS_CACHE_MAGIC || !reader.Get(version) || version != FONT_ATLAS_CACHE_VERSION
+            || !reader.Get(fileKey.Low) || !reader.Get(fileKey.High) || !(fileKey == key))
+            return false;
+
+        int32_t width = 0;
+        int32_t height = 0;
+        uint32_t customRectCount = 0u;
+        uint32_t fontCount = 0u;
+        if (!reader.Get(width) || !reader.Get(height) || width <= 0 || height <= 0 || !reader.Get(atlas.TexUvScale) || !reader.Get(atlas.TexUvWhitePixel)
+            || !reader.GetBytes(atlas.TexUvLines, sizeof(atlas.TexUvLines)) || !reader.Get(atlas.PackIdMouseCursors) || !reader.Get(atlas.PackIdLines)
+            || !reader.Get(customRectCount) || !reader.Get(fontCount) || fontCount == 0u)
+            return false;
+
+        for (uint32_t i = 0u; i < customRectCount; ++i)
+        {
+            ImFontAtlasCustomRect rect;
+            if (!reader.Get(rect.Width) || !reader.Get(rect.Height) || !reader.Get(rect.X) || !reader.Get(rect.Y) || !reader.Get(rect.GlyphID)
+                || !reader.Get(rect.GlyphAdvanceX) || !reader.Get(rect.GlyphOffset))
+                return false;
+            atlas.CustomRects.push_back(rect);
+        }
+
+        // Configs first, fonts point into the vector
+        struct FontHeader
+        {
+            float Ascent;
+            float Descent;
+            uint32_t GlyphCount;
+            const uint8_t* Glyphs;
+        };
+        std::vector<FontHeader> fonts(fontCount);
+        for (FontHeader& font : fonts)
+        {
+            ImFontConfig config;
+            config.FontDataOwnedByAtlas = false;
+            if (!reader.GetBytes(config.Name, sizeof(config.Name)) || !reader.Get(config.SizePixels) || !reader.Get(font.Ascent)
+                || !reader.Get(font.Descent) || !reader.Get(font.GlyphCount))
+                return false;
+
+            font.Glyphs = reader.Skip(static_cast<size_t>(font.GlyphCount) * FONT_ATLAS_GLYPH_BYTES);
+            if (!font.Glyphs)
+                return false;
+
+            config.Name[sizeof(config.Name) - 1u] = '\0';
+            atlas.ConfigData.push_back(config);
+        }
+
+        const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+        const uint8_t* pixels = reader.Skip(pixelCount);
+        if (!pixels)
+            return false;
+
+        atlas.TexWidth = width;
+        atlas.TexHeight = height;
+        for (uint32_t i = 0u; i < fontCount; ++i)
+        {
+            ImFont* font = IM_NEW(ImFont);
+            atlas.Fonts.push_back(font);
+            font->ContainerAtlas = &atlas;
+            font->ConfigData = &atlas.ConfigData[static_cast<int>(i)];
+            font->ConfigDataCount = 1;
+            font->FontSize = atlas.ConfigData[static_cast<int>(i)].SizePixels;
+            font->Ascent = fonts[i].Ascent;
+            font->Descent = fonts[i].Descent;
+
+            const uint8_t* glyphsEnd = fonts[i].Glyphs + static_cast<size_t>(fonts[i].GlyphCount) * FONT_ATLAS_GLYPH_BYTES;
+            for (const uint8_t* glyph = fonts[i].Glyphs; glyph != glyphsEnd; glyph += FONT_ATLAS_GLYPH_BYTES)
+            {
+                uint32_t codepoint = 0u;
+                float values[9];
+                std::memcpy(&codepoint, glyph, sizeof(codepoint));
+                std::memcpy(values, glyph + 4u, sizeof(values));
+                font->AddGlyph(nullptr, static_cast<ImWchar>(codepoint), values[1], values[2], values[3], values[4], values[5], values[6], values[7], values[8], values[0]);
+            }
+            font->BuildLookupTable();
+        }
+
+        atlas.TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixelCount));
+        std::memcpy(atlas.TexPixelsAlpha8, pixels, pixelCount);
+        atlas.TexReady = true;
+        return true;
+    }
+}
+
+bool LoadFontAtlasCache(const std::filesystem::path& path, const std::string& key, ImFontAtlas& outAtlas)
+{
+    MappedFile file;
+    if (!file.Open(path) || file.GetSize() < sizeof(uint64_t))
+        return false;
+
+    // A checksum of everything before it, a torn write would otherwise draw garbage
+    const size_t payloadSize = file.GetSize() - sizeof(uint64_t);
+    uint64_t checksum = 0u;
+    std::memcpy(&checksum, file.GetData() + payloadSize, sizeof(checksum));
+    if (HashBytes128(file.GetData(), payloadSize).Low != checksum)
+        return false;
+
+    CacheReader reader(file.GetData(), payloadSize);
+    outAtlas.Clear();
+    if (!ReadAtlas(reader, HashCacheKey(key), outAtlas) || reader.GetOffset() != payloadSize)
+    {
+        outAtlas.Clear();
+        return false;
+    }
+    return true;
+}
+
+bool SaveFontAtlasCache(const std::filesystem::path& path, const std::string& key, const ImFontAtlas& atlas)
+{
+    if (!atlas.IsBuilt() || !atlas.TexPixelsAlpha8 || atlas.Fonts.Size != atlas.ConfigData.Size)
+        return false;
+
+    std::vector<uint8_t> bytes;
+    CacheWriter writer(bytes);
+    const Hash128 cacheKey = HashCacheKey(key);
+    writer.Put(static_cast<uint32_t>(FONT_ATLAS_CACHE_MAGIC));
+    writer.Put(static_cast<uint32_t>(FONT_ATLAS_CACHE_VERSION));
+    writer.Put(cacheKey.Low);
+    writer.Put(cacheKey.High);
+    writer.Put(static_cast<int32_t>(atlas.TexWidth));
+    writer.Put(static_cast<int32_t>(atlas.TexHeight));
+    writer.Put(atlas.TexUvScale);
+    writer.Put(atlas.TexUvWhitePixel);
+    writer.PutBytes(atlas.TexUvLines, sizeof(atlas.TexUvLines));
+    writer.Put(atlas.PackIdMouseCursors);
+    writer.Put(atlas.PackIdLines);
+    writer.Put(static_cast<uint32_t>(atlas.CustomRects.Size));
+    writer.Put(static_cast<uint32_t>(atlas.Fonts.Size));
+
+    for (const ImFontAtlasCustomRect& rect : atlas.CustomRects)
+    {
+        if (rect.Font)
+            return false;
+
+        writer.Put(rect.Width);
+        writer.Put(rect.Height);
+        writer.Put(rect.X);
+        writer.Put(rect.Y);
+        writer.Put(rect.GlyphID);
+        writer.Put(rect.GlyphAdvanceX);
+        writer.Put(rect.GlyphOffset);
+    }
+
+    for (const ImFont* font : atlas.Fonts)
+    {
+        // Merged fonts have several configs, the glyphs are what matters but the name and size come from the first
+        if (!font->ConfigData)
+            return false;
+
+        writer.PutBytes(font->ConfigData->Name, sizeof(font->ConfigData->Name));
+        writer.Put(font->FontSize);
+        writer.Put(font->Ascent);
+        writer.Put(font->Descent);
+        writer.Put(static_cast<uint32_t>(font->Glyphs.Size));
+        for (const ImFontGlyph& glyph : font->Glyphs)
+        {
+            const uint32_t codepoint = glyph.Codepoint;
+            const float values[9] = { glyph.AdvanceX, glyph.X0, glyph.Y0, glyph.X1, glyph.Y1, glyph.U0, glyph.V0, glyph.U1, glyph.V1 };
+            writer.Put(codepoint);
+            writer.PutBytes(values, sizeof(values));
+        }
+    }
+
+    writer.PutBytes(atlas.TexPixelsAlpha8, static_cast<size_t>(atlas.TexWidth) * static_cast<size_t>(atlas.TexHeight));
+    writer.Put(HashBytes128(bytes.data(), bytes.size()).Low);
+
+    // Written aside and moved over, so a reader never maps a half-written file
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream outFile(tempPath, std::ios::trunc | std::ios::out | std::ios::binary);
+        if (!outFile.is_open() || !outFile.good())
+            return false;
+
+        outFile.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!outFile.good())
+            return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    return !error;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <filesystem>
+#include <string>
+
+#include "../ImGui/imgui.h"
+
+#define FONT_ATLAS_CACHE_MAGIC (0x46534644u) // "DFSF"
+#define FONT_ATLAS_CACHE_VERSION (1u)
+
+// A built ImFontAtlas saved to disk: the alpha pixels, the glyph tables of every font and the
+// custom rects, so later starts skip TrueType rasterization and rect packing. The file is one
+// memory map read straight into the atlas. Files are only used by the build that wrote them:
+// the key covers the ImGui version and layout, plus what the caller says decides the bake, i.e.
+// font, size, glyph ranges and anything it draws into custom rects.
+//
+// A loaded atlas can't be rebuilt, it has no TrueType data, and fonts with glyphs in custom
+// rects (ImFontAtlasCustomRect::Font) aren't supported.
+
+// False, leaving the atlas empty, when there is no file for this key or it doesn't check out
+bool LoadFontAtlasCache(const std::filesystem::path& path, const std::string& key, ImFontAtlas& outAtlas);
+
+// The atlas must be built and not have been converted to RGBA only
+bool SaveFontAtlasCache(const std::filesystem::path& path, const std::string& key, const ImFontAtlas& atlas);
@@ -0,0 +1,162 @@
+#include "FormatInfo.h"
+
+#include <array>
+#include <cstddef>
+
+namespace
+{
+    struct FormatInfoEntry
+    {
+        DXGI_FORMAT Format;
+        FormatInfo Info;
+    };
+
+    using N = FormatNumeric;
+
+    constexpr uint8_t NONE = FormatInfoFlags_None;
+    constexpr uint8_t DEPTH = FormatInfoFlags_Depth;
+    constexpr uint8_t DS = FormatInfoFlags_Depth | FormatInfoFlags_Stencil;
+    constexpr uint8_t STENCIL = FormatInfoFlags_Stencil;
+    constexpr uint8_t BC = FormatInfoFlags_BlockCompressed;
+    constexpr uint8_t VIDEO = FormatInfoFlags_Video;
+    constexpr uint8_t PALETTE = FormatInfoFlags_Palette;
+
+    // Format, { Channels, ChannelBits, Numeric, Flags, BlockWidth, BlockHeight, BytesPerBlock, PlaneCount }
+    constexpr FormatInfoEntry s_formatInfos[] =
+    {
+        { DXGI_FORMAT_R32G32B32A32_TYPELESS,         { 4, 32, N::Typeless, NONE,    1, 1, 16, 1 } },
+        { DXGI_FORMAT_R32G32B32A32_FLOAT,            { 4, 32, N::Float,    NONE,    1, 1, 16, 1 } },
+        { DXGI_FORMAT_R32G32B32A32_UINT,             { 4, 32, N::UInt,     NONE,    1, 1, 16, 1 } },
+        { DXGI_FORMAT_R32G32B32A32_SINT,             { 4, 32, N::SInt,     NONE,    1, 1, 16, 1 } },
+        { DXGI_FORMAT_R32G32B32_TYPELESS,            { 3, 32, N::Typeless, NONE,    1, 1, 12, 1 } },
+        { DXGI_FORMAT_R32G32B32_FLOAT,               { 3, 32, N::Float,    NONE,    1, 1, 12, 1 } },
+        { DXGI_FORMAT_R32G32B32_UINT,                { 3, 32, N::UInt,     NONE,    1, 1, 12, 1 } },
+        { DXGI_FORMAT_R32G32B32_SINT,                { 3, 32, N::SInt,     NONE,    1, 1, 12, 1 } },
+        { DXGI_FORMAT_R16G16B16A16_TYPELESS,         { 4, 16, N::Typeless, NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R16G16B16A16_FLOAT,            { 4, 16, N::Float,    NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R16G16B16A16_UNORM,            { 4, 16, N::UNorm,    NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R16G16B16A16_UINT,             { 4, 16, N::UInt,     NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R16G16B16A16_SNORM,            { 4, 16, N::SNorm,    NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R16G16B16A16_SINT,             { 4, 16, N::SInt,     NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R32G32_TYPELESS,               { 2, 32, N::Typeless, NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R32G32_FLOAT,                  { 2, 32, N::Float,    NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R32G32_UINT,                   { 2, 32, N::UInt,     NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R32G32_SINT,                   { 2, 32, N::SInt,     NONE,    1, 1, 8,  1 } },
+        { DXGI_FORMAT_R32G8X24_TYPELESS,             { 2, 32, N::Typeless, NONE,    1, 1, 8,  2 } },
+        { DXGI_FORMAT_D32_FLOAT_S8X24_UINT,          { 2, 32, N::Float,    DS,      1, 1, 8,  2 } },
+        { DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS,      { 1, 32, N::Float,    NONE,    1, 1, 8,  2 } },
+        { DXGI_FORMAT_X32_TYPELESS_G8X24_UINT,       { 1, 8,  N::UInt,     STENCIL, 1, 1, 8,  2 } },
+        { DXGI_FORMAT_R10G10B10A2_TYPELESS,          { 4, 10, N::Typeless, NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R10G10B10A2_UNORM,             { 4, 10, N::UNorm,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R10G10B10A2_UINT,              { 4, 10, N::UInt,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R11G11B10_FLOAT,               { 3, 11, N::Float,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R8G8B8A8_TYPELESS,             { 4, 8,  N::Typeless, NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,                { 4, 8,  N::UNorm,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,           { 4, 8,  N::SRGB,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R8G8B8A8_UINT,                 { 4, 8,  N::UInt,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R8G8B8A8_SNORM,                { 4, 8,  N::SNorm,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R8G8B8A8_SINT,                 { 4, 8,  N::SInt,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R16G16_TYPELESS,               { 2, 16, N::Typeless, NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R16G16_FLOAT,                  { 2, 16, N::Float,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R16G16_UNORM,                  { 2, 16, N::UNorm,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R16G16_UINT,                   { 2, 16, N::UInt,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R16G16_SNORM,                  { 2, 16, N::SNorm,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R16G16_SINT,                   { 2, 16, N::SInt,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R32_TYPELESS,                  { 1, 32, N::Typeless, NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_D32_FLOAT,                     { 1, 32, N::Float,    DEPTH,   1, 1, 4,  1 } },
+        { DXGI_FORMAT_R32_FLOAT,                     { 1, 32, N::Float,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R32_UINT,                      { 1, 32, N::UInt,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R32_SINT,                      { 1, 32, N::SInt,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R24G8_TYPELESS,                { 2, 24, N::Typeless, NONE,    1, 1, 4,  2 } },
+        { DXGI_FORMAT_D24_UNORM_S8_UINT,             { 2, 24, N::UNorm,    DS,      1, 1, 4,  2 } },
+        { DXGI_FORMAT_R24_UNORM_X8_TYPELESS,         { 1, 24, N::UNorm,    NONE,    1, 1, 4,  2 } },
+        { DXGI_FORMAT_X24_TYPELESS_G8_UINT,          { 1, 8,  N::UInt,     STENCIL, 1, 1, 4,  2 } },
+        { DXGI_FORMAT_R8G8_TYPELESS,                 { 2, 8,  N::Typeless, NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R8G8_UNORM,                    { 2, 8,  N::UNorm,    NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R8G8_UINT,                     { 2, 8,  N::UInt,     NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R8G8_SNORM,                    { 2, 8,  N::SNorm,    NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R8G8_SINT,                     { 2, 8,  N::SInt,     NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R16_TYPELESS,                  { 1, 16, N::Typeless, NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R16_FLOAT,                     { 1, 16, N::Float,    NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_D16_UNORM,                     { 1, 16, N::UNorm,    DEPTH,   1, 1, 2,  1 } },
+        { DXGI_FORMAT_R16_UNORM,                     { 1, 16, N::UNorm,    NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R16_UINT,                      { 1, 16, N::UInt,     NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R16_SNORM,                     { 1, 16, N::SNorm,    NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R16_SINT,                      { 1, 16, N::SInt,     NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_R8_TYPELESS,                   { 1, 8,  N::Typeless, NONE,    1, 1, 1,  1 } },
+        { DXGI_FORMAT_R8_UNORM,                      { 1, 8,  N::UNorm,    NONE,    1, 1, 1,  1 } },
+        { DXGI_FORMAT_R8_UINT,                       { 1, 8,  N::UInt,     NONE,    1, 1, 1,  1 } },
+        { DXGI_FORMAT_R8_SNORM,                      { 1, 8,  N::SNorm,    NONE,    1, 1, 1,  1 } },
+        { DXGI_FORMAT_R8_SINT,                       { 1, 8,  N::SInt,     NONE,    1, 1, 1,  1 } },
+        { DXGI_FORMAT_A8_UNORM,                      { 1, 8,  N::UNorm,    NONE,    1, 1, 1,  1 } },
+        { DXGI_FORMAT_R1_UNORM,                      { 1, 1,  N::UNorm,    NONE,    8, 1, 1,  1 } },
+        { DXGI_FORMAT_R9G9B9E5_SHAREDEXP,            { 3, 14, N::Float,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R8G8_B8G8_UNORM,               { 3, 8,  N::UNorm,    NONE,    2, 1, 4,  1 } },
+        { DXGI_FORMAT_G8R8_G8B8_UNORM,               { 3, 8,  N::UNorm,    NONE,    2, 1, 4,  1 } },
+        { DXGI_FORMAT_BC1_TYPELESS,                  { 4, 8,  N::Typeless, BC,      4, 4, 8,  1 } },
+        { DXGI_FORMAT_BC1_UNORM,                     { 4, 8,  N::UNorm,    BC,      4, 4, 8,  1 } },
+        { DXGI_FORMAT_BC1_UNORM_SRGB,                { 4, 8,  N::SRGB,     BC,      4, 4, 8,  1 } },
+        { DXGI_FORMAT_BC2_TYPELESS,                  { 4, 8,  N::Typeless, BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC2_UNORM,                     { 4, 8,  N::UNorm,    BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC2_UNORM_SRGB,                { 4, 8,  N::SRGB,     BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC3_TYPELESS,                  { 4, 8,  N::Typeless, BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC3_UNORM,                     { 4, 8,  N::UNorm,    BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC3_UNORM_SRGB,                { 4, 8,  N::SRGB,     BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC4_TYPELESS,                  { 1, 8,  N::Typeless, BC,      4, 4, 8,  1 } },
+        { DXGI_FORMAT_BC4_UNORM,                     { 1, 8,  N::UNorm,    BC,      4, 4, 8,  1 } },
+        { DXGI_FORMAT_BC4_SNORM,                     { 1, 8,  N::SNorm,    BC,      4, 4, 8,  1 } },
+        { DXGI_FORMAT_BC5_TYPELESS,                  { 2, 8,  N::Typeless, BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC5_UNORM,                     { 2, 8,  N::UNorm,    BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC5_SNORM,                     { 2, 8,  N::SNorm,    BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_B5G6R5_UNORM,                  { 3, 6,  N::UNorm,    NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_B5G5R5A1_UNORM,                { 4, 5,  N::UNorm,    NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,                { 4, 8,  N::UNorm,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_B8G8R8X8_UNORM,                { 3, 8,  N::UNorm,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM,    { 4, 10, N::UNorm,    NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_B8G8R8A8_TYPELESS,             { 4, 8,  N::Typeless, NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,           { 4, 8,  N::SRGB,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_B8G8R8X8_TYPELESS,             { 3, 8,  N::Typeless, NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,           { 3, 8,  N::SRGB,     NONE,    1, 1, 4,  1 } },
+        { DXGI_FORMAT_BC6H_TYPELESS,                 { 3, 16, N::Typeless, BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC6H_UF16,                     { 3, 16, N::Float,    BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC6H_SF16,                     { 3, 16, N::Float,    BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC7_TYPELESS,                  { 4, 8,  N::Typeless, BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC7_UNORM,                     { 4, 8,  N::UNorm,    BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_BC7_UNORM_SRGB,                { 4, 8,  N::SRGB,     BC,      4, 4, 16, 1 } },
+        { DXGI_FORMAT_AYUV,                          { 4, 8,  N::UNorm,    VIDEO,   1, 1, 4,  1 } },
+        { DXGI_FORMAT_Y410,                          { 4, 10, N::UNorm,    VIDEO,   1, 1, 4,  1 } },
+        { DXGI_FORMAT_Y416,                          { 4, 16, N::UNorm,    VIDEO,   1, 1, 8,  1 } },
+        { DXGI_FORMAT_NV12,                          { 3, 8,  N::UNorm,    VIDEO,   1, 1, 1,  2 } },
+        { DXGI_FORMAT_P010,                          { 3, 10, N::UNorm,    VIDEO,   1, 1, 2,  2 } },
+        { DXGI_FORMAT_P016,                          { 3, 16, N::UNorm,    VIDEO,   1, 1, 2,  2 } },
+        { DXGI_FORMAT_420_OPAQUE,                    { 3, 8,  N::UNorm,    VIDEO,   1, 1, 1,  2 } },
+        { DXGI_FORMAT_YUY2,                          { 3, 8,  N::UNorm,    VIDEO,   2, 1, 4,  1 } },
+        { DXGI_FORMAT_Y210,                          { 3, 10, N::UNorm,    VIDEO,   2, 1, 8,  1 } },
+        { DXGI_FORMAT_Y216,                          { 3, 16, N::UNorm,    VIDEO,   2, 1, 8,  1 } },
+        { DXGI_FORMAT_NV11,                          { 3, 8,  N::UNorm,    VIDEO,   1, 1, 1,  2 } },
+        { DXGI_FORMAT_AI44,                          { 2, 4,  N::UNorm,    PALETTE, 1, 1, 1,  1 } },
+        { DXGI_FORMAT_IA44,                          { 2, 4,  N::UNorm,    PALETTE, 1, 1, 1,  1 } },
+        { DXGI_FORMAT_P8,                            { 1, 8,  N::UNorm,    PALETTE, 1, 1, 1,  1 } },
+        { DXGI_FORMAT_A8P8,                          { 2, 8,  N::UNorm,    PALETTE, 1, 1, 2,  1 } },
+        { DXGI_FORMAT_B4G4R4A4_UNORM,                { 4, 4,  N::UNorm,    NONE,    1, 1, 2,  1 } },
+        { DXGI_FORMAT_P208,                          { 3, 8,  N::UNorm,    VIDEO,   1, 1, 1,  2 } },
+        { DXGI_FORMAT_V208,                          { 3, 8,  N::UNorm,    VIDEO,   1, 1, 1,  3 } },
+        { DXGI_FORMAT_V408,                          { 3, 8,  N::UNorm,    VIDEO,   1, 1, 1,  3 } },
+    };
+
+    std::array<FormatInfo, FORMAT_INFO_MAX_FORMATS> BuildFormatInfoLookup()
+    {
+        std::array<FormatInfo, FORMAT_INFO_MAX_FORMATS> lookup{};
+        for (const FormatInfoEntry& entry : s_formatInfos)
+            lookup[entry.Format] = entry.Info;
+        return lookup;
+    }
+}
+
+const FormatInfo& GetFormatInfo(const DXGI_FORMAT format)
+{
+    static const std::array<FormatInfo, FORMAT_INFO_MAX_FORMATS> lookup = BuildFormatInfoLookup();
+    static const FormatInfo unknown{};
+
+    return static_cast<size_t>(format) < FORMAT_INFO_MAX_FORMATS ? lookup[format] : unknown;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+#include <dxgiformat.h>
+
+// Upper bound (exclusive) of DXGI_FORMAT values with metadata
+#define FORMAT_INFO_MAX_FORMATS (256)
+
+// One bit per DXGI_FORMAT
+using FormatMask = std::bitset<FORMAT_INFO_MAX_FORMATS>;
+
+enum class FormatNumeric : uint8_t
+{
+    Unknown,
+    Typeless,
+    UNorm,
+    SRGB,
+    SNorm,
+    UInt,
+    SInt,
+    Float,
+};
+
+enum FormatInfoFlags : uint8_t
+{
+    FormatInfoFlags_None            = 0,
+    FormatInfoFlags_Depth           = 1 << 0,
+    FormatInfoFlags_Stencil         = 1 << 1,
+    FormatInfoFlags_BlockCompressed = 1 << 2,
+    FormatInfoFlags_Video           = 1 << 3, // YUV layouts, only meaningful to video and media code
+    FormatInfoFlags_Palette         = 1 << 4,
+};
+
+// Static layout of a DXGI format, as documented for the format.
+// Elements are BlockWidth x BlockHeight texels, e.g. 4x4 for BC and 2x1 for packed 4:2:2.
+struct FormatInfo
+{
+    uint8_t Channels;      // 0 for DXGI_FORMAT_UNKNOWN and formats without metadata
+    uint8_t ChannelBits;   // Widest channel
+    FormatNumeric Numeric;
+    uint8_t Flags;         // FormatInfoFlags
+    uint8_t BlockWidth;
+    uint8_t BlockHeight;
+    uint8_t BytesPerBlock; // Of plane 0 for planar formats
+    uint8_t PlaneCount;    // Depth/stencil formats have a plane each in D3D12
+};
+
+const FormatInfo& GetFormatInfo(const DXGI_FORMAT format);
+
+inline bool IsBlockCompressed(const DXGI_FORMAT format) { return (GetFormatInfo(format).Flags & FormatInfoFlags_BlockCompressed) != 0; }
+inline bool IsDepthFormat(const DXGI_FORMAT format) { return (GetFormatInfo(format).Flags & FormatInfoFlags_Depth) != 0; }
+
+// Bits of storage per texel of plane 0, fractional for block compressed formats
+inline float GetBitsPerTexel(const DXGI_FORMAT format)
+{
+    const FormatInfo& info = GetFormatInfo(format);
+    return info.BlockWidth ? (info.BytesPerBlock * 8.0f) / (info.BlockWidth * info.BlockHeight) : 0.0f;
+}
@@ -0,0 +1,198 @@
+#include "FormatResolver.h"
+
+#include <algorithm>
+#include <array>
+
+static_assert(FORMAT_INFO_MAX_FORMATS <= 256, "Resolved formats are stored as bytes");
+
+namespace
+{
+    // What a format of the depth family is used as. Their planes hold depth and stencil, so one only
+    // stands in for another with the same role and plane layout, never for or by a colour format.
+    enum class DepthRole
+    {
+        None,     // Colour
+        Depth,    // DSV, with or without stencil
+        Stencil,  // Stencil plane SRV, e.g. X24_TYPELESS_G8_UINT
+        DepthSRV, // Depth plane SRV, e.g. R24_UNORM_X8_TYPELESS
+        Typeless, // The resource of a depth buffer that is also read, e.g. R24G8_TYPELESS
+    };
+
+    DepthRole GetDepthRole(const FormatInfo& info)
+    {
+        if (info.Flags & FormatInfoFlags_Depth)
+            return DepthRole::Depth;
+        if (info.PlaneCount <= 1u)
+            return DepthRole::None;
+        if (info.Flags & FormatInfoFlags_Stencil)
+            return DepthRole::Stencil;
+        return info.Numeric == FormatNumeric::Typeless ? DepthRole::Typeless : DepthRole::DepthSRV;
+    }
+
+    bool IsNormalisedOrFloat(const FormatNumeric numeric)
+    {
+        return numeric == FormatNumeric::UNorm || numeric == FormatNumeric::SRGB || numeric == FormatNumeric::SNorm || numeric == FormatNumeric::Float;
+    }
+
+    // Cost of creating candidate instead of desired, lower is better, negative when it can't stand in at all
+    int FallbackCost(const DXGI_FORMAT desired, const DXGI_FORMAT candidate)
+    {
+        const FormatInfo& want = GetFormatInfo(desired);
+        const FormatInfo& have = GetFormatInfo(candidate);
+        if (have.Channels == 0u || have.Channels < want.Channels)
+            return -1;
+
+        // Video, palette and odd single purpose layouts only ever stand in for themselves
+        constexpr uint8_t exclusiveFlags = FormatInfoFlags_Video | FormatInfoFlags_Palette;
+        if ((want.Flags | have.Flags) & exclusiveFlags)
+            return -1;
+        if (candidate == DXGI_FORMAT_A8_UNORM || candidate == DXGI_FORMAT_R1_UNORM)
+            return -1;
+        if (!(have.Flags & FormatInfoFlags_BlockCompressed) && have.BlockWidth > 1u)
+            return -1;
+
+        // Depth needs depth, stencil needs stencil. Colour formats don't fall back to depth or its plane views.
+        const DepthRole role = GetDepthRole(want);
+        if (role != GetDepthRole(have))
+            return -1;
+        if (role != DepthRole::None && have.PlaneCount != want.PlaneCount)
+            return -1;
+        // Only to a wider layout, so a resource and its views (R24G8 and R24_X8, X24_G8) fall back together
+        if (role != DepthRole::None && GetBitsPerTexel(candidate) < GetBitsPerTexel(desired))
+            return -1;
+        if ((want.Flags & FormatInfoFlags_Stencil) && !(have.Flags & FormatInfoFlags_Stencil))
+            return -1;
+
+        // Compressed data can be decompressed on load, but nothing can be written into BC
+        const bool wantBC = (want.Flags & FormatInfoFlags_BlockCompressed) != 0;
+        const bool haveBC = (have.Flags & FormatInfoFlags_BlockCompressed) != 0;
+        if (!wantBC && haveBC)
+            return -1;
+
+        int cost = 0;
+        if (want.Numeric != have.Numeric)
+        {
+            // Integer and typeless data must keep its exact type, a shader reads it bit for bit
+            if (!IsNormalisedOrFloat(want.Numeric) || !IsNormalisedOrFloat(have.Numeric))
+                return -1;
+
+            switch (want.Numeric)
+            {
+            case FormatNumeric::UNorm:
+                if (have.Numeric != FormatNumeric::Float)
+                    return -1;
+                cost += 50;
+                break;
+            case FormatNumeric::SNorm:
+                if (have.Numeric != FormatNumeric::Float)
+                    return -1;
+                cost += 50;
+                break;
+            case FormatNumeric::SRGB:
+                if (have.Numeric == FormatNumeric::SNorm)
+                    return -1;
+                cost += 400; // Gamma has to be handled in the shader from now on
+                break;
+            default: // Float can't squeeze into a normalised range
+                return -1;
+            }
+        }
+
+        // Losing precision is a last resort, and never acceptable for integers
+        if (have.ChannelBits < want.ChannelBits)
+        {
+            if (want.Numeric == FormatNumeric::UInt || want.Numeric == FormatNumeric::SInt)
+                return -1;
+            cost += 1000 * (want.ChannelBits - have.ChannelBits);
+        }
+
+        // Past that prefer the closest layout, then the smallest footprint. A smaller BC block means a lossier codec.
+        if (haveBC && GetBitsPerTexel(candidate) < GetBitsPerTexel(desired))
+            cost += 200;
+        cost += 20 * (have.Channels - want.Channels);
+        cost += std::max(0, static_cast<int>(have.ChannelBits) - static_cast<int>(want.ChannelBits));
+        cost += std::max(0, static_cast<int>(GetBitsPerTexel(candidate) - GetBitsPerTexel(desired)));
+        return cost;
+    }
+
+    std::vector<DXGI_FORMAT> BuildFallbackChain(const DXGI_FORMAT desired)
+    {
+        std::vector<DXGI_FORMAT> chain{ desired };
+        if (GetFormatInfo(desired).Channels == 0u)
+            return chain;
+
+        std::vector<std::pair<int, DXGI_FORMAT>> candidates;
+        for (uint32_t i = 1u; i < FORMAT_INFO_MAX_FORMATS; ++i)
+        {
+            const DXGI_FORMAT candidate = static_cast<DXGI_FORMAT>(i);
+            if (candidate == desired)
+                continue;
+
+            const int cost = FallbackCost(desired, candidate);
+            if (cost >= 0)
+                candidates.emplace_back(cost, candidate);
+        }
+
+        // Ties go to enum order so the chains never change between runs
+        std::sort(candidates.begin(), candidates.end());
+        for (const auto& [cost, candidate] : candidates)
+            chain.push_back(candidate);
+
+        return chain;
+    }
+}
+
+FormatResolver::FormatResolver()
+    : m_resolved(FORMAT_INFO_MAX_FORMATS * FORMAT_USAGE_COMBINATIONS, static_cast<uint8_t>(DXGI_FORMAT_UNKNOWN))
+{
+}
+
+const std::vector<DXGI_FORMAT>& FormatResolver::GetFallbackChain(const DXGI_FORMAT desired)
+{
+    static const std::vector<std::vector<DXGI_FORMAT>> chains = []()
+    {
+        std::vector<std::vector<DXGI_FORMAT>> allChains(FORMAT_INFO_MAX_FORMATS);
+        for (uint32_t i = 0u; i < FORMAT_INFO_MAX_FORMATS; ++i)
+            allChains[i] = BuildFallbackChain(static_cast<DXGI_FORMAT>(i));
+        return allChains;
+    }();
+    static const std::vector<DXGI_FORMAT> empty;
+
+    return static_cast<size_t>(desired) < FORMAT_INFO_MAX_FORMATS ? chains[desired] : empty;
+}
+
+void FormatResolver::Build(const SupportTable& table)
+{
+    // Usage bits each format passes on this adapter
+    std::array<uint32_t, FORMAT_INFO_MAX_FORMATS> supportedUsage{};
+    for (const auto& [format, supportFlags] : table)
+    {
+        if (static_cast<size_t>(format) >= FORMAT_INFO_MAX_FORMATS)
+            continue;
+
+        const size_t columns = std::min(supportFlags.size(), static_cast<size_t>(SUPPORT_FLAGS_COUNT));
+        for (size_t column = 0u; column < columns; ++column)
+        {
+            if (supportFlags[column] == FormatSupport::PASS)
+                supportedUsage[format] |= 1u << column;
+        }
+    }
+
+    for (uint32_t desired = 0u; desired < FORMAT_INFO_MAX_FORMATS; ++desired)
+    {
+        const std::vector<DXGI_FORMAT>& chain = GetFallbackChain(static_cast<DXGI_FORMAT>(desired));
+        uint8_t* resolved = &m_resolved[desired * FORMAT_USAGE_COMBINATIONS];
+        for (uint32_t usage = 0u; usage < FORMAT_USAGE_COMBINATIONS; ++usage)
+        {
+            resolved[usage] = static_cast<uint8_t>(DXGI_FORMAT_UNKNOWN);
+            for (const DXGI_FORMAT candidate : chain)
+            {
+                if ((supportedUsage[candidate] & usage) == usage)
+                {
+                    resolved[usage] = static_cast<uint8_t>(candidate);
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "FormatInfo.h"
+#include "SupportTable.h"
+
+// Number of distinct FormatUsageFlags combinations
+#define FORMAT_USAGE_COMBINATIONS (1u << SUPPORT_FLAGS_COUNT)
+
+// Answers "I want this format for these usages, what should I create instead?" for one adapter.
+// Every format has a fallback chain ranked from its metadata: same numeric class and at least
+// the same channels and precision, cheapest in memory first. Depth/stencil formats, their typeless
+// resources and plane views only fall back to the same role and plane layout. Build() walks the
+// chains once for every format and usage combination against the adapter's support table, so
+// Resolve() is a single load from a dense 64 KB table and is fine on hot resource creation paths.
+class FormatResolver
+{
+public:
+    FormatResolver();
+
+    void Build(const SupportTable& table);
+
+    // Best format the adapter supports for all usage bits, desired itself when it's supported,
+    // DXGI_FORMAT_UNKNOWN when nothing in its chain is
+    DXGI_FORMAT Resolve(const DXGI_FORMAT desired, const uint32_t usage) const
+    {
+        if (static_cast<size_t>(desired) >= FORMAT_INFO_MAX_FORMATS || usage >= FORMAT_USAGE_COMBINATIONS)
+            return DXGI_FORMAT_UNKNOWN;
+
+        return static_cast<DXGI_FORMAT>(m_resolved[static_cast<size_t>(desired) * FORMAT_USAGE_COMBINATIONS + usage]);
+    }
+
+    // Candidates for desired, best first and starting with desired itself. Doesn't depend on the adapter.
+    static const std::vector<DXGI_FORMAT>& GetFallbackChain(const DXGI_FORMAT desired);
+
+private:
+    std::vector<uint8_t> m_resolved; // [format][usage]
+};
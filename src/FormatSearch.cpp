@@ -0,0 +1,97 @@
+#include "FormatSearch.h"
+#include "Utils.h"
+
+#include <cctype>
+#include <cstring>
+
+FormatSearchIndex::FormatSearchIndex()
+{
+    m_prefixMasks.emplace_back(); // Empty until Build() is called
+}
+
+void FormatSearchIndex::Build()
+{
+    m_grams.clear();
+    m_names.clear();
+    m_names.resize(FORMAT_SEARCH_MAX_FORMATS);
+    m_allFormats.reset();
+
+    for (size_t i = 0u; i < FORMAT_SEARCH_MAX_FORMATS; ++i)
+    {
+        const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(i);
+        const char* name = D3DFormatToString(format);
+        if (format != DXGI_FORMAT_UNKNOWN && std::strcmp(name, "Unknown format") == 0)
+            continue;
+
+        m_names[i] = name;
+        m_allFormats.set(i);
+
+        const std::string& indexedName = m_names[i];
+        for (size_t start = 0u; start < indexedName.size(); ++start)
+        {
+            for (size_t length = 1u; length <= 3u && start + length <= indexedName.size(); ++length)
+            {
+                m_grams[PackGram(&indexedName[start], length)].set(i);
+            }
+        }
+    }
+
+    m_query.clear();
+    m_prefixMasks.clear();
+    m_prefixMasks.push_back(m_allFormats);
+}
+
+bool FormatSearchIndex::SetQuery(const char* query)
+{
+    // Keep the cached masks for the prefix the new query shares with the old one
+    size_t shared = 0u;
+    while (shared < m_query.size() && query[shared] != '\0'
+        && static_cast<char>(std::toupper(static_cast<unsigned char>(query[shared]))) == m_query[shared])
+    {
+        ++shared;
+    }
+    const bool narrowed = shared == m_query.size();
+    m_query.resize(shared);
+    m_prefixMasks.resize(shared + 1u);
+
+    for (const char* c = query + shared; *c != '\0'; ++c)
+    {
+        m_query.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(*c))));
+        m_prefixMasks.push_back(NarrowByLastChar());
+    }
+    return narrowed;
+}
+
+uint32_t FormatSearchIndex::PackGram(const char* text, const size_t length)
+{
+    uint32_t gram = static_cast<uint32_t>(length) << 24u;
+    for (size_t i = 0u; i < length; ++i)
+        gram |= static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << (16u - 8u * i);
+    return gram;
+}
+
+FormatMask FormatSearchIndex::FindGram(const char* text, const size_t length) const
+{
+    const auto found = m_grams.find(PackGram(text, length));
+    return found != m_grams.end() ? found->second : FormatMask{};
+}
+
+FormatMask FormatSearchIndex::NarrowByLastChar() const
+{
+    const size_t length = m_query.size();
+
+    // Up to 3 chars the query *is* a gram, so the gram mask is exact
+    if (length <= 3u)
+        return FindGram(m_query.c_str(), length);
+
+    // Every match for the longer query also matched the shorter one and contains its last trigram
+    FormatMask candidates = m_prefixMasks.back() & FindGram(&m_query[length - 3u], 3u);
+
+    // Grams only prove the pieces exist somewhere in the name, confirm the whole query does
+    for (size_t i = 0u; i < FORMAT_SEARCH_MAX_FORMATS; ++i)
+    {
+        if (candidates[i] && m_names[i].find(m_query) == std::string::npos)
+            candidates.reset(i);
+    }
+    return candidates;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <dxgiformat.h>
+
+#include "FormatInfo.h"
+
+// Upper bound (exclusive) of DXGI_FORMAT values the search index tracks
+#define FORMAT_SEARCH_MAX_FORMATS (FORMAT_INFO_MAX_FORMATS)
+
+// Case-insensitive substring search over DXGI format names.
+// Every 1, 2 and 3 character gram of every name is indexed once at startup into a
+// mask of the formats containing it. A query is answered by AND-ing gram masks, so the
+// cost of a keystroke depends on the query length only, never on how many rows the table has.
+class FormatSearchIndex
+{
+public:
+    FormatSearchIndex();
+
+    void Build(); // Index every known format name. Call once at startup.
+
+    // Update the visible set for the new query text. Typing a character narrows the
+    // previous result with one mask AND, deleting one pops back to the cached result.
+    // True when the query only grew, so every new match was a match before.
+    bool SetQuery(const char* query);
+
+    bool IsVisible(const DXGI_FORMAT format) const
+    {
+        // Formats outside the index have no name to match, so they only show without a query
+        return static_cast<size_t>(format) < FORMAT_SEARCH_MAX_FORMATS ? m_prefixMasks.back()[format] : m_query.empty();
+    }
+    bool HasQuery() const { return !m_query.empty(); }
+    const FormatMask& GetVisibleMask() const { return m_prefixMasks.back(); }
+    size_t GetVisibleCount() const { return m_prefixMasks.back().count(); }
+
+private:
+    static uint32_t PackGram(const char* text, const size_t length);
+    FormatMask FindGram(const char* text, const size_t length) const;
+    FormatMask NarrowByLastChar() const; // Mask for m_query given the mask for m_query minus its last char
+
+    std::unordered_map<uint32_t, FormatMask> m_grams;
+    std::vector<std::string> m_names; // Upper case names indexed by DXGI_FORMAT, empty if unknown
+    FormatMask m_allFormats;
+
+    std::string m_query; // Upper case
+    std::vector<FormatMask> m_prefixMasks; // [i] = visible formats for the first i chars of m_query
+};
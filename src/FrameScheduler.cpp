@@ -0,0 +1,53 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+FrameScheduler::FrameScheduler(std::function<TimePoint()> clock)
+    : m_clock(std::move(clock))
+    , m_pendingFrames(1u) // Always draw the first frame
+{
+}
+
+void FrameScheduler::OnInput()
+{
+    RequestFrames(SettleFrameCount);
+    RequestFrameIn(HoverSettleDelay);
+}
+
+void FrameScheduler::RequestFrames(const uint32_t count)
+{
+    m_pendingFrames = std::max(m_pendingFrames, count);
+}
+
+void FrameScheduler::RequestFrameIn(const Duration delay)
+{
+    m_timedFrames.push(m_clock() + delay);
+}
+
+bool FrameScheduler::IsFrameDue() const
+{
+    return m_pendingFrames > 0u || (!m_timedFrames.empty() && m_clock() >= m_timedFrames.top());
+}
+
+void FrameScheduler::ConsumeFrame()
+{
+    if (m_pendingFrames > 0u)
+        m_pendingFrames--;
+
+    // Later requests stay scheduled
+    const TimePoint now = m_clock();
+    while (!m_timedFrames.empty() && now >= m_timedFrames.top())
+        m_timedFrames.pop();
+}
+
+FrameScheduler::Duration FrameScheduler::GetTimeUntilNextFrame() const
+{
+    if (m_pendingFrames > 0u)
+        return Duration::zero();
+
+    if (m_timedFrames.empty())
+        return Duration::max();
+
+    return std::max(Duration::zero(), m_timedFrames.top() - m_clock());
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// Decides when the UI needs a new frame. The table is static between inputs, so instead of
+// presenting every vblank we only render after input, resizes, data changes or a timed wake-up
+// (caret blink, hover tooltips), and let the message loop sleep the rest of the time.
+// The clock is injectable so the rules can be stepped with a fake clock.
+class FrameScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Duration = Clock::duration;
+
+    explicit FrameScheduler(std::function<TimePoint()> clock = &Clock::now);
+
+    // ImGui needs a couple of frames to settle hover/active state after an event,
+    // and a late one once hover delays (tooltips) have expired.
+    void OnInput();
+    void RequestFrames(const uint32_t count = 1u);
+    void RequestFrameIn(const Duration delay);
+
+    bool IsFrameDue() const;
+    void ConsumeFrame(); // Call once per rendered frame
+
+    // How long the message loop may sleep before the next frame is due. Duration::max() means until the next event.
+    Duration GetTimeUntilNextFrame() const;
+
+    static constexpr uint32_t SettleFrameCount = 3u;
+    static constexpr std::chrono::milliseconds HoverSettleDelay{ 500 };
+
+private:
+    std::function<TimePoint()> m_clock;
+    uint32_t m_pendingFrames;
+    std::priority_queue<TimePoint, std::vector<TimePoint>, std::greater<TimePoint>> m_timedFrames; // Earliest on top, one frame serves every expired one
+};
@@ -0,0 +1,215 @@
+#include "HeatmapView.h"
+#include "FleetAggregate.h"
+#include "FormatSearch.h"
+#include "Utils.h"
+
+#include <algorithm>
+
+// Red at 0%, amber at 50%, green at 100%
+static ImVec4 CoverageColor(const float coverage)
+{
+    const ImVec4 low{ 0.75f, 0.15f, 0.15f, 1.0f };
+    const ImVec4 mid{ 0.85f, 0.65f, 0.10f, 1.0f };
+    const ImVec4 high{ 0.15f, 0.65f, 0.25f, 1.0f };
+
+    const ImVec4& from = coverage < 0.5f ? low : mid;
+    const ImVec4& to = coverage < 0.5f ? mid : high;
+    const float t = coverage < 0.5f ? coverage * 2.0f : (coverage - 0.5f) * 2.0f;
+    return ImVec4{ from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t, from.z + (to.z - from.z) * t, 1.0f };
+}
+
+HeatmapView::HeatmapView()
+    : m_aggregate(nullptr)
+    , m_rowHeaderWidth(0.0f)
+    , m_columnWidth(0.0f)
+{
+}
+
+void HeatmapView::SetAggregate(const FleetAggregate& aggregate)
+{
+    m_aggregate = &aggregate;
+
+    const size_t rows = aggregate.GetFormats().size();
+    const size_t capabilities = aggregate.GetCapabilities().size();
+    const ImU32 noDataColor = ImGui::ColorConvertFloat4ToU32(ImVec4{ 0.25f, 0.25f, 0.25f, 1.0f });
+
+    m_cellColors.resize(rows * capabilities);
+    for (size_t row = 0u; row < rows; ++row)
+    {
+        for (size_t capability = 0u; capability < capabilities; ++capability)
+        {
+            const float coverage = aggregate.GetCoverage(row, capability);
+            m_cellColors[row * capabilities + capability] = coverage < 0.0f ? noDataColor : ImGui::ColorConvertFloat4ToU32(CoverageColor(coverage));
+        }
+    }
+
+    m_rowHeaderWidth = 0.0f;
+    m_columnWidth = 0.0f;
+}
+
+void HeatmapView::Draw(const FormatSearchIndex& search)
+{
+    const size_t capabilityCount = m_aggregate ? m_aggregate->GetCapabilities().size() : 0u;
+    if (capabilityCount == 0u)
+    {
+        ImGui::Text("No reports to aggregate, import some '.csv' files");
+        return;
+    }
+
+    const std::vector<DXGI_FORMAT>& formats = m_aggregate->GetFormats();
+    const ImGuiStyle& style = ImGui::GetStyle();
+    const float fontSize = ImGui::GetFontSize();
+    const float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+
+    // Legend
+    ImGui::Text("%zu reports from %zu vendors.  0%%", m_aggregate->GetReportCount(), m_aggregate->GetVendorCount());
+    ImGui::SameLine();
+    {
+        const ImVec2 legendMin = ImGui::GetCursorScreenPos();
+        const ImVec2 legendSize{ fontSize * 8.0f, fontSize };
+        const ImVec2 legendMid{ legendMin.x + legendSize.x * 0.5f, legendMin.y + legendSize.y };
+        const ImU32 low = ImGui::ColorConvertFloat4ToU32(CoverageColor(0.0f));
+        const ImU32 mid = ImGui::ColorConvertFloat4ToU32(CoverageColor(0.5f));
+        const ImU32 high = ImGui::ColorConvertFloat4ToU32(CoverageColor(1.0f));
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->AddRectFilledMultiColor(legendMin, legendMid, low, mid, mid, low);
+        drawList->AddRectFilledMultiColor(ImVec2{ legendMid.x, legendMin.y }, ImVec2{ legendMin.x + legendSize.x, legendMid.y }, mid, high, high, mid);
+        ImGui::Dummy(legendSize);
+    }
+    ImGui::SameLine();
+    ImGui::Text("100%% of reports pass");
+
+    m_visibleRows.clear();
+    for (uint32_t row = 0u; row < formats.size(); ++row)
+    {
+        if (search.IsVisible(formats[row]))
+            m_visibleRows.push_back(row);
+    }
+
+    if (m_rowHeaderWidth <= 0.0f)
+    {
+        for (const DXGI_FORMAT format : formats)
+            m_rowHeaderWidth = std::max(m_rowHeaderWidth, ImGui::CalcTextSize(D3DFormatToString(format)).x);
+        m_rowHeaderWidth += style.CellPadding.x * 2.0f;
+
+        for (const std::string& capability : m_aggregate->GetCapabilities())
+            m_columnWidth = std::max(m_columnWidth, ImGui::CalcTextSize(capability.c_str()).x);
+        m_columnWidth = std::clamp(m_columnWidth + style.CellPadding.x * 2.0f, fontSize * 2.0f, fontSize * 6.0f);
+    }
+
+    const float cellWidth = m_columnWidth;
+    const float cellHeight = fontSize + 2.0f;
+    const float headerHeight = lineHeight;
+
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0.0f, 0.0f });
+    ImGui::BeginChild("##Heatmap", ImVec2{ 0.0f, 0.0f }, ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGui::PopStyleVar();
+
+    // Only the extents go through layout, the cells are written straight to the draw list
+    ImGui::Dummy(ImVec2{ m_rowHeaderWidth + capabilityCount * cellWidth, headerHeight + m_visibleRows.size() * cellHeight });
+
+    const ImVec2 windowPos = ImGui::GetWindowPos();
+    const ImVec2 windowSize = ImGui::GetWindowSize();
+    const float scrollX = ImGui::GetScrollX();
+    const float scrollY = ImGui::GetScrollY();
+    const ImVec2 viewMin = windowPos;
+    const ImVec2 viewMax{ windowPos.x + windowSize.x - (ImGui::GetScrollMaxY() > 0.0f ? style.ScrollbarSize : 0.0f),
+                          windowPos.y + windowSize.y - (ImGui::GetScrollMaxX() > 0.0f ? style.ScrollbarSize : 0.0f) };
+    const ImVec2 cellsMin{ viewMin.x + m_rowHeaderWidth, viewMin.y + headerHeight };
+
+    // Visible window of the grid
+    const size_t firstColumn = static_cast<size_t>(scrollX / cellWidth);
+    const size_t lastColumn = std::min(capabilityCount, static_cast<size_t>((scrollX + viewMax.x - cellsMin.x) / cellWidth) + 1u);
+    const size_t firstRow = static_cast<size_t>(scrollY / cellHeight);
+    const size_t lastRow = std::min(m_visibleRows.size(), static_cast<size_t>((scrollY + viewMax.y - cellsMin.y) / cellHeight) + 1u);
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const ImU32 headerColor = ImGui::GetColorU32(ImGuiCol_TableHeaderBg);
+    const ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+    const ImFont* font = ImGui::GetFont();
+
+    // Every visible cell in one reservation, so one draw command
+    if (firstRow < lastRow && firstColumn < lastColumn)
+    {
+        const int quadCount = static_cast<int>((lastRow - firstRow) * (lastColumn - firstColumn));
+        drawList->PushClipRect(cellsMin, viewMax, true);
+        drawList->PrimReserve(quadCount * 6, quadCount * 4);
+        for (size_t visibleRow = firstRow; visibleRow < lastRow; ++visibleRow)
+        {
+            const ImU32* rowColors = &m_cellColors[m_visibleRows[visibleRow] * capabilityCount];
+            const float y = cellsMin.y + visibleRow * cellHeight - scrollY;
+            for (size_t column = firstColumn; column < lastColumn; ++column)
+            {
+                const float x = cellsMin.x + column * cellWidth - scrollX;
+                drawList->PrimRect(ImVec2{ x + 1.0f, y + 1.0f }, ImVec2{ x + cellWidth - 1.0f, y + cellHeight - 1.0f }, rowColors[column]);
+            }
+        }
+        drawList->PopClipRect();
+    }
+
+    // Frozen column headers
+    drawList->PushClipRect(ImVec2{ cellsMin.x, viewMin.y }, ImVec2{ viewMax.x, cellsMin.y }, true);
+    drawList->AddRectFilled(ImVec2{ cellsMin.x, viewMin.y }, ImVec2{ viewMax.x, cellsMin.y }, headerColor);
+    for (size_t column = firstColumn; column < lastColumn; ++column)
+    {
+        const float x = cellsMin.x + column * cellWidth - scrollX;
+        const ImVec4 clipRect{ x, viewMin.y, x + cellWidth - 1.0f, cellsMin.y };
+        drawList->AddText(font, fontSize, ImVec2{ x + style.CellPadding.x, viewMin.y + style.CellPadding.y }, textColor,
+            m_aggregate->GetCapabilities()[column].c_str(), nullptr, 0.0f, &clipRect);
+    }
+    drawList->PopClipRect();
+
+    // Frozen row headers
+    drawList->PushClipRect(ImVec2{ viewMin.x, cellsMin.y }, ImVec2{ cellsMin.x, viewMax.y }, true);
+    drawList->AddRectFilled(ImVec2{ viewMin.x, cellsMin.y }, ImVec2{ cellsMin.x, viewMax.y }, headerColor);
+    for (size_t visibleRow = firstRow; visibleRow < lastRow; ++visibleRow)
+    {
+        const float y = cellsMin.y + visibleRow * cellHeight - scrollY;
+        drawList->AddText(ImVec2{ viewMin.x + style.CellPadding.x, y + 1.0f }, textColor, D3DFormatToString(formats[m_visibleRows[visibleRow]]));
+    }
+    drawList->PopClipRect();
+
+    drawList->AddRectFilled(viewMin, cellsMin, headerColor);
+    drawList->AddText(ImVec2{ viewMin.x + style.CellPadding.x, viewMin.y + style.CellPadding.y }, textColor, "DXGI Format");
+
+    if (ImGui::IsWindowHovered())
+    {
+        const ImVec2 mouse = ImGui::GetIO().MousePos;
+        if (mouse.x >= cellsMin.x && mouse.y >= cellsMin.y && mouse.x < viewMax.x && mouse.y < viewMax.y)
+        {
+            const size_t column = static_cast<size_t>((mouse.x - cellsMin.x + scrollX) / cellWidth);
+            const size_t visibleRow = static_cast<size_t>((mouse.y - cellsMin.y + scrollY) / cellHeight);
+            if (column < capabilityCount && visibleRow < m_visibleRows.size())
+                DrawTooltip(m_visibleRows[visibleRow], column);
+        }
+    }
+
+    ImGui::EndChild();
+}
+
+void HeatmapView::DrawTooltip(const size_t row, const size_t capability) const
+{
+    const FleetAggregate::Cell& cell = m_aggregate->GetCell(row, capability);
+
+    ImGui::BeginTooltip();
+    ImGui::Text("%s", D3DFormatToString(m_aggregate->GetFormats()[row]));
+    ImGui::Text("%s", m_aggregate->GetCapabilities()[capability].c_str());
+    if (cell.Known)
+        ImGui::Text("%u of %u reports pass (%.0f%%)", cell.Pass, cell.Known, 100.0f * m_aggregate->GetCoverage(row, capability));
+    else
+        ImGui::Text("No report knows this capability");
+
+    ImGui::Separator();
+    for (size_t vendor = 0u; vendor < m_aggregate->GetVendorCount(); ++vendor)
+    {
+        const FleetAggregate::Cell& vendorCell = m_aggregate->GetVendorCell(vendor, row, capability);
+        const uint32_t vendorId = m_aggregate->GetVendorId(vendor);
+        ImGui::Text("%s (0x%04X):", VendorIdToString(vendorId), vendorId);
+        ImGui::SameLine(ImGui::GetFontSize() * 12.0f);
+        if (vendorCell.Known)
+            ImGui::Text("%u of %u pass (%.0f%%)", vendorCell.Pass, vendorCell.Known, 100.0f * vendorCell.Pass / vendorCell.Known);
+        else
+            ImGui::Text("unknown in all %u reports", m_aggregate->GetVendorReportCount(vendor));
+    }
+    ImGui::EndTooltip();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "../ImGui/imgui.h"
+
+class FleetAggregate;
+class FormatSearchIndex;
+
+// Format x capability grid coloured by the fraction of the fleet that passes each cell.
+// Colours are resolved once per aggregate, and a frame writes every visible cell as a plain
+// quad from a single PrimReserve, so the cost is one draw command regardless of how many
+// reports went into the aggregate. Hovering reads the vendor split straight from it.
+class HeatmapView
+{
+public:
+    HeatmapView();
+
+    // The aggregate must outlive the view or be re-set before the next Draw()
+    void SetAggregate(const FleetAggregate& aggregate);
+
+    void Draw(const FormatSearchIndex& search);
+
+private:
+    void DrawTooltip(const size_t row, const size_t capability) const;
+
+    const FleetAggregate* m_aggregate;
+    std::vector<ImU32> m_cellColors;     // [format][capability]
+    std::vector<uint32_t> m_visibleRows; // Rows left after search, rebuilt per frame
+    float m_rowHeaderWidth;              // Measured lazily as it needs the font
+    float m_columnWidth;
+};
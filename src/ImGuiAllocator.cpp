@@ -0,0 +1,164 @@
+#include "ImGuiAllocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#include "../ImGui/imgui.h"
+
+#define IMGUI_POOL_MIN_BLOCK_BYTES (16u)
+#define IMGUI_POOL_LARGE_CLASS IMGUI_POOL_CLASS_COUNT // Straight from malloc, too big for a pool
+
+namespace
+{
+    // In front of every block, 16 bytes so the block keeps malloc's alignment
+    struct BlockHeader
+    {
+        uint64_t Size;      // What ImGui asked for
+        uint32_t SizeClass;
+        uint32_t Reserved;
+    };
+    static_assert(sizeof(BlockHeader) == 16u, "Blocks must stay 16 byte aligned");
+
+    // A free block's payload holds the next free block of its class
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    uint32_t GetSizeClass(const size_t size)
+    {
+        for (uint32_t sizeClass = 0u; sizeClass < IMGUI_POOL_CLASS_COUNT; ++sizeClass)
+        {
+            if (size <= (static_cast<size_t>(IMGUI_POOL_MIN_BLOCK_BYTES) << sizeClass))
+                return sizeClass;
+        }
+        return IMGUI_POOL_LARGE_CLASS;
+    }
+
+    class PoolAllocator
+    {
+    public:
+        ~PoolAllocator()
+        {
+            for (void* chunk : m_chunks)
+                std::free(chunk);
+        }
+
+        void* Allocate(const size_t size)
+        {
+            const uint32_t sizeClass = GetSizeClass(size);
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            BlockHeader* header = nullptr;
+            if (sizeClass == IMGUI_POOL_LARGE_CLASS)
+            {
+                header = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+                m_stats.SystemAllocs++;
+            }
+            else if (FreeBlock* block = m_freeLists[sizeClass])
+            {
+                m_freeLists[sizeClass] = block->Next;
+                header = reinterpret_cast<BlockHeader*>(block) - 1;
+            }
+            else
+            {
+                header = CarveBlock(sizeof(BlockHeader) + (static_cast<size_t>(IMGUI_POOL_MIN_BLOCK_BYTES) << sizeClass));
+            }
+
+            if (!header)
+                return nullptr;
+
+            header->Size = size;
+            header->SizeClass = sizeClass;
+            m_stats.Allocs++;
+            m_stats.BytesInUse += size;
+            m_stats.PeakBytesInUse = std::max(m_stats.PeakBytesInUse, m_stats.BytesInUse);
+            return header + 1;
+        }
+
+        void Free(void* ptr)
+        {
+            if (!ptr)
+                return;
+
+            BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.Frees++;
+            m_stats.BytesInUse -= header->Size;
+            if (header->SizeClass == IMGUI_POOL_LARGE_CLASS)
+            {
+                std::free(header);
+                return;
+            }
+
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->Next = m_freeLists[header->SizeClass];
+            m_freeLists[header->SizeClass] = block;
+        }
+
+        ImGuiAllocatorStats GetStats()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+
+    private:
+        // Bump-allocates from the current chunk, whatever is left of a chunk too small for the block is wasted
+        BlockHeader* CarveBlock(const size_t blockSize)
+        {
+            if (static_cast<size_t>(m_arenaEnd - m_arenaCursor) < blockSize)
+            {
+                uint8_t* chunk = static_cast<uint8_t*>(std::malloc(IMGUI_POOL_CHUNK_BYTES));
+                if (!chunk)
+                    return nullptr;
+
+                m_chunks.push_back(chunk);
+                m_arenaCursor = chunk;
+                m_arenaEnd = chunk + IMGUI_POOL_CHUNK_BYTES;
+                m_stats.SystemAllocs++;
+                m_stats.ArenaBytes += IMGUI_POOL_CHUNK_BYTES;
+            }
+
+            BlockHeader* header = reinterpret_cast<BlockHeader*>(m_arenaCursor);
+            m_arenaCursor += blockSize;
+            return header;
+        }
+
+        std::mutex m_mutex;
+        FreeBlock* m_freeLists[IMGUI_POOL_CLASS_COUNT] = {};
+        uint8_t* m_arenaCursor = nullptr;
+        uint8_t* m_arenaEnd = nullptr;
+        std::vector<void*> m_chunks;
+        ImGuiAllocatorStats m_stats = {};
+    };
+
+    // Lives until exit, after anything that could still hold ImGui memory
+    PoolAllocator g_allocator;
+    bool g_installed = false;
+
+    void* PoolAlloc(size_t size, void* userData)
+    {
+        return static_cast<PoolAllocator*>(userData)->Allocate(size);
+    }
+
+    void PoolFree(void* ptr, void* userData)
+    {
+        static_cast<PoolAllocator*>(userData)->Free(ptr);
+    }
+}
+
+void InstallImGuiAllocator()
+{
+    if (g_installed)
+        return;
+
+    ImGui::SetAllocatorFunctions(PoolAlloc, PoolFree, &g_allocator);
+    g_installed = true;
+}
+
+ImGuiAllocatorStats GetImGuiAllocatorStats()
+{
+    return g_installed ? g_allocator.GetStats() : ImGuiAllocatorStats{};
+}
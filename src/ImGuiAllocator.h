@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+
+#define IMGUI_POOL_CLASS_COUNT (9u)            // 16 bytes to 4 KiB, doubling
+#define IMGUI_POOL_CHUNK_BYTES (64u * 1024u)   // Arena chunks the pools carve their blocks from
+
+// Counters since the allocator was installed, a frame's numbers are the difference of two snapshots
+struct ImGuiAllocatorStats
+{
+    uint64_t Allocs;         // Every ImGui allocation
+    uint64_t Frees;
+    uint64_t SystemAllocs;   // The ones that reached malloc: new arena chunks and blocks too big for a pool
+    uint64_t BytesInUse;     // Requested by ImGui and not freed yet
+    uint64_t PeakBytesInUse;
+    uint64_t ArenaBytes;     // Held by the arena chunks, used or not
+};
+
+// Routes ImGui's allocations into size-classed pools. A freed block goes onto its class's free
+// list and the next allocation of that class takes it back, so once the UI has settled a frame
+// doesn't reach malloc at all. Pool memory is only handed back to the system at exit.
+// Install once, before the first font atlas or context is created, ImGui must free everything
+// with the allocator it was allocated with. Safe to use from several threads, e.g. the font atlas
+// worker at start-up.
+void InstallImGuiAllocator();
+
+// All zero when the allocator isn't installed
+ImGuiAllocatorStats GetImGuiAllocatorStats();
@@ -1,15 +1,31 @@
 #include "ImGuiLayer.h"
-#include "D3D12App.h"
+#include "ArrowExport.h"
+#include "FleetProfile.h"
+#include "FontAtlasCache.h"
+#include "ReportIO.h"
+#include "Trace.h"
+#include "UIBackend.h"
 #include "Utils.h"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 #include "../ImGui/imgui.h"
-#include "../ImGui/backends/imgui_impl_dx12.h"
-#include "../ImGui/backends/imgui_impl_win32.h"
 
 ImGuiLayer::ImGuiLayer()
     : m_gfxBackend(nullptr)
     , m_onlyCommonFormats(false)
+    , m_viewMode(ViewMode::SupportTable)
+    , m_showAllocatorStats(false)
+    , m_lastAllocatorStats{}
+    , m_tableRowsVersion(UINT32_MAX)
+    , m_visibleRowsDirty(true)
+    , m_sourcesTableVersion(UINT32_MAX)
+    , m_sourcesReportsVersion(UINT32_MAX)
+    , m_sourcesVersion(0u)
+    , m_comparisonSourcesVersion(UINT32_MAX)
+    , m_heatmapSourcesVersion(UINT32_MAX)
+    , m_timelineReportsVersion(UINT32_MAX)
 {
     m_commonFormats.reserve(11u);
     m_commonFormats.emplace_back(DXGI_FORMAT_R8_UINT);
@@ -23,12 +39,56 @@ ImGuiLayer::ImGuiLayer()
     m_commonFormats.emplace_back(DXGI_FORMAT_R8G8B8A8_UNORM);
     m_commonFormats.emplace_back(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
     m_commonFormats.emplace_back(DXGI_FORMAT_R10G10B10A2_UNORM);
+
+    for (const DXGI_FORMAT format : m_commonFormats)
+        m_commonMask.set(format);
+    m_formatRows.fill(UINT32_MAX);
+
+    m_searchText[0] = '\0';
+    m_formatSearch.Build();
+}
+
+void ImGuiLayer::Initialise()
+{
+    Initialise(*ImGui::GetIO().Fonts);
+}
+
+void ImGuiLayer::Initialise(ImFontAtlas& fontAtlas, const std::filesystem::path& fontCachePath)
+{
+    // Only the default font's bake is keyed, an atlas that already has fonts is always baked
+    const bool useCache = !fontCachePath.empty() && fontAtlas.ConfigData.empty();
+    const std::string cacheKey = useCache ? m_statusBadges.GetAtlasKey(fontAtlas) : std::string();
+    if (useCache)
+    {
+        TRACE_ZONE("Load font atlas cache");
+        if (LoadFontAtlasCache(fontCachePath, cacheKey, fontAtlas) && m_statusBadges.AttachToAtlas(fontAtlas))
+            return;
+        fontAtlas.Clear();
+    }
+
+    {
+        TRACE_ZONE("Bake status badges");
+        m_statusBadges.BakeIntoAtlas(fontAtlas);
+    }
+
+    if (useCache)
+    {
+        TRACE_ZONE("Save font atlas cache");
+        SaveFontAtlasCache(fontCachePath, cacheKey, fontAtlas);
+    }
 }
 
 void ImGuiLayer::OnRender()
 {
+    TRACE_ZONE("ImGuiLayer::OnRender");
     CreateMenuBar();
     CreateMainSupportTable();
+
+    // From one OnRender to the next covers a whole frame, the previous Render() included
+    const ImGuiAllocatorStats allocatorStats = GetImGuiAllocatorStats();
+    if (m_showAllocatorStats)
+        DrawAllocatorOverlay(allocatorStats);
+    m_lastAllocatorStats = allocatorStats;
 }
 
 void ImGuiLayer::CreateMenuBar()
@@ -38,7 +98,9 @@ void ImGuiLayer::CreateMenuBar()
 
     if (ImGui::BeginMenu("File"))
     {
-        if (ImGui::MenuItem("Export to .csv file"))
+        // Exports of the live table wait until every format has been probed
+        const bool tableComplete = m_gfxBackend->IsSupportTableComplete();
+        if (ImGui::MenuItem("Export to .csv file", nullptr, false, tableComplete))
         {
             if (!m_gfxBackend->ExportFormatSupportTable())
             {
@@ -46,6 +108,47 @@ void ImGuiLayer::CreateMenuBar()
             }
         }
 
+        if (ImGui::MenuItem("Export copyable footprints to .csv file", nullptr, false, tableComplete))
+        {
+            if (!m_gfxBackend->ExportCopyableFootprints())
+            {
+                m_gfxBackend->SendFileSaveErrorEvent();
+            }
+        }
+
+        // The allocation probe runs on after the table, the export never waits for it on this thread
+        if (ImGui::MenuItem("Export allocation sizes to .csv file", nullptr, false, m_gfxBackend->IsAllocationInfoReady()))
+        {
+            if (!m_gfxBackend->ExportAllocationInfo())
+            {
+                m_gfxBackend->SendFileSaveErrorEvent();
+            }
+        }
+
+        if (ImGui::MenuItem("Export capability header", nullptr, false, tableComplete))
+        {
+            if (!ExportCapsHeader(false))
+            {
+                m_gfxBackend->SendFileSaveErrorEvent();
+            }
+        }
+
+        if (ImGui::MenuItem("Export fleet minimum capability header", nullptr, false, tableComplete))
+        {
+            if (!ExportCapsHeader(true))
+            {
+                m_gfxBackend->SendFileSaveErrorEvent();
+            }
+        }
+
+        if (ImGui::MenuItem("Export to Arrow files", nullptr, false, tableComplete))
+        {
+            if (!ExportArrowFiles())
+            {
+                m_gfxBackend->SendFileSaveErrorEvent();
+            }
+        }
+
         if (ImGui::MenuItem("Import '.csv' file"))
         {
             m_gfxBackend->OpenFileDialogue();
@@ -55,7 +158,19 @@ void ImGuiLayer::CreateMenuBar()
     }
     if (ImGui::BeginMenu("Config"))
     {
-        ImGui::MenuItem("Only show 'common' formats", nullptr, &m_onlyCommonFormats);
+        if (ImGui::MenuItem("Only show 'common' formats", nullptr, &m_onlyCommonFormats))
+            m_visibleRowsDirty = true;
+        ImGui::Separator();
+        if (ImGui::MenuItem("Support table", nullptr, m_viewMode == ViewMode::SupportTable))
+            m_viewMode = ViewMode::SupportTable;
+        if (ImGui::MenuItem("Compare with imported reports", nullptr, m_viewMode == ViewMode::Comparison))
+            m_viewMode = ViewMode::Comparison;
+        if (ImGui::MenuItem("Fleet coverage heatmap", nullptr, m_viewMode == ViewMode::Heatmap))
+            m_viewMode = ViewMode::Heatmap;
+        if (ImGui::MenuItem("Driver timeline", nullptr, m_viewMode == ViewMode::Timeline))
+            m_viewMode = ViewMode::Timeline;
+        ImGui::Separator();
+        ImGui::MenuItem("Show allocator stats", nullptr, &m_showAllocatorStats);
         ImGui::EndMenu();
     }
     ImGui::EndMainMenuBar();
@@ -80,91 +195,354 @@ void ImGuiLayer::CreateMainSupportTable()
     ImGui::Text("Shared memory: %.2f GB", BytesToGigbibytes(m_gfxBackend->GetGPUInfo().SharedSystemMemBytes));
     ImGui::Columns(1);
 
-    const std::vector<const char*> tableHeaders = m_gfxBackend->GetTableHeaders();
+    // Rows show up as the probe worker finishes them
+    if (!m_gfxBackend->IsSupportTableComplete())
+        ImGui::TextDisabled("Probing formats, %u so far...", static_cast<uint32_t>(m_gfxBackend->GetSupportTable().size()));
+
+    const std::vector<const char*>& tableHeaders = m_gfxBackend->GetTableHeaders();
     if (tableHeaders.empty())
     {
         ImGui::Text("No info loaded");
         ImGui::End();
         return;
     }
-    constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY;
-    ImGui::BeginTable("Formats", static_cast<int>(tableHeaders.size()), tableFlags);
+
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    if (ImGui::InputTextWithHint("##FormatSearch", "Search formats...", m_searchText, sizeof(m_searchText)))
+    {
+        // With a query before, at most one row per indexed format is visible, and only those can still match
+        const bool hadQuery = m_formatSearch.HasQuery();
+        if (m_formatSearch.SetQuery(m_searchText) && hadQuery && !m_visibleRowsDirty)
+            NarrowVisibleRows();
+        else
+            m_visibleRowsDirty = true;
+    }
+
+    if (m_viewMode == ViewMode::Comparison)
+    {
+        RefreshReportSources();
+        if (m_comparisonSourcesVersion != m_sourcesVersion)
+        {
+            m_comparisonView.SetSources(m_reportSources);
+            m_comparisonSourcesVersion = m_sourcesVersion;
+        }
+        m_comparisonView.Draw(m_statusBadges, m_formatSearch);
+        ImGui::End();
+        return;
+    }
+    if (m_viewMode == ViewMode::Heatmap)
+    {
+        RefreshReportSources();
+        if (m_heatmapSourcesVersion != m_sourcesVersion)
+        {
+            m_fleetAggregate.Build(m_reportSources);
+            m_heatmapView.SetAggregate(m_fleetAggregate);
+            m_heatmapSourcesVersion = m_sourcesVersion;
+        }
+        m_heatmapView.Draw(m_formatSearch);
+        ImGui::End();
+        return;
+    }
+    if (m_viewMode == ViewMode::Timeline)
+    {
+        // Starts on the live adapter when there are reports of it
+        const uint32_t reportsVersion = m_gfxBackend->GetImportedReportsVersion();
+        if (m_timelineReportsVersion != reportsVersion)
+        {
+            m_driverTimelines.Build(m_gfxBackend->GetImportedReports());
+            m_timelineView.SetTimelines(m_driverTimelines, m_gfxBackend->GetGPUInfo().VendorId, m_gfxBackend->GetGPUInfo().DeviceId);
+            m_timelineReportsVersion = reportsVersion;
+        }
+        m_timelineView.Draw(m_statusBadges, m_formatSearch);
+        ImGui::End();
+        return;
+    }
+
+    constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY
+        | ImGuiTableFlags_Sortable | ImGuiTableFlags_SortMulti;
+    const uint32_t supportColumn = static_cast<uint32_t>(tableHeaders.size()); // Extra column after the headers
+    ImGui::BeginTable("Formats", static_cast<int>(supportColumn + 1u), tableFlags);
 
     // Setup table header and freeze it 
     ImGui::TableSetupScrollFreeze(0, 1);
     for (uint32_t column = 0; column < tableHeaders.size(); column++)
-        ImGui::TableSetupColumn(tableHeaders[column]);
+        ImGui::TableSetupColumn(tableHeaders[column], column == 0 ? ImGuiTableColumnFlags_DefaultSort : ImGuiTableColumnFlags_None);
+    ImGui::TableSetupColumn("Support %", ImGuiTableColumnFlags_PreferSortDescending);
     ImGui::TableHeadersRow();
 
-    // Main table render
-    const auto& supportTable = m_gfxBackend->GetSupportTable();
+    // Only re-sort when the user changes the sort order or the table itself changes
+    ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs();
+    const uint32_t tableVersion = m_gfxBackend->GetSupportTableVersion();
+    if (tableVersion != m_tableRowsVersion)
+    {
+        RebuildTableRows();
+        m_formatResolver.Build(m_gfxBackend->GetSupportTable());
+        m_tableRowsVersion = tableVersion;
+        m_visibleRowsDirty = true;
+        if (sortSpecs)
+            sortSpecs->SpecsDirty = true;
+    }
+    if (sortSpecs && sortSpecs->SpecsDirty)
+    {
+        SortTableRows(*sortSpecs, supportColumn);
+        sortSpecs->SpecsDirty = false;
+        m_visibleRowsDirty = true;
+    }
+    if (m_visibleRowsDirty)
+        RebuildVisibleRows();
 
-    for (uint32_t row = 0; row < supportTable.size(); row++)
+    // Main table render, only the rows inside the scrolled viewport are submitted
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(m_visibleRows.size()));
+    while (clipper.Step())
     {
-        if (m_onlyCommonFormats)
+        for (int visibleRow = clipper.DisplayStart; visibleRow < clipper.DisplayEnd; ++visibleRow)
         {
-            bool commonNotFound = true;
-            for (const DXGI_FORMAT format : m_commonFormats)
+            const TableRow& tableRow = m_tableRows[m_visibleRows[visibleRow]];
+            ImGui::TableNextRow();
+            for (uint32_t column = 0; column <= supportColumn; column++)
             {
-                if (static_cast<DXGI_FORMAT>(row) == format)
+                if (!ImGui::TableSetColumnIndex(column)) // Scrolled out horizontally
+                    continue;
+                if (column == 0)
+                {
+                    ImGui::Text("%s", tableRow.Name);  // Print DXGI format
+                    if (ImGui::IsItemHovered())
+                        DrawFallbackTooltip(tableRow.Format, tableRow.Flags, tableHeaders);
+                    continue;
+                }
+                if (column == supportColumn)
                 {
-                    commonNotFound = false;
-                    break;
+                    ImGui::Text("%.0f%%", 100.0f * tableRow.GetPassRatio());
+                    continue;
                 }
+
+                const FormatSupport support = tableRow.GetFlag(column - 1u); // -1 as column 0 is taken for format text
+
+                m_statusBadges.Draw(support);
             }
-            if (commonNotFound)
-                continue;
         }
+    }
+    ImGui::EndTable();
+    ImGui::End();
+}
+
+void ImGuiLayer::DrawAllocatorOverlay(const ImGuiAllocatorStats& stats) const
+{
+    // Bottom right corner, above the table, never takes input
+    constexpr float padding = 10.0f;
+    ImGui::SetNextWindowPos(ImVec2{ static_cast<float>(m_gfxBackend->GetWidth()) - padding, static_cast<float>(m_gfxBackend->GetHeight()) - padding },
+        ImGuiCond_Always, ImVec2{ 1.0f, 1.0f });
+    ImGui::SetNextWindowBgAlpha(0.75f);
+    constexpr ImGuiWindowFlags overlayFlags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings
+        | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoInputs;
+    ImGui::Begin("##AllocatorStats", nullptr, overlayFlags);
+
+    ImGui::Text("ImGui allocations last frame: %llu (%llu frees)", static_cast<unsigned long long>(stats.Allocs - m_lastAllocatorStats.Allocs),
+        static_cast<unsigned long long>(stats.Frees - m_lastAllocatorStats.Frees));
+    ImGui::Text("Reached malloc last frame: %llu", static_cast<unsigned long long>(stats.SystemAllocs - m_lastAllocatorStats.SystemAllocs));
+    ImGui::Separator();
+    ImGui::Text("Allocations: %llu, reached malloc: %llu", static_cast<unsigned long long>(stats.Allocs), static_cast<unsigned long long>(stats.SystemAllocs));
+    ImGui::Text("In use: %.1f KiB, peak %.1f KiB", static_cast<double>(stats.BytesInUse) / 1024.0, static_cast<double>(stats.PeakBytesInUse) / 1024.0);
+    ImGui::Text("Pool arena: %.1f KiB", static_cast<double>(stats.ArenaBytes) / 1024.0);
+    ImGui::End();
+}
+
+void ImGuiLayer::RefreshReportSources()
+{
+    const uint32_t tableVersion = m_gfxBackend->GetSupportTableVersion();
+    const uint32_t reportsVersion = m_gfxBackend->GetImportedReportsVersion();
+    if (tableVersion == m_sourcesTableVersion && reportsVersion == m_sourcesReportsVersion)
+        return;
+
+    // The live table is the target everything else is compared against
+    m_reportSources.clear();
+    const std::vector<const char*>& tableHeaders = m_gfxBackend->GetTableHeaders();
+    if (!tableHeaders.empty())
+    {
+        const GPUInfo& gpuInfo = m_gfxBackend->GetGPUInfo();
+        ReportSource live{ gpuInfo.Name.c_str(), gpuInfo.VendorId, {}, &m_gfxBackend->GetSupportTable() };
+        live.Capabilities.assign(tableHeaders.begin() + 1, tableHeaders.end());
+        m_reportSources.push_back(std::move(live));
+    }
+    for (const SupportReport& report : m_gfxBackend->GetImportedReports())
+    {
+        ReportSource imported{ report.Adapter.Name.c_str(), report.Adapter.VendorId, {}, &report.Table };
+        for (const std::string& capability : report.Capabilities)
+            imported.Capabilities.push_back(capability.c_str());
+        m_reportSources.push_back(std::move(imported));
+    }
+
+    m_sourcesTableVersion = tableVersion;
+    m_sourcesReportsVersion = reportsVersion;
+    m_sourcesVersion++;
+}
+
+bool ImGuiLayer::ExportCapsHeader(const bool fleetMinimum)
+{
+    TRACE_ZONE("ExportCapsHeader");
+    SupportReport profile;
+    if (fleetMinimum)
+    {
+        RefreshReportSources();
+        FleetProfileBuilder fleet;
+        for (const ReportSource& source : m_reportSources)
+            fleet.AddReport(source);
+
+        const std::string name = "Fleet minimum of " + std::to_string(fleet.GetReportCount()) + " reports";
+        fleet.BuildReport(fleet.GetReportCount(), name.c_str(), profile);
+        return ExportCapabilityHeader("DXGI_FleetCaps.h", profile, "FleetCaps");
+    }
+
+    const std::vector<const char*>& tableHeaders = m_gfxBackend->GetTableHeaders();
+    if (tableHeaders.empty())
+        return false;
+
+    profile.Adapter = m_gfxBackend->GetGPUInfo();
+    profile.Capabilities.assign(tableHeaders.begin() + 1, tableHeaders.end());
+    profile.Table = m_gfxBackend->GetSupportTable();
+    return ExportCapabilityHeader("DXGI_Caps.h", profile);
+}
+
+bool ImGuiLayer::ExportArrowFiles()
+{
+    TRACE_ZONE("ExportArrowFiles");
+    const std::vector<const char*>& tableHeaders = m_gfxBackend->GetTableHeaders();
+    if (tableHeaders.empty())
+        return false;
+
+    SupportReport live;
+    live.Adapter = m_gfxBackend->GetGPUInfo();
+    live.Capabilities.assign(tableHeaders.begin() + 1, tableHeaders.end());
+    live.Table = m_gfxBackend->GetSupportTable();
+
+    ArrowTableWriter reports;
+    AppendSupportReportRows(reports, live);
+    for (const SupportReport& report : m_gfxBackend->GetImportedReports())
+        AppendSupportReportRows(reports, report);
+
+    RefreshReportSources();
+    FleetAggregate aggregate;
+    aggregate.Build(m_reportSources);
+    ArrowTableWriter fleet;
+    AppendFleetAggregateRows(fleet, aggregate);
+
+    return reports.Write("DXGI_Formats.arrow") && fleet.Write("DXGI_Fleet.arrow");
+}
+
+void ImGuiLayer::RebuildTableRows()
+{
+    TRACE_ZONE("RebuildTableRows");
+    const auto& supportTable = m_gfxBackend->GetSupportTable();
+    const std::vector<const char*>& tableHeaders = m_gfxBackend->GetTableHeaders();
+    const uint32_t columnCount = tableHeaders.empty() ? 0u : static_cast<uint32_t>(tableHeaders.size() - 1u); // Column 0 is taken for format text
+
+    m_tableRows.clear();
+    m_tableRows.reserve(supportTable.size());
+    for (const auto& [format, supportFlags] : supportTable)
+    {
+        TableRow row;
+        row.Format = format;
+        row.Name = D3DFormatToString(format);
+        row.Flags = supportFlags.data();
+        row.FlagCount = std::min(columnCount, static_cast<uint32_t>(supportFlags.size()));
+        row.PassCount = static_cast<uint32_t>(std::count(supportFlags.begin(), supportFlags.begin() + row.FlagCount, FormatSupport::PASS));
+
+        m_tableRows.push_back(row);
+    }
+    IndexTableRows();
+}
 
-        ImGui::TableNextRow();
-        for (uint32_t column = 0; column < tableHeaders.size(); column++)
+void ImGuiLayer::SortTableRows(const ImGuiTableSortSpecs& sortSpecs, const uint32_t supportColumn)
+{
+    const auto compare = [&sortSpecs, supportColumn](const TableRow& lhs, const TableRow& rhs)
+    {
+        for (int i = 0; i < sortSpecs.SpecsCount; ++i)
         {
-            ImGui::TableSetColumnIndex(column);
+            const ImGuiTableColumnSortSpecs& spec = sortSpecs.Specs[i];
+            const uint32_t column = static_cast<uint32_t>(spec.ColumnIndex);
+
+            int delta = 0;
             if (column == 0)
-            {
-                ImGui::Text("%s", D3DFormatToString(static_cast<DXGI_FORMAT>(row)));  // Print DXGI format
-                continue;
-            }
+                delta = std::strcmp(lhs.Name, rhs.Name);
+            else if (column == supportColumn)
+                delta = (lhs.GetPassRatio() > rhs.GetPassRatio()) - (lhs.GetPassRatio() < rhs.GetPassRatio());
+            else
+                delta = static_cast<int>(lhs.GetFlag(column - 1u)) - static_cast<int>(rhs.GetFlag(column - 1u));
 
-            const auto found = supportTable.find(static_cast<DXGI_FORMAT>(row));
-            if (found == supportTable.end())
-                continue;
+            if (delta != 0)
+                return spec.SortDirection == ImGuiSortDirection_Ascending ? delta < 0 : delta > 0;
+        }
 
-            const std::array<FormatSupport, SUPPORT_FLAGS_COUNT>& supportFlags = found->second;
-            const FormatSupport support = supportFlags[column - 1u]; // -1 as column 0 is taken for format text. 
+        // Fall back to enum order so ties always come out the same way
+        return lhs.Format < rhs.Format;
+    };
+    std::stable_sort(m_tableRows.begin(), m_tableRows.end(), compare);
+    IndexTableRows();
+}
 
-            switch (support)
-            {
-            case FormatSupport::PASS:
-            {
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4{ 0.2f, 0.7f, 0.2f, 1.0f });
-                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4{ 0.3f, 0.8f, 0.3f, 1.0f });
-                ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4{ 0.2f, 0.7f, 0.2f, 1.0f });
-                ImGui::Button("PASS");
-                break;
-            }
-            case FormatSupport::FAIL:
-            {
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4{ 0.8f, 0.1f, 0.15f, 1.0f });
-                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4{ 0.9f, 0.2f, 0.2f, 1.0f });
-                ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4{ 0.8f, 0.1f, 0.15f, 1.0f });
-                ImGui::Button("FAIL");
-                break;
-            }
-            case FormatSupport::UNKN:
-            default:
-            {
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4{ 0.1f, 0.1f, 0.1f, 1.0f });
-                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4{ 0.2f, 0.2f, 0.2f, 1.0f });
-                ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4{ 0.1f, 0.1f, 0.1f, 1.0f });
-                ImGui::Button("UNKN");
-                break;
-            }
-            }
-            ImGui::PopStyleColor(3);
-            
+void ImGuiLayer::IndexTableRows()
+{
+    m_formatRows.fill(UINT32_MAX);
+    for (uint32_t row = 0; row < m_tableRows.size(); ++row)
+    {
+        if (static_cast<size_t>(m_tableRows[row].Format) < FORMAT_SEARCH_MAX_FORMATS)
+            m_formatRows[m_tableRows[row].Format] = row;
+    }
+}
+
+void ImGuiLayer::RebuildVisibleRows()
+{
+    m_visibleRows.clear();
+    m_visibleRowsDirty = false;
+    if (!m_formatSearch.HasQuery() && !m_onlyCommonFormats)
+    {
+        // Close to every row is visible, which costs as much to write out as to check
+        m_visibleRows.reserve(m_tableRows.size());
+        for (uint32_t row = 0; row < m_tableRows.size(); ++row)
+        {
+            if (m_formatSearch.IsVisible(m_tableRows[row].Format))
+                m_visibleRows.push_back(row);
         }
+        return;
     }
-    ImGui::EndTable();
-    ImGui::End();
+
+    // Only indexed formats can match, so gather the matches' rows from the index rather than scan the table
+    FormatMask matches = m_formatSearch.HasQuery() ? m_formatSearch.GetVisibleMask() : FormatMask{}.set();
+    if (m_onlyCommonFormats)
+        matches &= m_commonMask;
+    for (size_t format = 0u; format < FORMAT_SEARCH_MAX_FORMATS; ++format)
+    {
+        if (matches[format] && m_formatRows[format] != UINT32_MAX)
+            m_visibleRows.push_back(m_formatRows[format]);
+    }
+    std::sort(m_visibleRows.begin(), m_visibleRows.end()); // Back into the table's sort order
+}
+
+void ImGuiLayer::NarrowVisibleRows()
+{
+    const auto noLongerVisible = [this](const uint32_t row) { return !m_formatSearch.IsVisible(m_tableRows[row].Format); };
+    m_visibleRows.erase(std::remove_if(m_visibleRows.begin(), m_visibleRows.end(), noLongerVisible), m_visibleRows.end());
+}
+
+void ImGuiLayer::DrawFallbackTooltip(const DXGI_FORMAT format, const FormatSupport* supportFlags, const std::vector<const char*>& tableHeaders) const
+{
+    ImGui::BeginTooltip();
+    ImGui::Text("Substitutes on this GPU:");
+
+    bool anyFailed = false;
+    const uint32_t flagsCount = std::min(static_cast<uint32_t>(tableHeaders.size() - 1u), static_cast<uint32_t>(SUPPORT_FLAGS_COUNT));
+    for (uint32_t column = 0; column < flagsCount; ++column)
+    {
+        if (supportFlags[column] == FormatSupport::PASS)
+            continue;
+
+        anyFailed = true;
+        const DXGI_FORMAT substitute = m_formatResolver.Resolve(format, 1u << column);
+        ImGui::Text("%s: %s", tableHeaders[column + 1u], substitute == DXGI_FORMAT_UNKNOWN ? "none" : D3DFormatToString(substitute));
+    }
+    if (!anyFailed)
+        ImGui::Text("None needed");
+
+    ImGui::EndTooltip();
 }
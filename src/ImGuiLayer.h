@@ -1,32 +1,108 @@
 #pragma once
+#include <array>
+#include <filesystem>
 #include <vector>
-#include <dxgi1_6.h>
 
-class D3D12App;
+#include "ComparisonView.h"
+#include "DriverTimeline.h"
+#include "FleetAggregate.h"
+#include "FormatResolver.h"
+#include "FormatSearch.h"
+#include "HeatmapView.h"
+#include "ImGuiAllocator.h"
+#include "StatusBadge.h"
+#include "TimelineView.h"
 
-enum class FormatSupport : int8_t
-{
-    UNKN = -1,
-    FAIL = 0,
-    PASS = 1,
+#include "SupportTable.h"
 
-    COUNT
-};
+class UIBackend;
+struct ImGuiTableSortSpecs;
 
 class ImGuiLayer
 {
 public:
+    enum class ViewMode
+    {
+        SupportTable,
+        Comparison, // Live table side by side with the imported reports
+        Heatmap,    // Coverage over the live table and the imported reports
+        Timeline,   // How the imported reports of one adapter changed across drivers
+    };
+
     ImGuiLayer();
 
-    void BindBackend(D3D12App& backend) { m_gfxBackend = &backend; }
+    void BindBackend(UIBackend& backend) { m_gfxBackend = &backend; }
+    void Initialise(); // Call once the ImGui context exists, before the first frame
+    // Into an atlas the context will share, safe on a worker before the context exists. With a cache path
+    // the baked atlas is loaded from there when an earlier run saved one, and saved there when not.
+    void Initialise(ImFontAtlas& fontAtlas, const std::filesystem::path& fontCachePath = {});
     void OnRender();
 
+    const std::vector<DXGI_FORMAT>& GetCommonFormats() const { return m_commonFormats; } // Set up in the constructor, never changes
+
+    void SetViewMode(const ViewMode mode) { m_viewMode = mode; }
+    void SetShowAllocatorStats(const bool show) { m_showAllocatorStats = show; }
+
 private:
     void CreateMenuBar();
     void CreateMainSupportTable();
+    void DrawAllocatorOverlay(const ImGuiAllocatorStats& stats) const;
+
+    void RefreshReportSources();
+    bool ExportCapsHeader(const bool fleetMinimum); // Live table, or what every report in the fleet supports
+    bool ExportArrowFiles(); // Live table and imported reports, and their fleet aggregate
+    void RebuildTableRows();
+    void SortTableRows(const ImGuiTableSortSpecs& sortSpecs, const uint32_t supportColumn);
+    void IndexTableRows();
+    void RebuildVisibleRows();
+    void NarrowVisibleRows(); // The query only grew, drop the visible rows that no longer match
+    void DrawFallbackTooltip(const DXGI_FORMAT format, const FormatSupport* supportFlags, const std::vector<const char*>& tableHeaders) const;
+
+    struct TableRow
+    {
+        DXGI_FORMAT Format;
+        const char* Name;
+        const FormatSupport* Flags; // Points into the backend's support table
+        uint32_t FlagCount;         // Flags shown, the ones with a header column
+        uint32_t PassCount;         // Of those
+
+        FormatSupport GetFlag(const uint32_t index) const { return index < FlagCount ? Flags[index] : FormatSupport::UNKN; }
+        float GetPassRatio() const { return FlagCount ? static_cast<float>(PassCount) / static_cast<float>(FlagCount) : 0.0f; }
+    };
 
-    D3D12App* m_gfxBackend;
+    UIBackend* m_gfxBackend;
     bool m_onlyCommonFormats;
+    ViewMode m_viewMode;
+    bool m_showAllocatorStats;
+    ImGuiAllocatorStats m_lastAllocatorStats; // As of the previous frame's OnRender
+
+    StatusBadgeRenderer m_statusBadges;
+    FormatSearchIndex m_formatSearch;
+    char m_searchText[64];
+
+    std::vector<TableRow> m_tableRows; // Cached sort permutation, rebuilt when the sort specs or table change
+    uint32_t m_tableRowsVersion;
+    std::array<uint32_t, FORMAT_SEARCH_MAX_FORMATS> m_formatRows; // Index of each format's row in m_tableRows, UINT32_MAX if none
+    std::vector<uint32_t> m_visibleRows; // Indices into m_tableRows left after search and the common filter
+    bool m_visibleRowsDirty;             // Rebuild m_visibleRows before the next draw
+    FormatResolver m_formatResolver;   // Substitutes for the live adapter, rebuilt with the table rows
+
+    std::vector<ReportSource> m_reportSources; // Live table first, then the imported reports
+    uint32_t m_sourcesTableVersion;             // Support table version the sources were built from
+    uint32_t m_sourcesReportsVersion;           // Imported reports version the sources were built from
+    uint32_t m_sourcesVersion;                  // Bumped whenever the sources are rebuilt
+
+    ComparisonView m_comparisonView;
+    uint32_t m_comparisonSourcesVersion;
+
+    FleetAggregate m_fleetAggregate;
+    HeatmapView m_heatmapView;
+    uint32_t m_heatmapSourcesVersion;
+
+    DriverTimelineSet m_driverTimelines;
+    TimelineView m_timelineView;
+    uint32_t m_timelineReportsVersion;
 
     std::vector<DXGI_FORMAT> m_commonFormats;
+    FormatMask m_commonMask; // m_commonFormats as a mask
 };
\ No newline at end of file
@@ -0,0 +1,452 @@
+#include "ReportCollector.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#define REPORT_SENDER_BUFFER_SIZE (64u * 1024u)
+#define REPORT_COLLECTOR_RECEIVE_SIZE (64u * 1024u)
+#define REPORT_COLLECTOR_MAX_PENDING_BYTES (64u * 1024u * 1024u)
+#define REPORT_COLLECTOR_SYNC_RETRY_MIN_MS (10u)   // First wait after a failed sync, doubling each time it fails again
+#define REPORT_COLLECTOR_SYNC_RETRY_MAX_MS (1000u)
+
+namespace
+{
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+
+    bool InitialiseSockets()
+    {
+        static const bool initialised = []()
+        {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return initialised;
+    }
+
+    void CloseSocket(const SocketHandle socket) { closesocket(socket); }
+    void ShutdownSocket(const SocketHandle socket) { shutdown(socket, SD_BOTH); }
+#else
+    using SocketHandle = int;
+
+    bool InitialiseSockets() { return true; }
+    void CloseSocket(const SocketHandle socket) { ::close(socket); }
+    void ShutdownSocket(const SocketHandle socket) { shutdown(socket, SHUT_RDWR); }
+#endif
+
+#ifdef MSG_NOSIGNAL
+    constexpr int SendFlags = MSG_NOSIGNAL; // A collector going away is an error, not a SIGPIPE
+#else
+    constexpr int SendFlags = 0;
+#endif
+
+    SocketHandle ToHandle(const intptr_t socket) { return static_cast<SocketHandle>(socket); }
+    intptr_t FromHandle(const SocketHandle socket) { return static_cast<intptr_t>(socket); }
+    bool IsValid(const SocketHandle socket) { return FromHandle(socket) >= 0; }
+
+    sockaddr_in LoopbackAddress(const uint16_t port)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+
+    uint32_t GetLE32(const uint8_t* bytes)
+    {
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8u) | (static_cast<uint32_t>(bytes[2]) << 16u)
+            | (static_cast<uint32_t>(bytes[3]) << 24u);
+    }
+
+    void PutLE32(uint8_t* bytes, const uint32_t value)
+    {
+        for (size_t i = 0u; i < 4u; ++i)
+            bytes[i] = static_cast<uint8_t>(value >> (8u * i));
+    }
+
+    uint64_t MillisecondsSinceEpoch()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+}
+
+void AppendReportFrame(const SupportReport& report, std::vector<uint8_t>& outBytes)
+{
+    std::vector<uint8_t> payload;
+    EncodeReportPayload(report, payload);
+
+    const size_t offset = outBytes.size();
+    outBytes.resize(offset + REPORT_FRAME_HEADER_SIZE);
+    PutLE32(outBytes.data() + offset, REPORT_FRAME_MAGIC);
+    PutLE32(outBytes.data() + offset + 4u, static_cast<uint32_t>(payload.size()));
+    outBytes.insert(outBytes.end(), payload.begin(), payload.end());
+}
+
+bool ReportSender::Connect(const uint16_t port)
+{
+    Close();
+    if (!InitialiseSockets())
+        return false;
+
+    const SocketHandle socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (!IsValid(socket))
+        return false;
+
+    const sockaddr_in address = LoopbackAddress(port);
+    if (connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        CloseSocket(socket);
+        return false;
+    }
+
+    m_socket = FromHandle(socket);
+    return true;
+}
+
+bool ReportSender::Send(const SupportReport& report)
+{
+    AppendReportFrame(report, m_buffer);
+    return m_buffer.size() < REPORT_SENDER_BUFFER_SIZE || Flush();
+}
+
+bool ReportSender::SendFrames(const uint8_t* frames, const size_t size)
+{
+    m_buffer.insert(m_buffer.end(), frames, frames + size);
+    return m_buffer.size() < REPORT_SENDER_BUFFER_SIZE || Flush();
+}
+
+bool ReportSender::Flush()
+{
+    if (m_socket < 0)
+        return false;
+
+    size_t offset = 0u;
+    while (offset < m_buffer.size())
+    {
+        const int chunk = static_cast<int>(std::min<size_t>(m_buffer.size() - offset, 1u << 30u));
+        const auto sent = send(ToHandle(m_socket), reinterpret_cast<const char*>(m_buffer.data() + offset), chunk, SendFlags);
+        if (sent <= 0)
+            return false;
+        offset += static_cast<size_t>(sent);
+    }
+
+    m_buffer.clear();
+    return true;
+}
+
+void ReportSender::Close()
+{
+    if (m_socket < 0)
+        return;
+
+    Flush();
+    CloseSocket(ToHandle(m_socket));
+    m_socket = -1;
+    m_buffer.clear();
+}
+
+bool ReportCollector::Start(const Settings& settings)
+{
+    Stop();
+    m_settings = settings;
+    m_segmentPath = settings.Store ? settings.Store->NewSegmentPath() : settings.SegmentPath;
+    if (!InitialiseSockets() || !m_segment.Open(m_segmentPath))
+        return false;
+
+    const SocketHandle listener = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (!IsValid(listener))
+    {
+        CloseSegment();
+        return false;
+    }
+
+#ifndef _WIN32
+    // Restarting the collector shouldn't have to wait out TIME_WAIT
+    const int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+
+    sockaddr_in address = LoopbackAddress(settings.Port);
+    socklen_t addressSize = sizeof(address);
+    if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0
+        || getsockname(listener, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0)
+    {
+        CloseSocket(listener);
+        CloseSegment();
+        return false;
+    }
+
+    m_listener = FromHandle(listener);
+    m_port = ntohs(address.sin_port);
+    m_stats = Stats{};
+    m_writerStopped = false;
+    m_running = true;
+    m_writerThread = std::thread(&ReportCollector::WriterLoop, this);
+    for (uint32_t i = 0u; i < std::max(1u, settings.ReceiveThreads); ++i)
+        m_receiveThreads.emplace_back(&ReportCollector::ReceiveWorker, this);
+    m_acceptThread = std::thread(&ReportCollector::AcceptLoop, this);
+    return true;
+}
+
+void ReportCollector::Stop()
+{
+    if (!m_running.exchange(false))
+        return;
+
+    // Wake accept() up
+    ShutdownSocket(ToHandle(m_listener));
+    CloseSocket(ToHandle(m_listener));
+    m_acceptThread.join();
+    m_listener = -1;
+
+    // Waiting connections are shut down too, their receive loops end as soon as they're picked up
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const intptr_t connection : m_connections)
+            ShutdownSocket(ToHandle(connection));
+        m_pendingTaken.notify_all();
+        m_connectionQueued.notify_all();
+    }
+    for (std::thread& thread : m_receiveThreads)
+        thread.join();
+    m_receiveThreads.clear();
+
+    m_batchReady.notify_one();
+    m_writerThread.join();
+    CloseSegment();
+}
+
+ReportCollector::Stats ReportCollector::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void ReportCollector::AcceptLoop()
+{
+    SetTraceThreadName("Collector accept");
+    while (m_running)
+    {
+        const SocketHandle connection = accept(ToHandle(m_listener), nullptr, nullptr);
+        if (!IsValid(connection))
+        {
+            if (!m_running)
+                break;
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_writerStopped || m_stats.OpenConnections >= std::max(1u, m_settings.MaxConnections))
+        {
+            CloseSocket(connection);
+            m_stats.RefusedConnections++;
+            continue;
+        }
+        m_connections.push_back(FromHandle(connection));
+        m_queuedConnections.push_back(FromHandle(connection));
+        m_stats.OpenConnections++;
+        m_connectionQueued.notify_one();
+    }
+}
+
+void ReportCollector::ReceiveWorker()
+{
+    SetTraceThreadName("Collector connection");
+    for (;;)
+    {
+        intptr_t connection = -1;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_connectionQueued.wait(lock, [this]() { return !m_queuedConnections.empty() || !m_running; });
+            if (m_queuedConnections.empty())
+                break;
+            connection = m_queuedConnections.front();
+            m_queuedConnections.pop_front();
+        }
+        ReceiveLoop(connection);
+    }
+}
+
+void ReportCollector::ReceiveLoop(const intptr_t connection)
+{
+    std::vector<uint8_t> received;
+    std::vector<uint8_t> records;
+    size_t size = 0u;
+    bool open = true;
+    while (open)
+    {
+        received.resize(size + REPORT_COLLECTOR_RECEIVE_SIZE);
+        const auto count = recv(ToHandle(connection), reinterpret_cast<char*>(received.data() + size), static_cast<int>(REPORT_COLLECTOR_RECEIVE_SIZE), 0);
+        if (count <= 0)
+            break;
+        size += static_cast<size_t>(count);
+
+        // Every whole frame received so far, one timestamp for all of them
+        const uint64_t timestamp = MillisecondsSinceEpoch();
+        uint64_t reports = 0u;
+        uint64_t rejected = 0u;
+        size_t offset = 0u;
+        records.clear();
+        while (size - offset >= REPORT_FRAME_HEADER_SIZE)
+        {
+            const uint32_t payloadSize = GetLE32(received.data() + offset + 4u);
+            if (GetLE32(received.data() + offset) != REPORT_FRAME_MAGIC || payloadSize > REPORT_FRAME_MAX_PAYLOAD)
+            {
+                // Lost track of the frames, nothing after this can be trusted
+                rejected++;
+                open = false;
+                break;
+            }
+            if (size - offset - REPORT_FRAME_HEADER_SIZE < payloadSize)
+                break;
+
+            const uint8_t* payload = received.data() + offset + REPORT_FRAME_HEADER_SIZE;
+            if (IsValidReportPayload(payload, payloadSize))
+            {
+                AppendSegmentRecord(timestamp, payload, payloadSize, 1u, records);
+                reports++;
+            }
+            else
+            {
+                rejected++;
+            }
+            offset += REPORT_FRAME_HEADER_SIZE + payloadSize;
+        }
+
+        std::memmove(received.data(), received.data() + offset, size - offset);
+        size -= offset;
+
+        bool batchFull = false;
+        {
+            // Senders wait while the disk catches up rather than the backlog growing without bound
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_pendingTaken.wait(lock, [this]() { return m_pending.size() < REPORT_COLLECTOR_MAX_PENDING_BYTES || !m_running || m_writerStopped; });
+            if (m_writerStopped)
+                break;
+            m_pending.insert(m_pending.end(), records.begin(), records.end());
+            m_pendingReports += reports;
+            m_stats.Received += reports;
+            m_stats.Rejected += rejected;
+            batchFull = m_pendingReports >= m_settings.BatchReports;
+        }
+        if (batchFull)
+            m_batchReady.notify_one();
+    }
+
+    // Out of the list before closing, once closed the handle may be reused by a socket Stop() mustn't shut down
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_connections.erase(std::find(m_connections.begin(), m_connections.end(), connection));
+        m_stats.OpenConnections--;
+    }
+    CloseSocket(ToHandle(connection));
+}
+
+void ReportCollector::WriterLoop()
+{
+    SetTraceThreadName("Collector writer");
+    std::vector<uint8_t> batch;
+    uint64_t unsyncedReports = 0u; // In the segment's buffer, a failed sync keeps them there
+    uint32_t retryDelayMs = 0u;
+    for (;;)
+    {
+        if (unsyncedReports == 0u)
+        {
+            uint64_t batchReports = 0u;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_batchReady.wait_for(lock, std::chrono::milliseconds(m_settings.FlushIntervalMs),
+                    [this]() { return m_pendingReports >= m_settings.BatchReports || !m_running; });
+
+                // Connections keep filling the other buffer while this one is written
+                batch.swap(m_pending);
+                batchReports = m_pendingReports;
+                m_pendingReports = 0u;
+                m_pendingTaken.notify_all();
+                if (batchReports == 0u && !m_running)
+                    break;
+            }
+
+            if (batchReports == 0u)
+                continue;
+
+            m_segment.AppendEncoded(batch.data(), batch.size(), batchReports);
+            batch.clear();
+            unsyncedReports = batchReports;
+        }
+        else
+        {
+            // Once stopping, give up when the backoff has run its course, Stop() still tries once more when closing the segment
+            if (!m_running && retryDelayMs >= REPORT_COLLECTOR_SYNC_RETRY_MAX_MS)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(retryDelayMs));
+        }
+
+        TRACE_ZONE("Write report batch");
+        const bool synced = m_segment.Sync();
+        retryDelayMs = synced ? 0u : std::clamp(retryDelayMs * 2u, REPORT_COLLECTOR_SYNC_RETRY_MIN_MS, REPORT_COLLECTOR_SYNC_RETRY_MAX_MS);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (synced)
+            {
+                m_stats.Written += unsyncedReports;
+                m_stats.Batches++;
+                unsyncedReports = 0u;
+            }
+            else
+            {
+                m_stats.SyncFailures++;
+            }
+        }
+
+        if (synced && m_settings.Store && m_segment.GetSyncedBytes() >= m_settings.RotateBytes && CloseSegment())
+        {
+            // The previous segment is the store's now. Without a new one nothing more can be made durable, so
+            // stop taking reports rather than hold every sender at the pending limit for good.
+            m_segmentPath = m_settings.Store->NewSegmentPath();
+            if (!m_segment.Open(m_segmentPath))
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_writerStopped = true;
+                m_stats.WriterStopped = true;
+                m_pendingTaken.notify_all();
+                break;
+            }
+        }
+    }
+}
+
+bool ReportCollector::CloseSegment()
+{
+    const bool empty = m_segment.GetRecordCount() == 0u;
+    m_segment.Close();
+    if (!m_settings.Store)
+        return true;
+
+    // Not worth a segment in the store
+    std::error_code error;
+    if (empty)
+        return std::filesystem::remove(m_segmentPath, error);
+    return m_settings.Store->AddSegment(m_segmentPath);
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ReportSegment.h"
+#include "SegmentedReportStore.h"
+
+#define REPORT_COLLECTOR_DEFAULT_PORT (47315u)
+#define REPORT_FRAME_MAGIC (0x43534644u) // "DFSC"
+#define REPORT_FRAME_HEADER_SIZE (8u)
+#define REPORT_FRAME_MAX_PAYLOAD (1u << 20u)
+
+// Reports on the wire: u32 magic, u32 payload size, then the payload from ReportSegment.h.
+// A connection is any number of frames back to back.
+void AppendReportFrame(const SupportReport& report, std::vector<uint8_t>& outBytes);
+
+// Blocking client for a collector on this machine. Frames are buffered and go out in large
+// sends, Flush() or Close() pushes out the rest.
+class ReportSender
+{
+public:
+    ~ReportSender() { Close(); }
+
+    bool Connect(const uint16_t port = REPORT_COLLECTOR_DEFAULT_PORT);
+    bool Send(const SupportReport& report);
+    bool SendFrames(const uint8_t* frames, const size_t size); // Built with AppendReportFrame
+    bool Flush();
+    void Close();
+
+private:
+    intptr_t m_socket = -1;
+    std::vector<uint8_t> m_buffer;
+};
+
+// Listens on the loopback interface and appends every report it receives to one segment.
+// A fixed pool of receive threads splits frames and stamps them with the receive time, one
+// connection per thread at a time. Connections past the pool wait their turn, past
+// MaxConnections they're refused. A writer thread takes whatever has arrived every batch or
+// flush interval and writes and fsyncs it in one go, so the cost of a sync is shared by every
+// report in the batch. A report is durable once the batch it arrived in has been synced,
+// within FlushIntervalMs. A batch that fails to sync is retried with backoff, nothing new is
+// taken meanwhile so senders are held back by the pending limit rather than reports dropped.
+// If the next segment can't be opened after a rotation the writer stops, see IsRunning().
+// Given a store, segments are taken from it and handed back to it whenever one grows past
+// RotateBytes and on Stop(), the store compacts them from there.
+class ReportCollector
+{
+public:
+    struct Settings
+    {
+        uint16_t Port = REPORT_COLLECTOR_DEFAULT_PORT; // 0 picks a free one, see GetPort()
+        std::filesystem::path SegmentPath;         // Ignored with a store
+        SegmentedReportStore* Store = nullptr;
+        uint64_t RotateBytes = 64u * 1024u * 1024u; // Segment size handed to the store
+        uint32_t BatchReports = 4096u;  // Sync as soon as this many are waiting
+        uint32_t FlushIntervalMs = 20u; // or when the oldest has waited this long
+        uint32_t ReceiveThreads = 8u;   // Connections served at once
+        uint32_t MaxConnections = 256u; // Served and waiting, more are closed straight away
+    };
+
+    struct Stats
+    {
+        uint64_t Received;        // Reports accepted into a batch
+        uint64_t Rejected;        // Frames that weren't a report
+        uint64_t Written;         // Reports synced to the segment
+        uint64_t Batches;         // Syncs
+        uint64_t SyncFailures;    // Each one retried until it works
+        uint64_t RefusedConnections;
+        uint32_t OpenConnections; // Served and waiting
+        bool WriterStopped;       // The next segment couldn't be opened, nothing was taken after it
+    };
+
+    ~ReportCollector() { Stop(); }
+
+    bool Start(const Settings& settings);
+    void Stop(); // Closes every connection, then syncs whatever was received
+
+    bool IsRunning() const { return m_running && !m_writerStopped; } // False once the writer stopped, Stop() still has to be called
+    uint16_t GetPort() const { return m_port; }
+    Stats GetStats() const;
+
+private:
+    void AcceptLoop();
+    void ReceiveWorker(); // Serves queued connections until Stop()
+    void ReceiveLoop(const intptr_t connection);
+    void WriterLoop();
+    bool CloseSegment(); // Hands it to the store if there is one
+
+    Settings m_settings;
+    SegmentWriter m_segment;
+    std::filesystem::path m_segmentPath;
+    intptr_t m_listener = -1;
+    uint16_t m_port = 0u;
+    std::atomic<bool> m_running{ false };
+    std::atomic<bool> m_writerStopped{ false }; // Connections are closed and refused from then on
+
+    std::thread m_acceptThread;
+    std::thread m_writerThread;
+    std::vector<std::thread> m_receiveThreads;
+    std::vector<intptr_t> m_connections;        // Open ones, served or waiting, to shut down on Stop()
+    std::deque<intptr_t> m_queuedConnections;   // Accepted, waiting for a receive thread
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_batchReady;
+    std::condition_variable m_connectionQueued;
+    std::condition_variable m_pendingTaken;
+    std::vector<uint8_t> m_pending; // Segment records waiting for the writer
+    uint64_t m_pendingReports = 0u;
+    Stats m_stats{};
+};
@@ -0,0 +1,304 @@
+#include "ReportIO.h"
+#include "CapabilityHeader.h"
+#include "Trace.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+
+// Split one CSV line in place, dropping the trailing empty cell the exporter writes
+static void SplitCSVLine(const std::string& line, std::vector<std::string>& outCells)
+{
+    outCells.clear();
+    size_t start = 0u;
+    while (start < line.size())
+    {
+        size_t end = line.find(',', start);
+        if (end == std::string::npos)
+            end = line.size();
+
+        outCells.emplace_back(line, start, end - start);
+        start = end + 1u;
+    }
+}
+
+// "# <key>,<value>," lines after the table, so the header stays on the first line for anything
+// that reads the export as a plain table, e.g. pandas with comment='#'
+static void WriteAdapterTrailer(std::stringstream& ss, const GPUInfo& adapter)
+{
+    std::string adapterName = adapter.Name;
+    adapterName.erase(std::remove(adapterName.begin(), adapterName.end(), ','), adapterName.end());
+    ss << "# Adapter," << adapterName << ",\n";
+    ss << "# VendorId," << adapter.VendorId << ",\n";
+    ss << "# DeviceId," << adapter.DeviceId << ",\n";
+    ss << "# DriverVersion," << DriverVersionToString(adapter.DriverVersion) << ",\n";
+}
+
+// A trailer line, or one of the same lines without the '#' ahead of the header as older exports wrote them
+static void ReadAdapterLine(const std::vector<std::string>& cells, GPUInfo& outAdapter)
+{
+    if (cells.size() < 2u)
+        return;
+
+    std::string_view key = cells[0];
+    if (!key.empty() && key.front() == '#')
+    {
+        key.remove_prefix(1u);
+        while (!key.empty() && key.front() == ' ')
+            key.remove_prefix(1u);
+    }
+
+    if (key == "Adapter")
+        outAdapter.Name = cells[1];
+    else if (key == "VendorId")
+        outAdapter.VendorId = static_cast<uint32_t>(std::strtoul(cells[1].c_str(), nullptr, 0));
+    else if (key == "DeviceId")
+        outAdapter.DeviceId = static_cast<uint32_t>(std::strtoul(cells[1].c_str(), nullptr, 0));
+    else if (key == "DriverVersion")
+        DriverVersionFromString(cells[1], outAdapter.DriverVersion);
+}
+
+bool ExportSupportReportCSV(const std::filesystem::path& path, const SupportReport& report)
+{
+    TRACE_ZONE("ExportSupportReportCSV");
+    std::ofstream outFile(path, std::ios::trunc | std::ios::out);
+    if (!outFile.is_open() || !outFile.good())
+        return false;
+
+    std::stringstream ss;
+    ss << "DXGI Format,";
+    for (const std::string& capability : report.Capabilities)
+        ss << capability << ',';
+    ss << '\n';
+
+    std::vector<DXGI_FORMAT> formats;
+    formats.reserve(report.Table.size());
+    for (const auto& [format, supportFlags] : report.Table)
+        formats.push_back(format);
+    std::sort(formats.begin(), formats.end());
+
+    for (const DXGI_FORMAT format : formats)
+    {
+        ss << D3DFormatToString(format) << ',';
+        for (const FormatSupport flag : report.Table.at(format))
+            ss << FormatSupportEnumToString(flag) << ',';
+        ss << '\n';
+    }
+
+    // Adapter info after the table, so merged reports can be grouped by vendor and driver
+    WriteAdapterTrailer(ss, report.Adapter);
+
+    outFile << ss.str();
+    return outFile.good();
+}
+
+bool ImportSupportReportCSV(const std::filesystem::path& path, SupportReport& outReport)
+{
+    TRACE_ZONE("ImportSupportReportCSV");
+    std::ifstream inFile(path);
+    if (!inFile.is_open() || !inFile.good())
+        return false;
+
+    std::string line;
+    std::vector<std::string> cells;
+    SupportReport report;
+    report.Adapter.Name = path.stem().u8string();
+
+    // The header "DXGI Format,<capability>,...", older exports have "<key>,<value>," adapter lines ahead of it
+    bool foundHeader = false;
+    while (!foundHeader && std::getline(inFile, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        SplitCSVLine(line, cells);
+        if (cells.size() < 2u)
+            continue;
+
+        if (cells[0] == "DXGI Format")
+        {
+            report.Capabilities.assign(cells.begin() + 1, cells.end());
+            foundHeader = true;
+        }
+        else
+            ReadAdapterLine(cells, report.Adapter);
+    }
+    if (!foundHeader)
+        return false;
+
+    // Format rows, then the "# <key>,<value>," adapter trailer
+    while (std::getline(inFile, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        SplitCSVLine(line, cells);
+        if (!cells.empty() && !cells[0].empty() && cells[0].front() == '#')
+        {
+            ReadAdapterLine(cells, report.Adapter);
+            continue;
+        }
+
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        if (cells.empty() || !D3DFormatFromString(cells[0], format))
+            continue;
+
+        std::vector<FormatSupport> supportFlags(report.Capabilities.size(), FormatSupport::UNKN);
+        for (size_t column = 1u; column < cells.size() && column <= supportFlags.size(); ++column)
+            supportFlags[column - 1u] = FormatSupportFromString(cells[column]);
+
+        report.Table[format] = std::move(supportFlags);
+    }
+
+    outReport = std::move(report);
+    return true;
+}
+
+bool ExportFootprintRecordsCSV(const std::filesystem::path& path, const std::vector<FootprintRecord>& records)
+{
+    std::ofstream outFile(path, std::ios::trunc | std::ios::out);
+    if (!outFile.is_open() || !outFile.good())
+        return false;
+
+    std::stringstream ss;
+    ss << "DXGI Format,Dimension,Width,Height,DepthOrArraySize,MipLevels,TotalBytes,Subresources,\n";
+    for (const FootprintRecord& record : records)
+    {
+        const TextureDesc& desc = record.Desc;
+        ss << D3DFormatToString(desc.Format) << ',' << static_cast<uint32_t>(desc.Dimension) + 1u << ',' << desc.Width << ',' << desc.Height << ','
+           << desc.DepthOrArraySize << ',' << desc.MipLevels << ',' << record.TotalBytes << ',';
+
+        for (const SubresourceFootprint& layout : record.Layouts)
+            ss << layout.Offset << ':' << layout.RowPitch << ':' << layout.NumRows << ':' << layout.RowSizeInBytes << ' ';
+
+        ss << ",\n";
+    }
+
+    outFile << ss.str();
+    return outFile.good();
+}
+
+bool ImportFootprintRecordsCSV(const std::filesystem::path& path, std::vector<FootprintRecord>& outRecords)
+{
+    std::ifstream inFile(path);
+    if (!inFile.is_open() || !inFile.good())
+        return false;
+
+    std::string line;
+    std::vector<std::string> cells;
+    if (!std::getline(inFile, line))
+        return false;
+
+    std::vector<FootprintRecord> records;
+    while (std::getline(inFile, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        SplitCSVLine(line, cells);
+        FootprintRecord record{};
+        if (cells.size() < 7u || !D3DFormatFromString(cells[0], record.Desc.Format))
+            continue;
+
+        const uint32_t dimension = static_cast<uint32_t>(std::strtoul(cells[1].c_str(), nullptr, 10));
+        if (dimension < 1u || dimension > 3u)
+            continue;
+
+        record.Desc.Dimension = static_cast<TextureDimension>(dimension - 1u);
+        record.Desc.Width = static_cast<uint32_t>(std::strtoul(cells[2].c_str(), nullptr, 10));
+        record.Desc.Height = static_cast<uint32_t>(std::strtoul(cells[3].c_str(), nullptr, 10));
+        record.Desc.DepthOrArraySize = static_cast<uint32_t>(std::strtoul(cells[4].c_str(), nullptr, 10));
+        record.Desc.MipLevels = static_cast<uint32_t>(std::strtoul(cells[5].c_str(), nullptr, 10));
+        record.Desc.SampleCount = 1u;
+        record.TotalBytes = std::strtoull(cells[6].c_str(), nullptr, 10);
+
+        // "offset:rowPitch:numRows:rowSize" groups separated by spaces
+        std::string layoutCells = cells.size() > 7u ? cells[7] : std::string{};
+        std::replace(layoutCells.begin(), layoutCells.end(), ':', ' ');
+        std::stringstream layouts(layoutCells);
+        SubresourceFootprint layout{};
+        while (layouts >> layout.Offset >> layout.RowPitch >> layout.NumRows >> layout.RowSizeInBytes)
+            record.Layouts.push_back(layout);
+
+        records.push_back(std::move(record));
+    }
+
+    outRecords = std::move(records);
+    return true;
+}
+
+bool ExportAllocationRecordsCSV(const std::filesystem::path& path, const GPUInfo& adapter, const std::vector<AllocationRecord>& records)
+{
+    std::ofstream outFile(path, std::ios::trunc | std::ios::out);
+    if (!outFile.is_open() || !outFile.good())
+        return false;
+
+    std::stringstream ss;
+    ss << "DXGI Format,Dimension,Width,Height,DepthOrArraySize,MipLevels,Usage,SizeInBytes,Alignment,\n";
+    for (const AllocationRecord& record : records)
+    {
+        const TextureDesc& desc = record.Probe.Desc;
+        ss << D3DFormatToString(desc.Format) << ',' << static_cast<uint32_t>(desc.Dimension) + 1u << ',' << desc.Width << ',' << desc.Height << ','
+           << desc.DepthOrArraySize << ',' << desc.MipLevels << ',' << AllocationUsageToString(record.Probe.Usage) << ',' << record.Info.SizeInBytes << ','
+           << record.Info.Alignment << ",\n";
+    }
+    WriteAdapterTrailer(ss, adapter);
+
+    outFile << ss.str();
+    return outFile.good();
+}
+
+bool ImportAllocationRecordsCSV(const std::filesystem::path& path, std::vector<AllocationRecord>& outRecords)
+{
+    std::ifstream inFile(path);
+    if (!inFile.is_open() || !inFile.good())
+        return false;
+
+    std::string line;
+    std::vector<std::string> cells;
+    std::vector<AllocationRecord> records;
+    while (std::getline(inFile, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        // The header and adapter lines don't start with a format name
+        SplitCSVLine(line, cells);
+        AllocationRecord record{};
+        if (cells.size() < 9u || !D3DFormatFromString(cells[0], record.Probe.Desc.Format))
+            continue;
+
+        const uint32_t dimension = static_cast<uint32_t>(std::strtoul(cells[1].c_str(), nullptr, 10));
+        if (dimension < 1u || dimension > 3u)
+            continue;
+
+        TextureDesc& desc = record.Probe.Desc;
+        desc.Dimension = static_cast<TextureDimension>(dimension - 1u);
+        desc.Width = static_cast<uint32_t>(std::strtoul(cells[2].c_str(), nullptr, 10));
+        desc.Height = static_cast<uint32_t>(std::strtoul(cells[3].c_str(), nullptr, 10));
+        desc.DepthOrArraySize = static_cast<uint32_t>(std::strtoul(cells[4].c_str(), nullptr, 10));
+        desc.MipLevels = static_cast<uint32_t>(std::strtoul(cells[5].c_str(), nullptr, 10));
+        desc.SampleCount = 1u;
+        record.Probe.Usage = AllocationUsageFromString(cells[6]);
+        record.Info.SizeInBytes = std::strtoull(cells[7].c_str(), nullptr, 10);
+        record.Info.Alignment = std::strtoull(cells[8].c_str(), nullptr, 10);
+
+        records.push_back(record);
+    }
+
+    outRecords = std::move(records);
+    return true;
+}
+
+bool ExportCapabilityHeader(const std::filesystem::path& path, const SupportReport& profile, const char* namespaceName)
+{
+    std::ofstream outFile(path, std::ios::trunc | std::ios::out | std::ios::binary);
+    if (!outFile.is_open() || !outFile.good())
+        return false;
+
+    outFile << GenerateCapabilityHeader(profile, namespaceName);
+    return outFile.good();
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <filesystem>
+#include <vector>
+
+#include "AllocationProbe.h"
+#include "SupportTable.h"
+#include "TextureFootprint.h"
+
+// The header, one line per format in enum order, then "# <key>,<value>," adapter lines
+bool ExportSupportReportCSV(const std::filesystem::path& path, const SupportReport& report);
+
+// Reads a '.csv' written by ExportSupportReportCSV(), e.g. from D3D12App::ExportFormatSupportTable().
+// The report is named after the adapter, or after the file for exports without adapter info.
+bool ImportSupportReportCSV(const std::filesystem::path& path, SupportReport& outReport);
+
+// One line per desc: the desc, total bytes, then "offset:rowPitch:numRows:rowSize" per subresource
+bool ExportFootprintRecordsCSV(const std::filesystem::path& path, const std::vector<FootprintRecord>& records);
+bool ImportFootprintRecordsCSV(const std::filesystem::path& path, std::vector<FootprintRecord>& outRecords);
+
+// The header, one line per probed desc: the desc, its flags, size and alignment, then adapter lines as in the support table export
+bool ExportAllocationRecordsCSV(const std::filesystem::path& path, const GPUInfo& adapter, const std::vector<AllocationRecord>& records);
+bool ImportAllocationRecordsCSV(const std::filesystem::path& path, std::vector<AllocationRecord>& outRecords);
+
+// GenerateCapabilityHeader() output, written with '\n' line endings on every platform so regenerated headers diff cleanly
+bool ExportCapabilityHeader(const std::filesystem::path& path, const SupportReport& profile, const char* namespaceName = "Caps");
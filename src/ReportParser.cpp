@@ -0,0 +1,608 @@
+#include "ReportParser.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include "MappedFile.h"
+#include "Trace.h"
+#include "Utils.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define REPORT_PARSER_X64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define REPORT_PARSER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define REPORT_PARSER_TARGET_AVX2
+#endif
+
+#define REPORT_PARSER_BLOCK_BYTES (64u)
+#define REPORT_PARSER_CHUNKS_PER_THREAD (4u)
+
+namespace
+{
+    // Bit i of each mask is set when byte i of the 64 byte block is a ',' or a '\n'
+    using ScanFunction = void(*)(const char* block, uint64_t& outCommas, uint64_t& outNewlines);
+
+#ifndef REPORT_PARSER_X64
+    // Only needed off x64, SSE2 is always there on it
+    void ScanScalar(const char* block, uint64_t& outCommas, uint64_t& outNewlines)
+    {
+        uint64_t commas = 0u;
+        uint64_t newlines = 0u;
+        for (uint32_t i = 0u; i < REPORT_PARSER_BLOCK_BYTES; ++i)
+        {
+            commas |= static_cast<uint64_t>(block[i] == ',') << i;
+            newlines |= static_cast<uint64_t>(block[i] == '\n') << i;
+        }
+        outCommas = commas;
+        outNewlines = newlines;
+    }
+#endif
+
+#ifdef REPORT_PARSER_X64
+    // SSE2 is part of x64, no check needed
+    void ScanSSE2(const char* block, uint64_t& outCommas, uint64_t& outNewlines)
+    {
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i newline = _mm_set1_epi8('\n');
+        uint64_t commas = 0u;
+        uint64_t newlines = 0u;
+        for (uint32_t i = 0u; i < REPORT_PARSER_BLOCK_BYTES; i += 16u)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            commas |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, comma)))) << i;
+            newlines |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)))) << i;
+        }
+        outCommas = commas;
+        outNewlines = newlines;
+    }
+
+    REPORT_PARSER_TARGET_AVX2 void ScanAVX2(const char* block, uint64_t& outCommas, uint64_t& outNewlines)
+    {
+        const __m256i comma = _mm256_set1_epi8(',');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+        outCommas = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, comma)))
+            | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, comma)))) << 32u);
+        outNewlines = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, newline)))
+            | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, newline)))) << 32u);
+    }
+
+    bool HasAVX2()
+    {
+#ifdef _MSC_VER
+        // The OS has to save the upper halves of the registers too
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6u) != 6u)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+
+    struct Scanner
+    {
+        ScanFunction Scan;
+        const char* Name;
+    };
+
+    const Scanner& GetScanner()
+    {
+        static const Scanner scanner = []()
+        {
+#ifdef REPORT_PARSER_X64
+            if (HasAVX2())
+                return Scanner{ ScanAVX2, "AVX2" };
+            return Scanner{ ScanSSE2, "SSE2" };
+#else
+            return Scanner{ ScanScalar, "scalar" };
+#endif
+        }();
+        return scanner;
+    }
+
+    uint32_t CountTrailingZeros(const uint64_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index = 0u;
+        _BitScanForward64(&index, mask);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+    }
+
+    bool IsFormatLine(const char* line, const char* end)
+    {
+        static constexpr std::string_view prefix = "DXGI_FORMAT_";
+        return static_cast<size_t>(end - line) >= prefix.size() && std::memcmp(line, prefix.data(), prefix.size()) == 0;
+    }
+
+    // Format names by value, and for each format the one after it in enum order, which is the
+    // row that follows it in an exported table
+    struct FormatNames
+    {
+        std::array<std::string_view, 256u> Names;
+        std::array<uint16_t, 256u> Next;
+        std::unordered_map<std::string_view, DXGI_FORMAT> Lookup;
+
+        FormatNames()
+        {
+            for (uint32_t i = 0u; i < 256u; ++i)
+            {
+                const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(i);
+                if (format == DXGI_FORMAT_UNKNOWN || std::string_view(D3DFormatToString(format)) != "Unknown format")
+                {
+                    Names[i] = D3DFormatToString(format);
+                    Lookup.emplace(Names[i], format);
+                }
+            }
+
+            uint16_t next = 256u;
+            for (uint32_t i = 256u; i-- > 0u;)
+            {
+                Next[i] = next;
+                if (!Names[i].empty())
+                    next = static_cast<uint16_t>(i);
+            }
+        }
+    };
+
+    const FormatNames& GetFormatNames()
+    {
+        static const FormatNames names;
+        return names;
+    }
+
+    // Parses the reports of one or more chunks, reusing one report for all of them
+    class ChunkParser
+    {
+    public:
+        ChunkParser(const char* defaultName, const ReportCSVParser::ReportCallback& callback)
+            : m_defaultName(defaultName), m_callback(callback), m_formatNames(GetFormatNames()), m_scan(GetScanner().Scan),
+              m_chunk(0u), m_reports(0u), m_foundHeader(false), m_inTable(false), m_nextFormat(0u), m_generation(0u)
+        {
+            m_seenGeneration.fill(0u);
+            m_rows.fill(nullptr);
+            ResetReport();
+        }
+
+        uint64_t GetReportCount() const { return m_reports; }
+
+        void Parse(const size_t chunk, const char* begin, const char* end)
+        {
+            m_chunk = chunk;
+            m_commas.clear();
+
+            const char* lineStart = begin;
+            const size_t size = static_cast<size_t>(end - begin);
+            for (size_t offset = 0u; offset < size; offset += REPORT_PARSER_BLOCK_BYTES)
+            {
+                // The last block is padded with zeros, which are neither delimiter
+                const char* block = begin + offset;
+                char padded[REPORT_PARSER_BLOCK_BYTES];
+                if (size - offset < REPORT_PARSER_BLOCK_BYTES)
+                {
+                    std::memset(padded, 0, sizeof(padded));
+                    std::memcpy(padded, block, size - offset);
+                    block = padded;
+                }
+
+                uint64_t commas = 0u;
+                uint64_t newlines = 0u;
+                m_scan(block, commas, newlines);
+                for (uint64_t structurals = commas | newlines; structurals != 0u; structurals &= structurals - 1u)
+                {
+                    const uint32_t bit = CountTrailingZeros(structurals);
+                    const char* delimiter = begin + offset + bit;
+                    if (newlines & (1ull << bit))
+                    {
+                        ParseLine(lineStart, delimiter);
+                        lineStart = delimiter + 1;
+                        m_commas.clear();
+                    }
+                    else
+                        m_commas.push_back(delimiter);
+                }
+            }
+
+            if (lineStart < end)
+                ParseLine(lineStart, end);
+            FinishReport();
+        }
+
+    private:
+        // Cells the way ImportSupportReportCSV() splits a line: a trailing empty cell doesn't count
+        size_t GetCellCount(const char* line, const char* end) const
+        {
+            const char* lastStart = m_commas.empty() ? line : m_commas.back() + 1;
+            return m_commas.size() + (lastStart < end ? 1u : 0u);
+        }
+
+        std::string_view GetCell(const char* line, const char* end, const size_t cell) const
+        {
+            const char* cellStart = cell == 0u ? line : m_commas[cell - 1u] + 1;
+            const char* cellEnd = cell < m_commas.size() ? m_commas[cell] : end;
+            return std::string_view(cellStart, static_cast<size_t>(cellEnd - cellStart));
+        }
+
+        void ParseLine(const char* line, const char* end)
+        {
+            if (end > line && end[-1] == '\r')
+                end--;
+
+            const size_t cellCount = GetCellCount(line, end);
+            if (cellCount == 0u)
+                return;
+
+            if (IsFormatLine(line, end))
+            {
+                m_inTable = true;
+                if (m_foundHeader)
+                    ParseFormatRow(line, end, cellCount);
+                return;
+            }
+
+            // "# <key>,<value>," adapter lines after the table belong to it
+            std::string_view key = GetCell(line, end, 0u);
+            const bool isComment = !key.empty() && key.front() == '#';
+            if (isComment)
+            {
+                key.remove_prefix(1u);
+                while (!key.empty() && key.front() == ' ')
+                    key.remove_prefix(1u);
+            }
+
+            // Otherwise the first line that isn't a format row after the header or some rows starts the next report
+            else if (m_inTable)
+                FinishReport();
+            if (cellCount < 2u || (m_foundHeader && !isComment))
+                return;
+
+            const std::string_view value = GetCell(line, end, 1u);
+            if (key == "DXGI Format" && !isComment)
+            {
+                m_report.Capabilities.resize(cellCount - 1u);
+                for (size_t cell = 1u; cell < cellCount; ++cell)
+                {
+                    const std::string_view capability = GetCell(line, end, cell);
+                    m_report.Capabilities[cell - 1u].assign(capability.data(), capability.size());
+                }
+                m_foundHeader = true;
+                m_inTable = true;
+            }
+            else if (key == "Adapter")
+                m_report.Adapter.Name.assign(value.data(), value.size());
+            else if (key == "VendorId")
+                m_report.Adapter.VendorId = ParseId(value);
+            else if (key == "DeviceId")
+                m_report.Adapter.DeviceId = ParseId(value);
+            else if (key == "DriverVersion")
+                ParseDriverVersion(value);
+        }
+
+        void ParseFormatRow(const char* line, const char* end, const size_t cellCount)
+        {
+            // Rows come in enum order, so the name is almost always the one after the last row's
+            const std::string_view name = GetCell(line, end, 0u);
+            DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+            if (m_nextFormat < 256u && m_formatNames.Names[m_nextFormat] == name)
+                format = static_cast<DXGI_FORMAT>(m_nextFormat);
+            else
+            {
+                const auto found = m_formatNames.Lookup.find(name);
+                if (found == m_formatNames.Lookup.end())
+                    return;
+                format = found->second;
+            }
+            m_nextFormat = m_formatNames.Next[format];
+
+            // Rows of earlier reports are reused in place, so a warm parser doesn't allocate
+            std::vector<FormatSupport>*& row = m_rows[format];
+            if (!row)
+                row = &m_report.Table[format];
+            std::vector<FormatSupport>& supportFlags = *row;
+            supportFlags.assign(m_report.Capabilities.size(), FormatSupport::UNKN);
+            m_seenGeneration[format] = m_generation;
+            for (size_t column = 1u; column < cellCount && column <= supportFlags.size(); ++column)
+            {
+                const std::string_view cell = GetCell(line, end, column);
+                if (cell.size() == 4u && std::memcmp(cell.data(), "PASS", 4u) == 0)
+                    supportFlags[column - 1u] = FormatSupport::PASS;
+                else if (cell.size() == 4u && std::memcmp(cell.data(), "FAIL", 4u) == 0)
+                    supportFlags[column - 1u] = FormatSupport::FAIL;
+            }
+        }
+
+        // strtoul() with base 0 like ImportSupportReportCSV(), plain decimals skip the copy
+        uint32_t ParseId(const std::string_view value)
+        {
+            if (!value.empty() && value.size() <= 9u && value[0] != '0'
+                && std::all_of(value.begin(), value.end(), [](const char c) { return c >= '0' && c <= '9'; }))
+            {
+                uint32_t id = 0u;
+                for (const char c : value)
+                    id = id * 10u + static_cast<uint32_t>(c - '0');
+                return id;
+            }
+
+            m_scratch.assign(value.data(), value.size());
+            return static_cast<uint32_t>(std::strtoul(m_scratch.c_str(), nullptr, 0));
+        }
+
+        // "a.b.c.d" of plain decimals, anything else goes through DriverVersionFromString()
+        void ParseDriverVersion(const std::string_view value)
+        {
+            uint64_t version = 0u;
+            size_t position = 0u;
+            for (uint32_t part = 0u; part < 4u; ++part)
+            {
+                uint32_t number = 0u;
+                const size_t digitsStart = position;
+                while (position < value.size() && value[position] >= '0' && value[position] <= '9' && position - digitsStart < 6u)
+                    number = number * 10u + static_cast<uint32_t>(value[position++] - '0');
+
+                const bool separated = part == 3u ? position == value.size() : (position < value.size() && value[position] == '.');
+                if (position == digitsStart || number > 0xFFFFu || !separated)
+                {
+                    m_scratch.assign(value.data(), value.size());
+                    DriverVersionFromString(m_scratch, m_report.Adapter.DriverVersion);
+                    return;
+                }
+
+                version = (version << 16u) | number;
+                position++;
+            }
+            m_report.Adapter.DriverVersion = version;
+        }
+
+        void FinishReport()
+        {
+            if (m_foundHeader)
+            {
+                // Drop rows left over from earlier reports that this one doesn't have
+                for (auto row = m_report.Table.begin(); row != m_report.Table.end();)
+                {
+                    if (m_seenGeneration[row->first] != m_generation)
+                    {
+                        m_rows[row->first] = nullptr;
+                        row = m_report.Table.erase(row);
+                    }
+                    else
+                        ++row;
+                }
+
+                m_callback(m_chunk, m_report);
+                m_reports++;
+            }
+            ResetReport();
+        }
+
+        void ResetReport()
+        {
+            m_report.Adapter.Name = m_defaultName;
+            m_report.Adapter.VendorId = 0u;
+            m_report.Adapter.DeviceId = 0u;
+            m_report.Adapter.DriverVersion = 0u;
+            m_report.Capabilities.clear();
+            m_foundHeader = false;
+            m_inTable = false;
+            m_nextFormat = 0u;
+            m_generation++;
+        }
+
+        const char* m_defaultName;
+        const ReportCSVParser::ReportCallback& m_callback;
+        const FormatNames& m_formatNames;
+        const ScanFunction m_scan;
+
+        size_t m_chunk;
+        uint64_t m_reports;
+        SupportReport m_report;
+        bool m_foundHeader;
+        bool m_inTable;                             // After the header or a format row, until the report finishes
+        uint32_t m_nextFormat;
+        uint32_t m_generation;                      // Bumped per report
+        std::array<uint32_t, 256u> m_seenGeneration; // Per format, the report that last had a row for it
+        std::array<std::vector<FormatSupport>*, 256u> m_rows; // Per format, its row in the report's table, nodes don't move
+
+        std::vector<const char*> m_commas; // In the current line
+        std::string m_scratch;
+    };
+
+    const char* FindLineEnd(const char* line, const char* end)
+    {
+        const void* newline = std::memchr(line, '\n', static_cast<size_t>(end - line));
+        return newline ? static_cast<const char*>(newline) : end;
+    }
+
+    bool IsBlankLine(const char* line, const char* lineEnd)
+    {
+        return line == lineEnd || (lineEnd - line == 1 && *line == '\r');
+    }
+
+    // Blank and '#' lines never start or finish a report
+    bool IsSkippedLine(const char* line, const char* lineEnd)
+    {
+        return IsBlankLine(line, lineEnd) || *line == '#';
+    }
+
+    bool IsHeaderLine(const char* line, const char* lineEnd)
+    {
+        static const char header[] = "DXGI Format,";
+        return static_cast<size_t>(lineEnd - line) >= sizeof(header) - 1u && std::memcmp(line, header, sizeof(header) - 1u) == 0;
+    }
+
+    // Offset of the first report starting at or after offset. A report starts at the first
+    // line that isn't blank, a '#' line or a format row after the header or a format row, the
+    // same rule ChunkParser finishes reports by, so parsing chunks separately matches parsing
+    // the whole input.
+    size_t FindReportStart(const char* data, const size_t size, size_t offset)
+    {
+        const char* end = data + size;
+        const char* line = data + offset;
+        if (offset > 0u && data[offset - 1u] != '\n')
+        {
+            const char* lineEnd = FindLineEnd(line, end);
+            line = lineEnd == end ? end : lineEnd + 1;
+        }
+
+        // Whether the last line before this one that isn't skipped is the header or a format row
+        bool previousInTable = false;
+        for (const char* back = line; back > data;)
+        {
+            const char* previousEnd = back - 1;
+            const char* previousLine = previousEnd;
+            while (previousLine > data && previousLine[-1] != '\n')
+                previousLine--;
+            if (!IsSkippedLine(previousLine, previousEnd))
+            {
+                previousInTable = IsFormatLine(previousLine, previousEnd) || IsHeaderLine(previousLine, previousEnd);
+                break;
+            }
+            back = previousLine;
+        }
+
+        while (line < end)
+        {
+            const char* lineEnd = FindLineEnd(line, end);
+            if (!IsSkippedLine(line, lineEnd))
+            {
+                const bool isFormat = IsFormatLine(line, lineEnd);
+                if (!isFormat && previousInTable)
+                    return static_cast<size_t>(line - data);
+                previousInTable = isFormat || IsHeaderLine(line, lineEnd);
+            }
+            line = lineEnd == end ? end : lineEnd + 1;
+        }
+        return size;
+    }
+}
+
+void ReportCSVParser::Plan(const char* data, const size_t size, const uint32_t threadCount)
+{
+    m_data = data;
+    m_threadCount = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    m_chunkStarts.assign(1u, 0u);
+
+    const size_t target = std::clamp(size / (static_cast<size_t>(m_threadCount) * REPORT_PARSER_CHUNKS_PER_THREAD),
+        static_cast<size_t>(REPORT_PARSER_MIN_CHUNK_BYTES), static_cast<size_t>(REPORT_PARSER_MAX_CHUNK_BYTES));
+    while (m_chunkStarts.back() < size)
+    {
+        const size_t start = m_chunkStarts.back();
+        m_chunkStarts.push_back(size - start > target ? FindReportStart(data, size, start + target) : size);
+    }
+}
+
+ReportCSVParser::Stats ReportCSVParser::Parse(const char* defaultName, const ReportCallback& callback, const size_t firstChunk,
+    const size_t lastChunk) const
+{
+    Stats stats{ 0u, 0u, 0u, 0u };
+    if (firstChunk >= std::min(lastChunk, GetChunkCount()))
+        return stats;
+
+    const size_t last = std::min(lastChunk, GetChunkCount());
+    stats.Bytes = m_chunkStarts[last] - m_chunkStarts[firstChunk];
+    stats.Chunks = last - firstChunk;
+    stats.Threads = static_cast<uint32_t>(std::min<size_t>(m_threadCount, stats.Chunks));
+
+    // Workers take the next chunk off a shared counter until none are left
+    std::atomic<size_t> nextChunk{ firstChunk };
+    std::atomic<uint64_t> reports{ 0u };
+    const auto work = [&]()
+    {
+        ChunkParser parser(defaultName, callback);
+        for (size_t chunk = nextChunk++; chunk < last; chunk = nextChunk++)
+        {
+            TRACE_ZONE("Parse report chunk");
+            parser.Parse(chunk, m_data + m_chunkStarts[chunk], m_data + m_chunkStarts[chunk + 1u]);
+        }
+        reports += parser.GetReportCount();
+    };
+
+    std::vector<std::thread> workers;
+    for (uint32_t thread = 1u; thread < stats.Threads; ++thread)
+    {
+        workers.emplace_back([&work]()
+        {
+            SetTraceThreadName("Report parser");
+            work();
+        });
+    }
+    work();
+    for (std::thread& worker : workers)
+        worker.join();
+
+    stats.Reports = reports;
+    return stats;
+}
+
+const char* ReportCSVParser::GetScannerName()
+{
+    return GetScanner().Name;
+}
+
+bool ImportSupportReportsCSV(const std::filesystem::path& path, std::vector<SupportReport>& outReports, ReportCSVParser::Stats* outStats)
+{
+    return ImportSupportReportsCSV(path, [&outReports](const SupportReport& report) { outReports.push_back(report); }, outStats);
+}
+
+bool ImportSupportReportsCSV(const std::filesystem::path& path, const std::function<void(const SupportReport&)>& callback,
+    ReportCSVParser::Stats* outStats)
+{
+    MappedFile file;
+    if (!file.Open(path))
+        return false;
+
+    TRACE_ZONE("ImportSupportReportsCSV");
+    ReportCSVParser parser;
+    parser.Plan(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+
+    // A window of chunks per round, each chunk's reports kept apart so they're handed out in file order
+    const std::string defaultName = path.stem().u8string();
+    const size_t window = std::max<size_t>(1u, parser.GetChunkCount() < 2u ? 1u : std::thread::hardware_concurrency());
+    std::vector<std::vector<SupportReport>> chunkReports(window);
+    ReportCSVParser::Stats total{ 0u, 0u, 0u, 0u };
+    for (size_t first = 0u; first < parser.GetChunkCount(); first += window)
+    {
+        const ReportCSVParser::Stats stats = parser.Parse(defaultName.c_str(), [&](const size_t chunk, const SupportReport& report)
+        {
+            chunkReports[chunk - first].push_back(report);
+        }, first, first + window);
+
+        for (std::vector<SupportReport>& reports : chunkReports)
+        {
+            for (const SupportReport& report : reports)
+                callback(report);
+            reports.clear();
+        }
+
+        total.Bytes += stats.Bytes;
+        total.Reports += stats.Reports;
+        total.Chunks += stats.Chunks;
+        total.Threads = std::max(total.Threads, stats.Threads);
+    }
+
+    if (outStats)
+        *outStats = total;
+    return total.Reports > 0u;
+}
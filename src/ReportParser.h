@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "SupportTable.h"
+
+#define REPORT_PARSER_MIN_CHUNK_BYTES (1u << 20u) // Smaller inputs are parsed on the calling thread
+#define REPORT_PARSER_MAX_CHUNK_BYTES (4u << 20u) // Keeps windows of parsed reports small, see ImportSupportReportsCSV()
+
+// Parses the '.csv' layout ExportSupportReportCSV() writes, for inputs holding any number of
+// reports one after another. The input is split into chunks of whole reports, a report starting
+// at the first line after its predecessor's header or format rows that is neither a format row
+// nor a trailing '#' adapter line, and chunks are parsed on every core. Each chunk is scanned 64
+// bytes at a time for ',' and '\n' with AVX2 where the CPU has it, SSE2 otherwise or plain C++
+// elsewhere, into a bitmask of each, and lines and cells are read off the set bits without
+// looking at the bytes in between. A worker reuses one report for every report it parses, so
+// once warm parsing doesn't allocate.
+class ReportCSVParser
+{
+public:
+    struct Stats
+    {
+        uint64_t Bytes;
+        uint64_t Reports;
+        size_t Chunks;
+        uint32_t Threads;
+    };
+
+    // Called from the worker threads, reports of a chunk in input order. The report is reused
+    // once the callback returns, copy out whatever is kept.
+    using ReportCallback = std::function<void(const size_t chunk, const SupportReport& report)>;
+
+    // Splits data into chunks. The data has to outlive Parse().
+    void Plan(const char* data, const size_t size, const uint32_t threadCount = 0u); // 0 for one thread per core
+    size_t GetChunkCount() const { return m_chunkStarts.empty() ? 0u : m_chunkStarts.size() - 1u; }
+
+    // Parses chunks [firstChunk, lastChunk), reports without adapter lines are named defaultName
+    Stats Parse(const char* defaultName, const ReportCallback& callback) const { return Parse(defaultName, callback, 0u, GetChunkCount()); }
+    Stats Parse(const char* defaultName, const ReportCallback& callback, const size_t firstChunk, const size_t lastChunk) const;
+
+    static const char* GetScannerName(); // "AVX2", "SSE2" or "scalar", whichever this CPU runs
+
+private:
+    const char* m_data = nullptr;
+    std::vector<size_t> m_chunkStarts; // Chunk i is [m_chunkStarts[i], m_chunkStarts[i + 1])
+    uint32_t m_threadCount = 1u;
+};
+
+// Every report in a file, in file order, on every core for large files. Named after the
+// file when they have no adapter lines, like ImportSupportReportCSV().
+bool ImportSupportReportsCSV(const std::filesystem::path& path, std::vector<SupportReport>& outReports, ReportCSVParser::Stats* outStats = nullptr);
+
+// The same, handing the reports to callback in file order without keeping more than a few chunks' worth parsed at once
+bool ImportSupportReportsCSV(const std::filesystem::path& path, const std::function<void(const SupportReport&)>& callback,
+    ReportCSVParser::Stats* outStats = nullptr);
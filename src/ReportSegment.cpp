@@ -0,0 +1,476 @@
+#include "ReportSegment.h"
+
+#include <algorithm>
+
+#include "ReportStore.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define REPORT_PAYLOAD_MIN_CANONICAL_SIZE (8u) // Canonical magic and version
+
+namespace
+{
+    void PutLE(std::vector<uint8_t>& bytes, const uint64_t value, const size_t size)
+    {
+        for (size_t i = 0u; i < size; ++i)
+            bytes.push_back(static_cast<uint8_t>(value >> (8u * i)));
+    }
+
+    uint64_t GetLE(const uint8_t* bytes, const size_t size)
+    {
+        uint64_t value = 0u;
+        for (size_t i = size; i-- > 0u;)
+            value = (value << 8u) | bytes[i];
+        return value;
+    }
+
+    // The weight goes into the seed, weight 1 gives the payload-only checksum of version 1 records
+    uint32_t RecordChecksum(const uint8_t* payload, const uint32_t size, const uint32_t weight)
+    {
+        return static_cast<uint32_t>(HashBytes128(payload, size, REPORT_SEGMENT_MAGIC ^ (weight - 1u)).Low);
+    }
+
+    bool WriteAll(const int file, const uint8_t* bytes, size_t size)
+    {
+        while (size > 0u)
+        {
+#ifdef _WIN32
+            const int written = _write(file, bytes, static_cast<unsigned int>(std::min<size_t>(size, 1u << 30u)));
+#else
+            const ssize_t written = ::write(file, bytes, size);
+            if (written < 0 && errno == EINTR)
+                continue;
+#endif
+            if (written <= 0)
+                return false;
+
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool TruncateFile(const int file, const uint64_t size)
+    {
+#ifdef _WIN32
+        return _chsize_s(file, static_cast<__int64>(size)) == 0;
+#else
+        return ::ftruncate(file, static_cast<off_t>(size)) == 0;
+#endif
+    }
+}
+
+void EncodeReportPayload(const SupportReport& report, std::vector<uint8_t>& outPayload)
+{
+    std::vector<uint8_t> canonical;
+    EncodeCanonicalReport(report, canonical);
+
+    const size_t nameLength = std::min<size_t>(report.Adapter.Name.size(), UINT16_MAX);
+    outPayload.clear();
+    outPayload.reserve(2u + nameLength + canonical.size());
+    PutLE(outPayload, nameLength, 2u);
+    outPayload.insert(outPayload.end(), report.Adapter.Name.begin(), report.Adapter.Name.begin() + nameLength);
+    outPayload.insert(outPayload.end(), canonical.begin(), canonical.end());
+}
+
+bool DecodeReportPayload(const uint8_t* payload, const size_t size, SupportReport& outReport)
+{
+    if (!IsValidReportPayload(payload, size))
+        return false;
+
+    const size_t nameLength = static_cast<size_t>(GetLE(payload, 2u));
+    if (!DecodeCanonicalReport(payload + 2u + nameLength, size - 2u - nameLength, outReport))
+        return false;
+
+    outReport.Adapter.Name.assign(reinterpret_cast<const char*>(payload + 2u), nameLength);
+    return true;
+}
+
+bool IsValidReportPayload(const uint8_t* payload, const size_t size)
+{
+    if (size < 2u)
+        return false;
+
+    const size_t nameLength = static_cast<size_t>(GetLE(payload, 2u));
+    if (size - 2u < nameLength + REPORT_PAYLOAD_MIN_CANONICAL_SIZE)
+        return false;
+
+    const uint8_t* canonical = payload + 2u + nameLength;
+    return GetLE(canonical, 4u) == CANONICAL_REPORT_MAGIC && GetLE(canonical + 4u, 4u) == CANONICAL_REPORT_VERSION;
+}
+
+bool GetReportKey(const uint8_t* payload, const size_t size, const uint64_t timestamp, ReportKey& outKey)
+{
+    if (!IsValidReportPayload(payload, size))
+        return false;
+
+    // Vendor, device and driver follow the canonical magic and version
+    const size_t offset = 2u + static_cast<size_t>(GetLE(payload, 2u)) + REPORT_PAYLOAD_MIN_CANONICAL_SIZE;
+    if (size - offset < 16u)
+        return false;
+
+    outKey.VendorId = static_cast<uint32_t>(GetLE(payload + offset, 4u));
+    outKey.DeviceId = static_cast<uint32_t>(GetLE(payload + offset + 4u, 4u));
+    outKey.DriverVersion = GetLE(payload + offset + 8u, 8u);
+    outKey.Timestamp = timestamp;
+    return true;
+}
+
+void AppendSegmentRecord(const uint64_t timestamp, const uint8_t* payload, const uint32_t size, const uint32_t weight, std::vector<uint8_t>& outBytes)
+{
+    PutLE(outBytes, size, 4u);
+    PutLE(outBytes, RecordChecksum(payload, size, weight), 4u);
+    PutLE(outBytes, timestamp, 8u);
+    PutLE(outBytes, weight, 4u);
+    outBytes.insert(outBytes.end(), payload, payload + size);
+}
+
+bool SegmentWriter::Open(const std::filesystem::path& path)
+{
+    Close();
+    m_buffer.clear();
+    m_bufferedRecords = 0u;
+    m_recordCount = 0u;
+    m_index.clear();
+
+    // Keep what's intact of an existing segment, a crash mid-write leaves at most one torn record
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0u;
+    uint64_t validBytes = 0u;
+    if (fileSize >= REPORT_SEGMENT_HEADER_SIZE)
+    {
+        SegmentReader reader;
+        if (!reader.Open(path) || reader.IsSealed() || reader.GetVersion() != REPORT_SEGMENT_VERSION)
+            return false;
+
+        validBytes = reader.GetValidBytes();
+        m_recordCount = reader.GetRecordCount();
+        reader.Close();
+        if (validBytes != fileSize)
+            std::filesystem::resize_file(path, validBytes, error);
+    }
+    else if (fileSize > 0u)
+    {
+        std::filesystem::resize_file(path, 0u, error);
+    }
+    if (error)
+        return false;
+
+#ifdef _WIN32
+    m_file = _wopen(path.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    m_file = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+#endif
+    if (m_file < 0)
+        return false;
+
+    // Only a segment written from the start knows where all of its records are
+    m_sealable = validBytes == 0u;
+    m_syncedBytes = validBytes;
+    if (validBytes == 0u)
+    {
+        PutLE(m_buffer, REPORT_SEGMENT_MAGIC, 4u);
+        PutLE(m_buffer, REPORT_SEGMENT_VERSION, 4u);
+        return Sync();
+    }
+    return true;
+}
+
+void SegmentWriter::Close()
+{
+    if (m_file < 0)
+        return;
+
+    Sync();
+#ifdef _WIN32
+    _close(m_file);
+#else
+    ::close(m_file);
+#endif
+    m_file = -1;
+}
+
+void SegmentWriter::Append(const uint64_t timestamp, const uint8_t* payload, const uint32_t size, const uint32_t weight)
+{
+    const uint64_t offset = m_syncedBytes + m_buffer.size();
+    if (m_sealable && (m_index.empty() || offset - m_lastIndexedOffset >= REPORT_SEGMENT_INDEX_INTERVAL))
+    {
+        ReportKey key{};
+        m_sealable = GetReportKey(payload, size, timestamp, key);
+        PutLE(m_index, key.VendorId, 4u);
+        PutLE(m_index, key.DeviceId, 4u);
+        PutLE(m_index, key.DriverVersion, 8u);
+        PutLE(m_index, key.Timestamp, 8u);
+        PutLE(m_index, offset, 8u);
+        m_lastIndexedOffset = offset;
+    }
+
+    AppendSegmentRecord(timestamp, payload, size, weight, m_buffer);
+    m_bufferedRecords++;
+}
+
+void SegmentWriter::AppendEncoded(const uint8_t* records, const size_t size, const uint64_t recordCount)
+{
+    m_buffer.insert(m_buffer.end(), records, records + size);
+    m_bufferedRecords += recordCount;
+    m_sealable = false;
+}
+
+bool SegmentWriter::Sync()
+{
+    if (m_file < 0)
+        return false;
+    if (m_buffer.empty())
+        return true;
+
+#ifdef _WIN32
+    const bool synced = WriteAll(m_file, m_buffer.data(), m_buffer.size()) && _commit(m_file) == 0;
+#else
+    const bool synced = WriteAll(m_file, m_buffer.data(), m_buffer.size()) && ::fsync(m_file) == 0;
+#endif
+    if (!synced)
+    {
+        // Cut off whatever part of the buffer made it out, so a retry doesn't leave a torn record in front of it
+        TruncateFile(m_file, m_syncedBytes);
+        return false;
+    }
+
+    m_syncedBytes += m_buffer.size();
+    m_recordCount += m_bufferedRecords;
+    m_bufferedRecords = 0u;
+    m_buffer.clear();
+    return true;
+}
+
+bool SegmentWriter::Seal()
+{
+    if (m_file < 0 || !m_sealable)
+        return false;
+
+    const uint64_t indexOffset = m_syncedBytes + m_buffer.size();
+    m_buffer.insert(m_buffer.end(), m_index.begin(), m_index.end());
+    PutLE(m_buffer, indexOffset, 8u);
+    PutLE(m_buffer, m_recordCount + m_bufferedRecords, 8u);
+    PutLE(m_buffer, m_index.size() / REPORT_SEGMENT_INDEX_ENTRY_SIZE, 4u);
+    PutLE(m_buffer, REPORT_SEGMENT_SEALED_MAGIC, 4u);
+    if (!Sync())
+        return false;
+
+    m_sealable = false;
+    m_index.clear();
+    Close();
+    return true;
+}
+
+bool SegmentReader::Open(const std::filesystem::path& path)
+{
+    Close();
+    if (!m_file.Open(path))
+        return false;
+
+    const uint8_t* data = m_file.GetData();
+    const size_t size = m_file.GetSize();
+    const uint32_t version = size >= REPORT_SEGMENT_HEADER_SIZE ? static_cast<uint32_t>(GetLE(data + 4u, 4u)) : 0u;
+    if (size < REPORT_SEGMENT_HEADER_SIZE || GetLE(data, 4u) != REPORT_SEGMENT_MAGIC || version < 1u || version > REPORT_SEGMENT_VERSION)
+    {
+        Close();
+        return false;
+    }
+    m_version = version;
+    m_recordHeaderSize = version == 1u ? REPORT_SEGMENT_V1_RECORD_HEADER_SIZE : REPORT_SEGMENT_RECORD_HEADER_SIZE;
+
+    // Sealed when the trailer adds up, its index exactly fills the space before it
+    if (size >= REPORT_SEGMENT_HEADER_SIZE + REPORT_SEGMENT_TRAILER_SIZE && GetLE(data + size - 4u, 4u) == REPORT_SEGMENT_SEALED_MAGIC)
+    {
+        const uint8_t* trailer = data + size - REPORT_SEGMENT_TRAILER_SIZE;
+        const uint64_t indexOffset = GetLE(trailer, 8u);
+        const uint64_t recordCount = GetLE(trailer + 8u, 8u);
+        const uint32_t indexCount = static_cast<uint32_t>(GetLE(trailer + 16u, 4u));
+        if (indexOffset >= REPORT_SEGMENT_HEADER_SIZE
+            && indexOffset + static_cast<uint64_t>(indexCount) * REPORT_SEGMENT_INDEX_ENTRY_SIZE + REPORT_SEGMENT_TRAILER_SIZE == size)
+        {
+            m_sealed = true;
+            m_recordsEnd = static_cast<size_t>(indexOffset);
+            m_recordCount = recordCount;
+            m_index = data + indexOffset;
+            m_indexCount = indexCount;
+            return true;
+        }
+    }
+
+    // Unsealed, the records run until the first one that's torn or corrupt
+    m_recordsEnd = size;
+    size_t offset = REPORT_SEGMENT_HEADER_SIZE;
+    uint64_t timestamp = 0u;
+    const uint8_t* payload = nullptr;
+    uint32_t payloadSize = 0u;
+    uint32_t weight = 0u;
+    while (ReadRecord(offset, timestamp, payload, payloadSize, weight))
+    {
+        offset += m_recordHeaderSize + payloadSize;
+        m_recordCount++;
+    }
+    m_recordsEnd = offset;
+    return true;
+}
+
+void SegmentReader::Close()
+{
+    m_file.Close();
+    m_version = 0u;
+    m_recordHeaderSize = REPORT_SEGMENT_RECORD_HEADER_SIZE;
+    m_sealed = false;
+    m_recordsEnd = 0u;
+    m_recordCount = 0u;
+    m_index = nullptr;
+    m_indexCount = 0u;
+}
+
+bool SegmentReader::ReadRecord(const size_t offset, uint64_t& outTimestamp, const uint8_t*& outPayload, uint32_t& outSize, uint32_t& outWeight,
+    const bool verify) const
+{
+    if (m_recordsEnd - offset < m_recordHeaderSize)
+        return false;
+
+    const uint8_t* record = m_file.GetData() + offset;
+    const uint32_t size = static_cast<uint32_t>(GetLE(record, 4u));
+    const uint32_t weight = m_version == 1u ? 1u : static_cast<uint32_t>(GetLE(record + 16u, 4u));
+    if (m_recordsEnd - offset - m_recordHeaderSize < size || weight == 0u
+        || (verify && RecordChecksum(record + m_recordHeaderSize, size, weight) != static_cast<uint32_t>(GetLE(record + 4u, 4u))))
+        return false;
+
+    outTimestamp = GetLE(record + 8u, 8u);
+    outPayload = record + m_recordHeaderSize;
+    outSize = size;
+    outWeight = weight;
+    return true;
+}
+
+void SegmentReader::ForEach(const RecordCallback& callback) const
+{
+    if (!m_file.IsOpen())
+        return;
+
+    uint64_t timestamp = 0u;
+    const uint8_t* payload = nullptr;
+    uint32_t size = 0u;
+    uint32_t weight = 0u;
+    for (size_t offset = REPORT_SEGMENT_HEADER_SIZE; ReadRecord(offset, timestamp, payload, size, weight); offset += m_recordHeaderSize + size)
+        callback(timestamp, payload, size, weight);
+}
+
+void SegmentReader::Find(const ReportKey& first, const ReportKey& last, const RecordCallback& callback, uint32_t* outPagesTouched) const
+{
+    if (outPagesTouched)
+        *outPagesTouched = 0u;
+    if (!m_file.IsOpen())
+        return;
+
+    // Start at the last index entry before the range, the range can begin anywhere in its page
+    size_t start = REPORT_SEGMENT_HEADER_SIZE;
+    if (m_sealed)
+    {
+        const auto entryKey = [this](const uint32_t entry)
+        {
+            const uint8_t* bytes = m_index + static_cast<size_t>(entry) * REPORT_SEGMENT_INDEX_ENTRY_SIZE;
+            return ReportKey{ static_cast<uint32_t>(GetLE(bytes, 4u)), static_cast<uint32_t>(GetLE(bytes + 4u, 4u)), GetLE(bytes + 8u, 8u), GetLE(bytes + 16u, 8u) };
+        };
+
+        uint32_t low = 0u;
+        uint32_t high = m_indexCount;
+        while (low < high)
+        {
+            const uint32_t middle = low + (high - low) / 2u;
+            if (entryKey(middle) < first)
+                low = middle + 1u;
+            else
+                high = middle;
+        }
+        if (low > 0u)
+            start = static_cast<size_t>(GetLE(m_index + static_cast<size_t>(low - 1u) * REPORT_SEGMENT_INDEX_ENTRY_SIZE + 24u, 8u));
+    }
+
+    // The key is in the first few dozen bytes of a payload, a sealed segment's payloads are
+    // only checksummed, so read in full, when they match
+    uint32_t pagesTouched = 0u;
+    size_t nextPage = 0u;
+    const auto touch = [&pagesTouched, &nextPage](const size_t begin, const size_t end)
+    {
+        const size_t firstPage = std::max(nextPage, begin / REPORT_SEGMENT_INDEX_INTERVAL);
+        const size_t endPage = (end - 1u) / REPORT_SEGMENT_INDEX_INTERVAL + 1u;
+        if (endPage > firstPage)
+        {
+            pagesTouched += static_cast<uint32_t>(endPage - firstPage);
+            nextPage = endPage;
+        }
+    };
+
+    uint64_t timestamp = 0u;
+    const uint8_t* payload = nullptr;
+    uint32_t size = 0u;
+    uint32_t weight = 0u;
+    for (size_t offset = start; ReadRecord(offset, timestamp, payload, size, weight, !m_sealed); offset += m_recordHeaderSize + size)
+    {
+        const size_t keyBytes = 2u + static_cast<size_t>(size >= 2u ? GetLE(payload, 2u) : 0u) + REPORT_PAYLOAD_MIN_CANONICAL_SIZE + 16u;
+        touch(offset, offset + m_recordHeaderSize + (m_sealed ? std::min<size_t>(size, keyBytes) : size));
+
+        ReportKey key{};
+        if (!GetReportKey(payload, size, timestamp, key) || key < first)
+            continue;
+        if (last < key)
+        {
+            // Sorted, nothing further on can match
+            if (m_sealed)
+                break;
+            continue;
+        }
+
+        touch(offset, offset + m_recordHeaderSize + size);
+        if (m_sealed && RecordChecksum(payload, size, weight) != static_cast<uint32_t>(GetLE(payload - m_recordHeaderSize + 4u, 4u)))
+            continue;
+        callback(timestamp, payload, size, weight);
+    }
+
+    if (outPagesTouched)
+        *outPagesTouched = pagesTouched;
+}
+
+bool WriteSyncedFile(const std::filesystem::path& path, const uint8_t* bytes, const size_t size)
+{
+#ifdef _WIN32
+    const int file = _wopen(path.c_str(), _O_WRONLY | _O_TRUNC | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    const int file = ::open(path.c_str(), O_WRONLY | O_TRUNC | O_CREAT | O_CLOEXEC, 0644);
+#endif
+    if (file < 0)
+        return false;
+
+#ifdef _WIN32
+    const bool written = WriteAll(file, bytes, size) && _commit(file) == 0;
+    _close(file);
+#else
+    const bool written = WriteAll(file, bytes, size) && ::fsync(file) == 0;
+    ::close(file);
+#endif
+    return written;
+}
+
+bool ReadSegment(const std::filesystem::path& path, const SegmentReader::RecordCallback& callback, uint64_t* outValidBytes)
+{
+    SegmentReader reader;
+    if (!reader.Open(path))
+        return false;
+
+    reader.ForEach(callback);
+    if (outValidBytes)
+        *outValidBytes = reader.GetValidBytes();
+    return true;
+}
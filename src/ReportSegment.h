@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include "MappedFile.h"
+#include "SupportTable.h"
+
+#define REPORT_SEGMENT_MAGIC (0x47534644u) // "DFSG"
+#define REPORT_SEGMENT_VERSION (2u)
+#define REPORT_SEGMENT_HEADER_SIZE (8u)
+#define REPORT_SEGMENT_RECORD_HEADER_SIZE (20u)
+#define REPORT_SEGMENT_V1_RECORD_HEADER_SIZE (16u) // Version 1 records have no weight, it's 1
+#define REPORT_SEGMENT_SEALED_MAGIC (0x58534644u) // "DFSX"
+#define REPORT_SEGMENT_TRAILER_SIZE (24u)
+#define REPORT_SEGMENT_INDEX_ENTRY_SIZE (32u)
+#define REPORT_SEGMENT_INDEX_INTERVAL (4096u)     // Bytes of records per sparse index entry, a page
+
+// A report as sent to the collector and kept in segments: u16 adapter name length, the name,
+// then the canonical form from ReportStore.h, which starts with vendor, device and driver.
+void EncodeReportPayload(const SupportReport& report, std::vector<uint8_t>& outPayload);
+bool DecodeReportPayload(const uint8_t* payload, const size_t size, SupportReport& outReport);
+bool IsValidReportPayload(const uint8_t* payload, const size_t size); // Name and canonical header only, no decode
+
+// What sealed segments are sorted and indexed by
+struct ReportKey
+{
+    uint32_t VendorId;
+    uint32_t DeviceId;
+    uint64_t DriverVersion;
+    uint64_t Timestamp;
+
+    bool operator<(const ReportKey& other) const
+    {
+        return std::tie(VendorId, DeviceId, DriverVersion, Timestamp) < std::tie(other.VendorId, other.DeviceId, other.DriverVersion, other.Timestamp);
+    }
+};
+
+bool GetReportKey(const uint8_t* payload, const size_t size, const uint64_t timestamp, ReportKey& outKey);
+
+// Segment file: magic and version, then records appended one after another, each
+// u32 payload size, u32 checksum, u64 receive time (ms since the Unix epoch), u32 weight, payload.
+// The weight is how many identical reports the record stands for, 1 as received and summed
+// when compaction merges copies. The checksum covers the payload and the weight.
+// A sealed segment has its records in key order and ends with a sparse index, one
+// u32 vendor, u32 device, u64 driver, u64 timestamp, u64 offset entry for the first record
+// starting in every REPORT_SEGMENT_INDEX_INTERVAL bytes of records, then a trailer of
+// u64 index offset, u64 record count, u32 index entry count and the sealed magic.
+void AppendSegmentRecord(const uint64_t timestamp, const uint8_t* payload, const uint32_t size, const uint32_t weight, std::vector<uint8_t>& outBytes);
+
+// Appends records to a segment. Appends are buffered and nothing is on disk, let alone durable,
+// until Sync() writes the buffer with one write and one fsync, so callers batch as many records
+// per Sync() as their latency allows. Opening an existing segment drops a torn last record.
+class SegmentWriter
+{
+public:
+    ~SegmentWriter() { Close(); }
+
+    bool Open(const std::filesystem::path& path); // Sealed and version 1 segments can't be appended to
+    void Close(); // Syncs first
+
+    void Append(const uint64_t timestamp, const uint8_t* payload, const uint32_t size, const uint32_t weight = 1u);
+    void AppendEncoded(const uint8_t* records, const size_t size, const uint64_t recordCount); // Built with AppendSegmentRecord
+    bool Sync(); // On failure the buffered records are kept and the file is cut back to the last sync, call again to retry
+
+    // Writes the index and trailer and closes the segment. Only for segments this writer
+    // created, with every record appended through Append() in key order.
+    bool Seal();
+
+    bool IsOpen() const { return m_file >= 0; }
+    uint64_t GetRecordCount() const { return m_recordCount; }
+    uint64_t GetSyncedBytes() const { return m_syncedBytes; }
+
+private:
+    int m_file = -1;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_bufferedRecords = 0u;
+    uint64_t m_recordCount = 0u;
+    uint64_t m_syncedBytes = 0u;
+
+    bool m_sealable = false;
+    uint64_t m_lastIndexedOffset = 0u;
+    std::vector<uint8_t> m_index; // Entries so far
+};
+
+// Memory-mapped view of a segment. On a sealed segment a lookup binary searches the footer
+// index and reads only the page or two of records the key range falls in, an unsealed
+// segment is scanned.
+class SegmentReader
+{
+public:
+    using RecordCallback = std::function<void(const uint64_t timestamp, const uint8_t* payload, const uint32_t size, const uint32_t weight)>;
+
+    bool Open(const std::filesystem::path& path); // False when it can't be read or isn't a segment, version 1 segments read with weight 1
+    void Close();
+
+    bool IsSealed() const { return m_sealed; }
+    uint32_t GetVersion() const { return m_version; }
+    uint64_t GetRecordCount() const { return m_recordCount; }
+    uint64_t GetValidBytes() const { return m_recordsEnd; } // Where the intact records end
+
+    // Every intact record in file order, stopping at the first torn or corrupt one
+    void ForEach(const RecordCallback& callback) const;
+
+    // Records with first <= key <= last, in file order. outPagesTouched counts the record pages
+    // read, a sealed segment skips a corrupt record where a scan would stop at it.
+    void Find(const ReportKey& first, const ReportKey& last, const RecordCallback& callback, uint32_t* outPagesTouched = nullptr) const;
+
+private:
+    bool ReadRecord(const size_t offset, uint64_t& outTimestamp, const uint8_t*& outPayload, uint32_t& outSize, uint32_t& outWeight,
+        const bool verify = true) const;
+
+    MappedFile m_file;
+    uint32_t m_version = 0u;
+    size_t m_recordHeaderSize = REPORT_SEGMENT_RECORD_HEADER_SIZE;
+    bool m_sealed = false;
+    size_t m_recordsEnd = 0u;
+    uint64_t m_recordCount = 0u;
+    const uint8_t* m_index = nullptr;
+    uint32_t m_indexCount = 0u;
+};
+
+// Writes a whole small file and fsyncs it, e.g. a log that has to be on disk before a rename
+bool WriteSyncedFile(const std::filesystem::path& path, const uint8_t* bytes, const size_t size);
+
+// Walks every intact record, stopping at the first torn or corrupt one. False when the file
+// can't be read or isn't a segment. outValidBytes is where the intact records end.
+bool ReadSegment(const std::filesystem::path& path, const SegmentReader::RecordCallback& callback, uint64_t* outValidBytes = nullptr);
@@ -0,0 +1,372 @@
+#include "ReportStore.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#define REPORT_STORE_MAGIC (0x53534644u)     // "DFSS"
+#define REPORT_STORE_VERSION (1u)
+#define CANONICAL_MAX_CAPABILITIES (64u)
+
+namespace
+{
+    inline uint64_t RotateLeft64(const uint64_t value, const int shift)
+    {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    inline uint64_t FinalMix64(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdull;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ull;
+        k ^= k >> 33;
+        return k;
+    }
+
+    inline uint64_t ReadLE64(const uint8_t* bytes)
+    {
+        uint64_t value = 0u;
+        for (int i = 7; i >= 0; --i)
+            value = (value << 8) | bytes[i];
+        return value;
+    }
+
+    // Little endian writer/reader over a byte vector, the canonical form must not depend on the host
+    class ByteWriter
+    {
+    public:
+        explicit ByteWriter(std::vector<uint8_t>& bytes) : m_bytes(bytes) {}
+
+        void U16(const uint16_t value) { Put(value, 2u); }
+        void U32(const uint32_t value) { Put(value, 4u); }
+        void U64(const uint64_t value) { Put(value, 8u); }
+        void String(const std::string& value)
+        {
+            U16(static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX)));
+            m_bytes.insert(m_bytes.end(), value.begin(), value.begin() + std::min<size_t>(value.size(), UINT16_MAX));
+        }
+
+    private:
+        void Put(const uint64_t value, const size_t size)
+        {
+            for (size_t i = 0u; i < size; ++i)
+                m_bytes.push_back(static_cast<uint8_t>(value >> (8u * i)));
+        }
+
+        std::vector<uint8_t>& m_bytes;
+    };
+
+    class ByteReader
+    {
+    public:
+        ByteReader(const uint8_t* bytes, const size_t size) : m_bytes(bytes), m_size(size) {}
+
+        bool U16(uint16_t& value) { uint64_t v = 0; const bool ok = Get(v, 2u); value = static_cast<uint16_t>(v); return ok; }
+        bool U32(uint32_t& value) { uint64_t v = 0; const bool ok = Get(v, 4u); value = static_cast<uint32_t>(v); return ok; }
+        bool U64(uint64_t& value) { return Get(value, 8u); }
+        bool String(std::string& value)
+        {
+            uint16_t length = 0u;
+            if (!U16(length) || m_size - m_offset < length)
+                return false;
+
+            value.assign(reinterpret_cast<const char*>(m_bytes + m_offset), length);
+            m_offset += length;
+            return true;
+        }
+        bool Bytes(std::vector<uint8_t>& value, const size_t size)
+        {
+            if (m_size - m_offset < size)
+                return false;
+
+            value.assign(m_bytes + m_offset, m_bytes + m_offset + size);
+            m_offset += size;
+            return true;
+        }
+        bool AtEnd() const { return m_offset == m_size; }
+
+    private:
+        bool Get(uint64_t& value, const size_t size)
+        {
+            if (m_size - m_offset < size)
+                return false;
+
+            value = 0u;
+            for (size_t i = 0u; i < size; ++i)
+                value |= static_cast<uint64_t>(m_bytes[m_offset + i]) << (8u * i);
+            m_offset += size;
+            return true;
+        }
+
+        const uint8_t* m_bytes;
+        size_t m_size;
+        size_t m_offset = 0u;
+    };
+}
+
+Hash128 HashBytes128(const void* data, const size_t size, const uint32_t seed)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const size_t blockCount = size / 16u;
+    constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+    constexpr uint64_t c2 = 0x4cf5ad432745937full;
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+    for (size_t block = 0u; block < blockCount; ++block)
+    {
+        uint64_t k1 = ReadLE64(bytes + block * 16u);
+        uint64_t k2 = ReadLE64(bytes + block * 16u + 8u);
+
+        k1 *= c1; k1 = RotateLeft64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = RotateLeft64(h1, 27); h1 += h2; h1 = h1 * 5u + 0x52dce729u;
+
+        k2 *= c2; k2 = RotateLeft64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = RotateLeft64(h2, 31); h2 += h1; h2 = h2 * 5u + 0x38495ab5u;
+    }
+
+    // Up to 15 trailing bytes
+    const uint8_t* tail = bytes + blockCount * 16u;
+    uint64_t k1 = 0u;
+    uint64_t k2 = 0u;
+    switch (size & 15u)
+    {
+    case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48; [[fallthrough]];
+    case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40; [[fallthrough]];
+    case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32; [[fallthrough]];
+    case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24; [[fallthrough]];
+    case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16; [[fallthrough]];
+    case 10: k2 ^= static_cast<uint64_t>(tail[9]) << 8; [[fallthrough]];
+    case 9:
+        k2 ^= static_cast<uint64_t>(tail[8]);
+        k2 *= c2; k2 = RotateLeft64(k2, 33); k2 *= c1; h2 ^= k2;
+        [[fallthrough]];
+    case 8: k1 ^= static_cast<uint64_t>(tail[7]) << 56; [[fallthrough]];
+    case 7: k1 ^= static_cast<uint64_t>(tail[6]) << 48; [[fallthrough]];
+    case 6: k1 ^= static_cast<uint64_t>(tail[5]) << 40; [[fallthrough]];
+    case 5: k1 ^= static_cast<uint64_t>(tail[4]) << 32; [[fallthrough]];
+    case 4: k1 ^= static_cast<uint64_t>(tail[3]) << 24; [[fallthrough]];
+    case 3: k1 ^= static_cast<uint64_t>(tail[2]) << 16; [[fallthrough]];
+    case 2: k1 ^= static_cast<uint64_t>(tail[1]) << 8; [[fallthrough]];
+    case 1:
+        k1 ^= static_cast<uint64_t>(tail[0]);
+        k1 *= c1; k1 = RotateLeft64(k1, 31); k1 *= c2; h1 ^= k1;
+        break;
+    default:
+        break;
+    }
+
+    h1 ^= size;
+    h2 ^= size;
+    h1 += h2;
+    h2 += h1;
+    h1 = FinalMix64(h1);
+    h2 = FinalMix64(h2);
+    h1 += h2;
+    h2 += h1;
+    return Hash128{ h1, h2 };
+}
+
+void EncodeCanonicalReport(const SupportReport& report, std::vector<uint8_t>& outBytes)
+{
+    outBytes.clear();
+    ByteWriter writer(outBytes);
+    writer.U32(CANONICAL_REPORT_MAGIC);
+    writer.U32(CANONICAL_REPORT_VERSION);
+    writer.U32(report.Adapter.VendorId);
+    writer.U32(report.Adapter.DeviceId);
+    writer.U64(report.Adapter.DriverVersion);
+
+    // Capabilities by name, so column order doesn't change the bytes
+    const size_t capabilityCount = std::min<size_t>(report.Capabilities.size(), CANONICAL_MAX_CAPABILITIES);
+    std::vector<size_t> sortedColumns(capabilityCount);
+    for (size_t column = 0u; column < capabilityCount; ++column)
+        sortedColumns[column] = column;
+    std::sort(sortedColumns.begin(), sortedColumns.end(),
+        [&report](const size_t a, const size_t b) { return report.Capabilities[a] < report.Capabilities[b]; });
+
+    writer.U16(static_cast<uint16_t>(capabilityCount));
+    for (const size_t column : sortedColumns)
+        writer.String(report.Capabilities[column]);
+
+    std::vector<DXGI_FORMAT> formats;
+    formats.reserve(report.Table.size());
+    for (const auto& [format, supportFlags] : report.Table)
+        formats.push_back(format);
+    std::sort(formats.begin(), formats.end());
+
+    writer.U32(static_cast<uint32_t>(formats.size()));
+    for (const DXGI_FORMAT format : formats)
+    {
+        const std::vector<FormatSupport>& supportFlags = report.Table.at(format);
+        uint64_t passMask = 0u;
+        uint64_t knownMask = 0u;
+        for (size_t bit = 0u; bit < capabilityCount; ++bit)
+        {
+            const size_t column = sortedColumns[bit];
+            if (column >= supportFlags.size() || supportFlags[column] == FormatSupport::UNKN)
+                continue;
+
+            knownMask |= 1ull << bit;
+            if (supportFlags[column] == FormatSupport::PASS)
+                passMask |= 1ull << bit;
+        }
+
+        writer.U16(static_cast<uint16_t>(format));
+        writer.U64(passMask);
+        writer.U64(knownMask);
+    }
+}
+
+bool DecodeCanonicalReport(const uint8_t* bytes, const size_t size, SupportReport& outReport)
+{
+    ByteReader reader(bytes, size);
+    uint32_t magic = 0u;
+    uint32_t version = 0u;
+    SupportReport report;
+    if (!reader.U32(magic) || magic != CANONICAL_REPORT_MAGIC || !reader.U32(version) || version != CANONICAL_REPORT_VERSION)
+        return false;
+    if (!reader.U32(report.Adapter.VendorId) || !reader.U32(report.Adapter.DeviceId) || !reader.U64(report.Adapter.DriverVersion))
+        return false;
+
+    uint16_t capabilityCount = 0u;
+    if (!reader.U16(capabilityCount) || capabilityCount > CANONICAL_MAX_CAPABILITIES)
+        return false;
+
+    report.Capabilities.resize(capabilityCount);
+    for (std::string& capability : report.Capabilities)
+    {
+        if (!reader.String(capability))
+            return false;
+    }
+
+    uint32_t formatCount = 0u;
+    if (!reader.U32(formatCount))
+        return false;
+
+    for (uint32_t i = 0u; i < formatCount; ++i)
+    {
+        uint16_t format = 0u;
+        uint64_t passMask = 0u;
+        uint64_t knownMask = 0u;
+        if (!reader.U16(format) || !reader.U64(passMask) || !reader.U64(knownMask))
+            return false;
+
+        std::vector<FormatSupport> supportFlags(capabilityCount, FormatSupport::UNKN);
+        for (size_t bit = 0u; bit < capabilityCount; ++bit)
+        {
+            if ((knownMask >> bit) & 1u)
+                supportFlags[bit] = ((passMask >> bit) & 1u) ? FormatSupport::PASS : FormatSupport::FAIL;
+        }
+        report.Table[static_cast<DXGI_FORMAT>(format)] = std::move(supportFlags);
+    }
+
+    if (!reader.AtEnd())
+        return false;
+
+    outReport = std::move(report);
+    return true;
+}
+
+bool ReportStore::Add(const SupportReport& report, const uint64_t count)
+{
+    EncodeCanonicalReport(report, m_scratch);
+    const Hash128 hash = HashBytes128(m_scratch.data(), m_scratch.size());
+    return AddCanonical(hash, count, report.Adapter.Name, std::move(m_scratch));
+}
+
+bool ReportStore::AddCanonical(const Hash128& hash, const uint64_t count, const std::string& name, std::vector<uint8_t>&& bytes)
+{
+    m_reportCount += count;
+    const auto inserted = m_entryIndices.emplace(hash, m_entries.size());
+    if (!inserted.second)
+    {
+        m_entries[inserted.first->second].RefCount += count;
+        return false;
+    }
+
+    m_entries.push_back(Entry{ hash, count, name, std::move(bytes) });
+    return true;
+}
+
+size_t ReportStore::GetStoredBytes() const
+{
+    size_t bytes = 0u;
+    for (const Entry& entry : m_entries)
+        bytes += entry.Bytes.size() + entry.Name.size();
+    return bytes;
+}
+
+void ReportStore::ForEachReport(const std::function<void(const SupportReport&, const ReportSource&)>& callback) const
+{
+    SupportReport report;
+    for (const Entry& entry : m_entries)
+    {
+        if (!DecodeCanonicalReport(entry.Bytes.data(), entry.Bytes.size(), report))
+            continue;
+
+        report.Adapter.Name = entry.Name;
+        ReportSource source = MakeReportSource(report);
+        source.Weight = static_cast<uint32_t>(std::min<uint64_t>(entry.RefCount, UINT32_MAX));
+        callback(report, source);
+    }
+}
+
+bool ReportStore::Save(const std::filesystem::path& path) const
+{
+    std::vector<uint8_t> bytes;
+    ByteWriter writer(bytes);
+    writer.U32(REPORT_STORE_MAGIC);
+    writer.U32(REPORT_STORE_VERSION);
+    writer.U64(m_entries.size());
+    for (const Entry& entry : m_entries)
+    {
+        writer.U64(entry.Hash.Low);
+        writer.U64(entry.Hash.High);
+        writer.U64(entry.RefCount);
+        writer.String(entry.Name);
+        writer.U32(static_cast<uint32_t>(entry.Bytes.size()));
+        bytes.insert(bytes.end(), entry.Bytes.begin(), entry.Bytes.end());
+    }
+
+    std::ofstream outFile(path, std::ios::trunc | std::ios::out | std::ios::binary);
+    if (!outFile.is_open() || !outFile.good())
+        return false;
+
+    outFile.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return outFile.good();
+}
+
+bool ReportStore::Load(const std::filesystem::path& path)
+{
+    std::ifstream inFile(path, std::ios::in | std::ios::binary);
+    if (!inFile.is_open() || !inFile.good())
+        return false;
+
+    const std::vector<uint8_t> bytes{ std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>() };
+    ByteReader reader(bytes.data(), bytes.size());
+    uint32_t magic = 0u;
+    uint32_t version = 0u;
+    uint64_t entryCount = 0u;
+    if (!reader.U32(magic) || magic != REPORT_STORE_MAGIC || !reader.U32(version) || version != REPORT_STORE_VERSION || !reader.U64(entryCount))
+        return false;
+
+    // Validate the whole file before touching the store
+    std::vector<Entry> entries;
+    for (uint64_t i = 0u; i < entryCount; ++i)
+    {
+        Entry entry{};
+        uint32_t size = 0u;
+        if (!reader.U64(entry.Hash.Low) || !reader.U64(entry.Hash.High) || !reader.U64(entry.RefCount) || !reader.String(entry.Name)
+            || !reader.U32(size) || !reader.Bytes(entry.Bytes, size))
+            return false;
+
+        entries.push_back(std::move(entry));
+    }
+
+    for (Entry& entry : entries)
+        AddCanonical(entry.Hash, entry.RefCount, entry.Name, std::move(entry.Bytes));
+    return true;
+}
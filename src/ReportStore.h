@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SupportTable.h"
+
+#define CANONICAL_REPORT_MAGIC (0x52534644u) // "DFSR"
+#define CANONICAL_REPORT_VERSION (1u)
+
+struct Hash128
+{
+    uint64_t Low;
+    uint64_t High;
+
+    bool operator==(const Hash128& other) const { return Low == other.Low && High == other.High; }
+};
+
+struct Hash128Hasher
+{
+    size_t operator()(const Hash128& hash) const { return static_cast<size_t>(hash.Low); }
+};
+
+// MurmurHash3 x64 128, fast and well spread, not for anything adversarial
+Hash128 HashBytes128(const void* data, const size_t size, const uint32_t seed = 0u);
+
+// A report as sorted masks: the adapter's vendor, device and driver, the capability names in
+// sorted order, then per format in enum order one PASS and one known (PASS or FAIL) bit per
+// capability. Two reports of the same adapter with the same answers encode to the same bytes
+// however their columns and rows were ordered. The adapter name isn't part of it.
+// At most 64 capabilities, the rest are dropped.
+void EncodeCanonicalReport(const SupportReport& report, std::vector<uint8_t>& outBytes);
+bool DecodeCanonicalReport(const uint8_t* bytes, const size_t size, SupportReport& outReport);
+
+// Reports stored once per distinct canonical form with a count of how many times each was
+// added. Aggregation walks the unique reports with ReportSource::Weight set to that count,
+// so identical copies are never decoded or counted one by one.
+class ReportStore
+{
+public:
+    struct Entry
+    {
+        Hash128 Hash;
+        uint64_t RefCount;
+        std::string Name;           // First name seen for this content
+        std::vector<uint8_t> Bytes; // Canonical form
+    };
+
+    // True when the report is new to the store
+    bool Add(const SupportReport& report, const uint64_t count = 1u);
+
+    size_t GetUniqueCount() const { return m_entries.size(); }
+    uint64_t GetReportCount() const { return m_reportCount; }
+    size_t GetStoredBytes() const;
+    const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+    // Decodes every unique report once and hands it over with Weight set to its reference count
+    void ForEachReport(const std::function<void(const SupportReport&, const ReportSource&)>& callback) const;
+
+    // "DFSS" file: entry count, then hash, count, name and canonical bytes per entry. Load merges into the store.
+    bool Save(const std::filesystem::path& path) const;
+    bool Load(const std::filesystem::path& path);
+
+private:
+    bool AddCanonical(const Hash128& hash, const uint64_t count, const std::string& name, std::vector<uint8_t>&& bytes);
+
+    std::vector<Entry> m_entries; // In first-added order
+    std::unordered_map<Hash128, size_t, Hash128Hasher> m_entryIndices;
+    uint64_t m_reportCount = 0u;
+    std::vector<uint8_t> m_scratch;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Bounded queue for exactly one producer thread and one consumer thread, no locks.
+// Each side owns its index and only reads the other's, a slot is handed over by the
+// release store of the index that covers it. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SPSCQueue
+{
+    static_assert(Capacity != 0u && (Capacity & (Capacity - 1u)) == 0u, "Capacity must be a power of two");
+
+public:
+    // Producer only, false when full
+    bool TryPush(T&& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        m_slots[tail & (Capacity - 1u)] = std::move(value);
+        m_tail.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, false when empty
+    bool TryPop(T& outValue)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        outValue = std::move(m_slots[head & (Capacity - 1u)]);
+        m_head.store(head + 1u, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> m_slots;
+
+    // On their own cache lines so the two threads don't bounce one between them
+    alignas(64) std::atomic<size_t> m_head{ 0u }; // Next slot to pop, written by the consumer
+    alignas(64) std::atomic<size_t> m_tail{ 0u }; // Next slot to push, written by the producer
+};
@@ -0,0 +1,344 @@
+#include "SegmentedReportStore.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include "ReportStore.h"
+#include "Trace.h"
+
+#define SEGMENTED_STORE_EXTENSION ".dfsg"
+#define SEGMENTED_STORE_TEMP_EXTENSION ".tmp"
+#define SEGMENTED_STORE_MERGE_EXTENSION ".merge" // Names the inputs a merged segment of the same id replaces
+
+namespace
+{
+    // Segments are named by a 16 digit hex id, later ones have larger ids
+    bool ParseSegmentId(const std::filesystem::path& path, uint64_t& outId)
+    {
+        const std::string stem = path.stem().string();
+        if (stem.size() != 16u || stem.find_first_not_of("0123456789abcdef") != std::string::npos)
+            return false;
+
+        outId = std::strtoull(stem.c_str(), nullptr, 16);
+        return true;
+    }
+
+    struct RecordRef
+    {
+        ReportKey Key;
+        const uint8_t* Payload;
+        uint32_t Size;
+        uint64_t Weight; // Of every copy merged into it so far
+    };
+}
+
+bool SegmentedReportStore::Open(const std::filesystem::path& directory, const bool readOnly)
+{
+    StopBackgroundCompaction();
+    std::error_code error;
+    if (!readOnly)
+        std::filesystem::create_directories(directory, error);
+    if (!std::filesystem::is_directory(directory, error))
+        return false;
+
+    std::vector<std::pair<uint64_t, std::filesystem::path>> paths;
+    std::vector<std::filesystem::path> mergeLogs;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        uint64_t id = 0u;
+        if (!entry.is_regular_file() || !ParseSegmentId(entry.path(), id))
+            continue;
+
+        // A compaction that didn't finish, its inputs are all still there
+        if (entry.path().extension() == SEGMENTED_STORE_TEMP_EXTENSION && !readOnly)
+            std::filesystem::remove(entry.path(), error);
+        else if (entry.path().extension() == SEGMENTED_STORE_EXTENSION)
+            paths.emplace_back(id, entry.path());
+        else if (entry.path().extension() == SEGMENTED_STORE_MERGE_EXTENSION)
+            mergeLogs.push_back(entry.path());
+    }
+
+    // Inputs of a finished compaction that weren't deleted are already counted in its output.
+    // Without its output the compaction never finished and the inputs are all there is.
+    for (const std::filesystem::path& mergeLog : mergeLogs)
+    {
+        std::filesystem::path output = mergeLog;
+        output.replace_extension(SEGMENTED_STORE_EXTENSION);
+        if (std::filesystem::exists(output, error))
+        {
+            std::ifstream inFile(mergeLog);
+            std::string name;
+            while (std::getline(inFile, name))
+            {
+                const std::filesystem::path input = directory / name;
+                paths.erase(std::remove_if(paths.begin(), paths.end(), [&input](const auto& path) { return path.second == input; }), paths.end());
+                if (!readOnly)
+                    std::filesystem::remove(input, error);
+            }
+        }
+        if (!readOnly)
+            std::filesystem::remove(mergeLog, error);
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = directory;
+    m_segments.clear();
+    m_nextSegmentId = paths.empty() ? 1u : paths.back().first + 1u;
+    for (const auto& [id, path] : paths)
+    {
+        auto reader = std::make_shared<SegmentReader>();
+        if (reader->Open(path))
+            m_segments.push_back(Segment{ path, std::move(reader) });
+    }
+    return true;
+}
+
+std::filesystem::path SegmentedReportStore::NewSegmentPath()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 SEGMENTED_STORE_EXTENSION, m_nextSegmentId++);
+    return m_directory / name;
+}
+
+bool SegmentedReportStore::AddSegment(const std::filesystem::path& path)
+{
+    auto reader = std::make_shared<SegmentReader>();
+    if (!reader->Open(path))
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_segments.push_back(Segment{ path, std::move(reader) });
+    }
+    m_segmentAdded.notify_one();
+    return true;
+}
+
+bool SegmentedReportStore::Compact(const bool full, CompactionStats* outStats)
+{
+    TRACE_ZONE("SegmentedReportStore::Compact");
+    std::lock_guard<std::mutex> compactionLock(m_compactionMutex);
+    CompactionStats stats{};
+    std::vector<Segment> inputs = GetSegments();
+    if (!full)
+    {
+        // Smallest first, stopping at the first segment more than twice the size of everything before it
+        std::sort(inputs.begin(), inputs.end(),
+            [](const Segment& a, const Segment& b) { return a.Reader->GetValidBytes() < b.Reader->GetValidBytes(); });
+        uint64_t mergedBytes = 0u;
+        size_t count = 0u;
+        while (count < inputs.size() && (count < 2u || inputs[count].Reader->GetValidBytes() <= 2u * mergedBytes))
+            mergedBytes += inputs[count++].Reader->GetValidBytes();
+        inputs.resize(count);
+    }
+
+    if (inputs.empty() || (inputs.size() == 1u && inputs.front().Reader->IsSealed()))
+    {
+        if (outStats)
+            *outStats = stats;
+        return true;
+    }
+
+    // One record per distinct report, at its newest timestamp and weighted by every copy's weight
+    std::vector<RecordRef> records;
+    std::unordered_map<Hash128, size_t, Hash128Hasher> distinct;
+    for (const Segment& segment : inputs)
+    {
+        segment.Reader->ForEach([&](const uint64_t timestamp, const uint8_t* payload, const uint32_t size, const uint32_t weight)
+        {
+            stats.RecordsRead++;
+            stats.ReportsRead += weight;
+            ReportKey key{};
+            if (!GetReportKey(payload, size, timestamp, key))
+                return;
+
+            const auto [found, inserted] = distinct.emplace(HashBytes128(payload, size), records.size());
+            if (inserted)
+            {
+                records.push_back(RecordRef{ key, payload, size, weight });
+                return;
+            }
+
+            RecordRef& record = records[found->second];
+            record.Weight += weight;
+            if (record.Key.Timestamp < timestamp)
+            {
+                record.Key = key;
+                record.Payload = payload;
+            }
+        });
+    }
+
+    // A weight past what a record holds is split over several records of the same report
+    const size_t distinctCount = records.size();
+    std::vector<RecordRef> overflow;
+    for (RecordRef& record : records)
+    {
+        for (; record.Weight > UINT32_MAX; record.Weight -= UINT32_MAX)
+            overflow.push_back(RecordRef{ record.Key, record.Payload, record.Size, UINT32_MAX });
+    }
+    records.insert(records.end(), overflow.begin(), overflow.end());
+    std::stable_sort(records.begin(), records.end(), [](const RecordRef& a, const RecordRef& b) { return a.Key < b.Key; });
+
+    const std::filesystem::path path = NewSegmentPath();
+    std::filesystem::path tempPath = path;
+    tempPath.replace_extension(SEGMENTED_STORE_TEMP_EXTENSION);
+    SegmentWriter writer;
+    if (!writer.Open(tempPath))
+        return false;
+
+    bool written = true;
+    for (size_t i = 0u; i < records.size() && written; ++i)
+    {
+        writer.Append(records[i].Key.Timestamp, records[i].Payload, records[i].Size, static_cast<uint32_t>(records[i].Weight));
+        if ((i + 1u) % SEGMENTED_STORE_SYNC_RECORDS == 0u)
+            written = writer.Sync();
+    }
+
+    // Weights are summed, so the inputs must never be read next to the output. The log naming
+    // them is on disk before the rename makes the output visible, Open() finishes the deletes.
+    std::string inputNames;
+    for (const Segment& input : inputs)
+        inputNames += input.Path.filename().u8string() + "\n";
+    std::filesystem::path mergeLogPath = path;
+    mergeLogPath.replace_extension(SEGMENTED_STORE_MERGE_EXTENSION);
+
+    std::error_code error;
+    if (!written || !writer.Seal() || !WriteSyncedFile(mergeLogPath, reinterpret_cast<const uint8_t*>(inputNames.data()), inputNames.size()))
+    {
+        writer.Close();
+        std::filesystem::remove(tempPath, error);
+        std::filesystem::remove(mergeLogPath, error);
+        return false;
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tempPath, error);
+        std::filesystem::remove(mergeLogPath, error);
+        return false;
+    }
+
+    // Readable or not, the output now stands for the inputs
+    auto reader = std::make_shared<SegmentReader>();
+    const bool opened = reader->Open(path);
+
+    stats.SegmentsMerged = static_cast<uint32_t>(inputs.size());
+    stats.RecordsWritten = records.size();
+    stats.DuplicatesMerged = stats.RecordsRead - distinctCount;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const Segment& input : inputs)
+        {
+            m_segments.erase(std::remove_if(m_segments.begin(), m_segments.end(), [&input](const Segment& segment) { return segment.Path == input.Path; }),
+                m_segments.end());
+        }
+        if (opened)
+            m_segments.push_back(Segment{ path, std::move(reader) });
+    }
+
+    // A lookup still holding an old segment keeps its mapping, where that blocks deleting the
+    // file it's left behind with the log, and the next Open() deletes it
+    records.clear();
+    bool inputsRemoved = true;
+    for (Segment& input : inputs)
+    {
+        input.Reader.reset();
+        inputsRemoved = std::filesystem::remove(input.Path, error) && inputsRemoved;
+    }
+    if (inputsRemoved)
+        std::filesystem::remove(mergeLogPath, error);
+
+    if (outStats)
+        *outStats = stats;
+    return opened;
+}
+
+void SegmentedReportStore::StartBackgroundCompaction(const uint32_t segmentThreshold)
+{
+    StopBackgroundCompaction();
+    m_compactionThreshold = std::max(2u, segmentThreshold);
+    m_stopCompaction = false;
+    m_compactionThread = std::thread(&SegmentedReportStore::CompactionLoop, this);
+}
+
+void SegmentedReportStore::StopBackgroundCompaction()
+{
+    if (!m_compactionThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopCompaction = true;
+    }
+    m_segmentAdded.notify_one();
+    m_compactionThread.join();
+}
+
+size_t SegmentedReportStore::GetSegmentCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_segments.size();
+}
+
+uint64_t SegmentedReportStore::GetRecordCount() const
+{
+    uint64_t count = 0u;
+    for (const Segment& segment : GetSegments())
+        count += segment.Reader->GetRecordCount();
+    return count;
+}
+
+void SegmentedReportStore::Find(const ReportKey& first, const ReportKey& last, const SegmentReader::RecordCallback& callback,
+    uint32_t* outPagesTouched) const
+{
+    uint32_t pagesTouched = 0u;
+    for (const Segment& segment : GetSegments())
+    {
+        uint32_t segmentPages = 0u;
+        segment.Reader->Find(first, last, callback, &segmentPages);
+        pagesTouched += segmentPages;
+    }
+
+    if (outPagesTouched)
+        *outPagesTouched = pagesTouched;
+}
+
+void SegmentedReportStore::ForEach(const SegmentReader::RecordCallback& callback) const
+{
+    for (const Segment& segment : GetSegments())
+        segment.Reader->ForEach(callback);
+}
+
+std::vector<SegmentedReportStore::Segment> SegmentedReportStore::GetSegments() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_segments;
+}
+
+void SegmentedReportStore::CompactionLoop()
+{
+    SetTraceThreadName("Store compaction");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    size_t minSegments = m_compactionThreshold;
+    for (;;)
+    {
+        m_segmentAdded.wait(lock, [this, &minSegments]() { return m_stopCompaction || m_segments.size() >= minSegments; });
+        if (m_stopCompaction)
+            break;
+
+        // Don't spin on a compaction that fails, e.g. a full disk, wait for another segment first
+        lock.unlock();
+        const bool compacted = Compact(false);
+        lock.lock();
+        minSegments = compacted ? m_compactionThreshold : m_segments.size() + 1u;
+    }
+}
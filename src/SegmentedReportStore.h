@@ -0,0 +1,76 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ReportSegment.h"
+
+#define SEGMENTED_STORE_COMPACTION_THRESHOLD (4u) // Segments before a background compaction
+#define SEGMENTED_STORE_SYNC_RECORDS (4096u)      // Records per write while compacting
+
+// An archive of reports as a directory of segments. Writers such as the collector take a new
+// path from NewSegmentPath(), fill it and hand it over with AddSegment(). Compaction merges
+// segments into one sealed segment in key order, folding identical reports into one record at
+// the newest copy's timestamp whose weight is the sum of theirs, so lookups by adapter key touch
+// one index and a page or two per segment and fleet counts still see every machine. The merged
+// segment replaces the old ones with a rename, a crash part way leaves the inputs next to it,
+// and the next compaction merges them again. It doesn't lose or double count reports.
+// Background compactions are size tiered, only segments about as large as the smaller ones
+// together are merged, so the bulk of the archive isn't rewritten for every new segment.
+class SegmentedReportStore
+{
+public:
+    struct CompactionStats
+    {
+        uint32_t SegmentsMerged;
+        uint64_t RecordsRead;
+        uint64_t RecordsWritten;
+        uint64_t DuplicatesMerged; // Records folded into another with the same report
+        uint64_t ReportsRead;      // Sum of the weights read, what the written records still add up to
+    };
+
+    ~SegmentedReportStore() { StopBackgroundCompaction(); }
+
+    // Created when missing. Read only doesn't create it or clean up after a crashed compaction, for
+    // reading a store a collector may be writing to, and it must not be compacted or added to.
+    bool Open(const std::filesystem::path& directory, const bool readOnly = false);
+    std::filesystem::path NewSegmentPath();
+    bool AddSegment(const std::filesystem::path& path); // A closed segment, from NewSegmentPath()
+
+    // Merges every segment when full, otherwise the smaller ones as a background compaction does
+    bool Compact(const bool full, CompactionStats* outStats = nullptr);
+    void StartBackgroundCompaction(const uint32_t segmentThreshold = SEGMENTED_STORE_COMPACTION_THRESHOLD);
+    void StopBackgroundCompaction();
+
+    size_t GetSegmentCount() const;
+    uint64_t GetRecordCount() const;
+
+    // Records with first <= key <= last from every segment. outPagesTouched sums the record pages read.
+    void Find(const ReportKey& first, const ReportKey& last, const SegmentReader::RecordCallback& callback, uint32_t* outPagesTouched = nullptr) const;
+    void ForEach(const SegmentReader::RecordCallback& callback) const;
+
+private:
+    struct Segment
+    {
+        std::filesystem::path Path;
+        std::shared_ptr<SegmentReader> Reader; // Kept alive by lookups and compactions still reading it
+    };
+
+    std::vector<Segment> GetSegments() const;
+    void CompactionLoop();
+
+    std::filesystem::path m_directory;
+    mutable std::mutex m_mutex;
+    std::vector<Segment> m_segments;
+    uint64_t m_nextSegmentId = 0u;
+
+    std::mutex m_compactionMutex; // One compaction at a time
+    std::thread m_compactionThread;
+    std::condition_variable m_segmentAdded;
+    uint32_t m_compactionThreshold = SEGMENTED_STORE_COMPACTION_THRESHOLD;
+    bool m_stopCompaction = false;
+};
@@ -0,0 +1,210 @@
+#include "StatusBadge.h"
+#include "SupportTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+StatusBadgeRenderer::StatusBadgeRenderer()
+    : m_baked(false)
+{
+    m_badges[0] = Badge{ "UNKN", ImGui::ColorConvertFloat4ToU32(ImVec4{ 0.1f, 0.1f, 0.1f, 1.0f }), -1, {}, {}, {} };
+    m_badges[1] = Badge{ "FAIL", ImGui::ColorConvertFloat4ToU32(ImVec4{ 0.8f, 0.1f, 0.15f, 1.0f }), -1, {}, {}, {} };
+    m_badges[2] = Badge{ "PASS", ImGui::ColorConvertFloat4ToU32(ImVec4{ 0.2f, 0.7f, 0.2f, 1.0f }), -1, {}, {}, {} };
+}
+
+void StatusBadgeRenderer::BakeIntoAtlas(ImFontAtlas& atlas)
+{
+    if (atlas.ConfigData.empty())
+    {
+        // What AddFontDefault() sets up without a config, the pixel font isn't meant to be oversampled
+        ImFontConfig config;
+        config.SizePixels = STATUS_BADGE_FONT_SIZE;
+        config.OversampleH = 1;
+        config.OversampleV = 1;
+        config.PixelSnapH = true;
+        atlas.AddFontDefault(&config);
+    }
+
+    // Glyph metrics aren't known until the atlas is built, so reserve a conservative
+    // font-size square per character and record the width actually used afterwards.
+    const int cellSize = GetCellSize(atlas);
+    for (Badge& badge : m_badges)
+        badge.AtlasRectId = atlas.AddCustomRectRegular(cellSize * static_cast<int>(std::strlen(badge.Label)), cellSize);
+
+    if (!atlas.Build())
+        return;
+
+    unsigned char* pixels = nullptr;
+    int texWidth = 0;
+    int texHeight = 0;
+    atlas.GetTexDataAsAlpha8(&pixels, &texWidth, &texHeight);
+
+    const ImFont* font = atlas.Fonts[0];
+    for (Badge& badge : m_badges)
+    {
+        const ImFontAtlasCustomRect* rect = atlas.GetCustomRectByIndex(badge.AtlasRectId);
+
+        // Copy each glyph's coverage out of the atlas into the label's rect, laid out like AddText would
+        float penX = 0.0f;
+        for (const char* c = badge.Label; *c != '\0'; ++c)
+        {
+            const ImFontGlyph* glyph = font->FindGlyph(static_cast<ImWchar>(*c));
+            if (!glyph)
+                continue;
+
+            const int dstX0 = static_cast<int>(std::floor(penX + glyph->X0));
+            const int dstY0 = static_cast<int>(std::floor(glyph->Y0));
+            const int dstWidth = static_cast<int>(glyph->X1 - glyph->X0);
+            const int dstHeight = static_cast<int>(glyph->Y1 - glyph->Y0);
+            const float srcX0 = glyph->U0 * texWidth;
+            const float srcY0 = glyph->V0 * texHeight;
+            const float srcStepX = dstWidth > 0 ? (glyph->U1 - glyph->U0) * texWidth / dstWidth : 0.0f; // Handles oversampled fonts
+            const float srcStepY = dstHeight > 0 ? (glyph->V1 - glyph->V0) * texHeight / dstHeight : 0.0f;
+
+            for (int y = 0; y < dstHeight; ++y)
+            {
+                const int rectY = dstY0 + y;
+                if (rectY < 0 || rectY >= rect->Height)
+                    continue;
+
+                const int srcY = static_cast<int>(srcY0 + (y + 0.5f) * srcStepY);
+                for (int x = 0; x < dstWidth; ++x)
+                {
+                    const int rectX = dstX0 + x;
+                    if (rectX < 0 || rectX >= rect->Width)
+                        continue;
+
+                    const int srcX = static_cast<int>(srcX0 + (x + 0.5f) * srcStepX);
+                    pixels[(rect->Y + rectY) * texWidth + rect->X + rectX] = pixels[srcY * texWidth + srcX];
+                }
+            }
+            penX += glyph->AdvanceX;
+        }
+
+        ResolveLabel(atlas, badge);
+    }
+    m_baked = true;
+}
+
+bool StatusBadgeRenderer::AttachToAtlas(const ImFontAtlas& atlas)
+{
+    if (!atlas.IsBuilt() || atlas.ConfigData.empty() || atlas.CustomRects.Size < static_cast<int>(m_badges.size()))
+        return false;
+
+    // BakeIntoAtlas() adds the label rects first, before the atlas adds its own
+    const int cellSize = GetCellSize(atlas);
+    for (size_t i = 0u; i < m_badges.size(); ++i)
+    {
+        const ImFontAtlasCustomRect& rect = atlas.CustomRects[static_cast<int>(i)];
+        if (rect.Width != cellSize * static_cast<int>(std::strlen(m_badges[i].Label)) || rect.Height != cellSize)
+            return false;
+    }
+
+    for (size_t i = 0u; i < m_badges.size(); ++i)
+    {
+        m_badges[i].AtlasRectId = static_cast<int>(i);
+        ResolveLabel(atlas, m_badges[i]);
+    }
+    m_baked = true;
+    return true;
+}
+
+std::string StatusBadgeRenderer::GetAtlasKey(ImFontAtlas& atlas) const
+{
+    std::string key = "ProggyClean.ttf, " + std::to_string(STATUS_BADGE_FONT_SIZE) + " px, ranges";
+    char range[8];
+    for (const ImWchar* c = atlas.GetGlyphRangesDefault(); *c != 0; ++c)
+    {
+        std::snprintf(range, sizeof(range), " %04X", static_cast<unsigned int>(*c));
+        key += range;
+    }
+
+    key += ", labels";
+    for (const Badge& badge : m_badges)
+        key += std::string(" ") + badge.Label;
+    return key;
+}
+
+int StatusBadgeRenderer::GetCellSize(const ImFontAtlas& atlas)
+{
+    return static_cast<int>(std::ceil(atlas.ConfigData[0].SizePixels));
+}
+
+void StatusBadgeRenderer::ResolveLabel(const ImFontAtlas& atlas, Badge& badge)
+{
+    const ImFont* font = atlas.Fonts[0];
+    float labelWidth = 0.0f;
+    for (const char* c = badge.Label; *c != '\0'; ++c)
+    {
+        if (const ImFontGlyph* glyph = font->FindGlyph(static_cast<ImWchar>(*c)))
+            labelWidth += glyph->AdvanceX;
+    }
+
+    const ImFontAtlasCustomRect& rect = atlas.CustomRects[badge.AtlasRectId];
+    badge.LabelSize = ImVec2{ std::min(std::ceil(labelWidth), static_cast<float>(rect.Width)), std::min(font->FontSize, static_cast<float>(rect.Height)) };
+    atlas.CalcCustomRectUV(&rect, &badge.UVMin, &badge.UVMax);
+    badge.UVMax = ImVec2{ badge.UVMin.x + badge.LabelSize.x * atlas.TexUvScale.x, badge.UVMin.y + badge.LabelSize.y * atlas.TexUvScale.y };
+}
+
+ImVec2 StatusBadgeRenderer::GetSize() const
+{
+    ImVec2 labelSize{ 0.0f, 0.0f };
+    for (const Badge& badge : m_badges)
+    {
+        const ImVec2 size = m_baked ? badge.LabelSize : ImGui::CalcTextSize(badge.Label);
+        labelSize = ImVec2{ std::max(labelSize.x, size.x), std::max(labelSize.y, size.y) };
+    }
+
+    const ImVec2 padding = ImGui::GetStyle().FramePadding;
+    return ImVec2{ labelSize.x + padding.x * 2.0f, labelSize.y + padding.y * 2.0f };
+}
+
+void StatusBadgeRenderer::Draw(const FormatSupport support) const
+{
+    const ImVec2 size = GetSize();
+    const ImVec2 min = ImGui::GetCursorScreenPos();
+
+    // Layout only: no ID, so nothing to hash, hover-test or navigate to
+    ImGui::Dummy(size);
+    if (!ImGui::IsItemVisible())
+        return;
+
+    DrawBadge(*ImGui::GetWindowDrawList(), min, ImVec2{ min.x + size.x, min.y + size.y }, support);
+}
+
+void StatusBadgeRenderer::DrawBadge(ImDrawList& drawList, const ImVec2& min, const ImVec2& max, const FormatSupport support) const
+{
+    const Badge& badge = m_badges[BadgeIndex(support)];
+    const ImVec2 size{ max.x - min.x, max.y - min.y };
+    const ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+    if (!m_baked)
+    {
+        const ImVec2 labelSize = ImGui::CalcTextSize(badge.Label);
+        drawList.AddRectFilled(min, max, badge.Color);
+        drawList.AddText(ImVec2{ min.x + (size.x - labelSize.x) * 0.5f, min.y + (size.y - labelSize.y) * 0.5f }, textColor, badge.Label);
+        return;
+    }
+
+    // Snap the label to whole pixels so the baked texels map 1:1
+    const ImVec2 labelMin{ std::floor(min.x + (size.x - badge.LabelSize.x) * 0.5f), std::floor(min.y + (size.y - badge.LabelSize.y) * 0.5f) };
+    const ImVec2 labelMax{ labelMin.x + badge.LabelSize.x, labelMin.y + badge.LabelSize.y };
+
+    drawList.PrimReserve(12, 8);
+    drawList.PrimRect(min, max, badge.Color);
+    drawList.PrimRectUV(labelMin, labelMax, badge.UVMin, badge.UVMax, textColor);
+}
+
+size_t StatusBadgeRenderer::BadgeIndex(const FormatSupport support)
+{
+    switch (support)
+    {
+    case FormatSupport::FAIL: return 1u;
+    case FormatSupport::PASS: return 2u;
+
+    case FormatSupport::UNKN:
+    default:
+        return 0u;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "../ImGui/imgui.h"
+
+enum class FormatSupport : int8_t;
+
+#define STATUS_BADGE_FONT_SIZE (13.0f) // Of the default font BakeIntoAtlas() adds to an atlas without fonts
+
+// Draws the PASS/FAIL/UNKN table cells straight into the window's draw list.
+// Each label is pre-rendered into the font atlas as a single image, so a badge costs
+// two quads (background + label) instead of a Button's frame plus one quad per glyph,
+// and skips the ID hashing, hit-testing and style stack of a widget.
+class StatusBadgeRenderer
+{
+public:
+    StatusBadgeRenderer();
+
+    // Reserve space for the labels in the atlas, build it and copy the label glyph runs in.
+    // Must run before the renderer backend uploads the font texture.
+    void BakeIntoAtlas(ImFontAtlas& atlas);
+
+    // For an atlas BakeIntoAtlas() built before, e.g. one loaded from a cache: picks up the
+    // label rects instead of adding them. False when the atlas doesn't have them.
+    bool AttachToAtlas(const ImFontAtlas& atlas);
+
+    // Everything that decides what BakeIntoAtlas() puts in an atlas without fonts: font, size,
+    // glyph ranges and the labels, for keying a cache of it
+    std::string GetAtlasKey(ImFontAtlas& atlas) const;
+
+    // Submit a badge at the cursor and advance the layout like an item of the same size.
+    void Draw(const FormatSupport support) const;
+
+    // Write a badge filling [min, max] into drawList, for callers doing their own layout and clipping
+    void DrawBadge(ImDrawList& drawList, const ImVec2& min, const ImVec2& max, const FormatSupport support) const;
+
+    ImVec2 GetSize() const;
+
+private:
+    struct Badge
+    {
+        const char* Label;
+        ImU32 Color;
+        int AtlasRectId;
+        ImVec2 LabelSize;
+        ImVec2 UVMin;
+        ImVec2 UVMax;
+    };
+
+    static size_t BadgeIndex(const FormatSupport support);
+    static int GetCellSize(const ImFontAtlas& atlas);
+    static void ResolveLabel(const ImFontAtlas& atlas, Badge& badge); // Size and UVs of a label already in its rect
+
+    std::array<Badge, 3> m_badges; // UNKN, FAIL, PASS
+    bool m_baked;
+};
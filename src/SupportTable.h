@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <dxgiformat.h>
+
+// Corresponds number of bit flags checked in CreateFormatSupportTable()
+// or the number of column headers minus one
+#define SUPPORT_FLAGS_COUNT (8)
+
+// One bit per support flag, bit i is column i of the support flags
+enum FormatUsageFlags : uint32_t
+{
+    FormatUsage_None         = 0,
+    FormatUsage_Texture1D    = 1 << 0,
+    FormatUsage_Texture2D    = 1 << 1,
+    FormatUsage_Texture3D    = 1 << 2,
+    FormatUsage_TextureCube  = 1 << 3,
+    FormatUsage_RenderTarget = 1 << 4,
+    FormatUsage_DepthStencil = 1 << 5,
+    FormatUsage_Display      = 1 << 6,
+    FormatUsage_Mip          = 1 << 7,
+};
+
+enum class FormatSupport : int8_t
+{
+    UNKN = -1,
+    FAIL = 0,
+    PASS = 1,
+
+    COUNT
+};
+
+struct GPUInfo
+{
+    size_t VRAMBytes; 
+    size_t SharedSystemMemBytes; // GPU resources in RAM aka things in upload heaps
+    std::string MaxFeatureLevel;
+    std::string Name;
+    uint32_t VendorId;       // PCI vendor, 0 when unknown e.g. a report exported before adapter info was written
+    uint32_t DeviceId;
+    uint64_t DriverVersion;  // UMD version as four 16 bit parts, most significant first
+
+    GPUInfo()
+        : VRAMBytes(0), SharedSystemMemBytes(0), VendorId(0u), DeviceId(0u), DriverVersion(0u) {}
+};
+
+// One entry per format, one flag per table header after the format name column
+using SupportTable = std::unordered_map<DXGI_FORMAT, std::vector<FormatSupport>>;
+
+// A support table plus where it came from, e.g. an imported '.csv' file
+struct SupportReport
+{
+    GPUInfo Adapter;
+    std::vector<std::string> Capabilities; // Column headers after the format name
+    SupportTable Table;
+};
+
+// Non-owning view of one report as fed to the comparison and fleet views
+struct ReportSource
+{
+    const char* Name;
+    uint32_t VendorId;
+    std::vector<const char*> Capabilities;
+    const SupportTable* Table;
+    uint32_t Weight = 1u; // How many identical reports this one stands for, see ReportStore
+};
+
+inline ReportSource MakeReportSource(const SupportReport& report)
+{
+    ReportSource source{ report.Adapter.Name.c_str(), report.Adapter.VendorId, {}, &report.Table };
+    for (const std::string& capability : report.Capabilities)
+        source.Capabilities.push_back(capability.c_str());
+    return source;
+}
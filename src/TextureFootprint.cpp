@@ -0,0 +1,276 @@
+#include "TextureFootprint.h"
+#include "FormatInfo.h"
+
+#include <algorithm>
+
+namespace
+{
+    // How one plane of a format is stored. Chroma planes of video formats are subsampled by
+    // 1 << SubsampleShift texels, depth/stencil formats copy depth and stencil as separate planes.
+    struct PlaneLayout
+    {
+        DXGI_FORMAT Format;
+        uint32_t BytesPerBlock;
+        uint32_t BlockWidth;
+        uint32_t BlockHeight;
+        uint32_t SubsampleShiftX;
+        uint32_t SubsampleShiftY;
+    };
+
+    PlaneLayout GetPlaneLayout(const DXGI_FORMAT format, const uint32_t plane)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R32G8X24_TYPELESS:
+        case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+        case DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS:
+        case DXGI_FORMAT_X32_TYPELESS_G8X24_UINT:
+        case DXGI_FORMAT_R24G8_TYPELESS:
+        case DXGI_FORMAT_D24_UNORM_S8_UINT:
+        case DXGI_FORMAT_R24_UNORM_X8_TYPELESS:
+        case DXGI_FORMAT_X24_TYPELESS_G8_UINT:
+            return plane == 0u ? PlaneLayout{ DXGI_FORMAT_R32_TYPELESS, 4u, 1u, 1u, 0u, 0u } : PlaneLayout{ DXGI_FORMAT_R8_TYPELESS, 1u, 1u, 1u, 0u, 0u };
+
+        case DXGI_FORMAT_NV12:
+        case DXGI_FORMAT_420_OPAQUE:
+            return plane == 0u ? PlaneLayout{ DXGI_FORMAT_R8_TYPELESS, 1u, 1u, 1u, 0u, 0u } : PlaneLayout{ DXGI_FORMAT_R8G8_TYPELESS, 2u, 1u, 1u, 1u, 1u };
+        case DXGI_FORMAT_P010:
+        case DXGI_FORMAT_P016:
+            return plane == 0u ? PlaneLayout{ DXGI_FORMAT_R16_TYPELESS, 2u, 1u, 1u, 0u, 0u } : PlaneLayout{ DXGI_FORMAT_R16G16_TYPELESS, 4u, 1u, 1u, 1u, 1u };
+        case DXGI_FORMAT_NV11:
+            return plane == 0u ? PlaneLayout{ DXGI_FORMAT_R8_TYPELESS, 1u, 1u, 1u, 0u, 0u } : PlaneLayout{ DXGI_FORMAT_R8G8_TYPELESS, 2u, 1u, 1u, 2u, 0u };
+        case DXGI_FORMAT_P208:
+            return plane == 0u ? PlaneLayout{ DXGI_FORMAT_R8_TYPELESS, 1u, 1u, 1u, 0u, 0u } : PlaneLayout{ DXGI_FORMAT_R8G8_TYPELESS, 2u, 1u, 1u, 1u, 0u };
+        case DXGI_FORMAT_V208:
+            return PlaneLayout{ DXGI_FORMAT_R8_TYPELESS, 1u, 1u, 1u, 0u, plane == 0u ? 0u : 1u };
+        case DXGI_FORMAT_V408:
+            return PlaneLayout{ DXGI_FORMAT_R8_TYPELESS, 1u, 1u, 1u, 0u, 0u };
+
+        default:
+        {
+            const FormatInfo& info = GetFormatInfo(format);
+            return PlaneLayout{ format, info.BytesPerBlock, info.BlockWidth, info.BlockHeight, 0u, 0u };
+        }
+        }
+    }
+
+    // The top level has to be whole blocks and, for subsampled planes, whole chroma samples
+    bool IsWholeBlocks(const DXGI_FORMAT format, const uint32_t width, const uint32_t height)
+    {
+        for (uint32_t plane = 0u; plane < GetFormatInfo(format).PlaneCount; ++plane)
+        {
+            const PlaneLayout layout = GetPlaneLayout(format, plane);
+            if (width % (layout.BlockWidth << layout.SubsampleShiftX) != 0u || height % (layout.BlockHeight << layout.SubsampleShiftY) != 0u)
+                return false;
+        }
+        return true;
+    }
+
+    constexpr uint64_t AlignUp(const uint64_t value, const uint64_t alignment)
+    {
+        return (value + alignment - 1u) & ~(alignment - 1u);
+    }
+
+    constexpr uint32_t DivideRoundUp(const uint32_t value, const uint32_t divisor)
+    {
+        return (value + divisor - 1u) / divisor;
+    }
+}
+
+uint32_t CalculateFullMipCount(const TextureDesc& desc)
+{
+    uint32_t largest = desc.Width;
+    if (desc.Dimension != TextureDimension::Texture1D)
+        largest = std::max(largest, desc.Height);
+    if (desc.Dimension == TextureDimension::Texture3D)
+        largest = std::max(largest, desc.DepthOrArraySize);
+
+    uint32_t mipCount = 1u;
+    while (largest > 1u)
+    {
+        largest >>= 1u;
+        mipCount++;
+    }
+    return mipCount;
+}
+
+void AppendFootprintValidationDescs(const DXGI_FORMAT format, std::vector<TextureDesc>& outDescs)
+{
+    const auto append = [format, &outDescs](const TextureDimension dimension, const uint32_t width, const uint32_t height, const uint32_t depthOrArraySize)
+    {
+        TextureDesc desc{ format, dimension, width, height, depthOrArraySize, 1u, 1u };
+        outDescs.push_back(desc);
+
+        desc.MipLevels = CalculateFullMipCount(desc);
+        if (desc.MipLevels > 1u)
+            outDescs.push_back(desc);
+    };
+
+    constexpr uint32_t sizes2D[][2] = { { 1u, 1u }, { 4u, 4u }, { 17u, 9u }, { 64u, 64u }, { 256u, 128u }, { 1000u, 600u }, { 1024u, 1024u }, { 4096u, 4096u } };
+    for (const auto& size : sizes2D)
+    {
+        append(TextureDimension::Texture2D, size[0], size[1], 1u);
+        append(TextureDimension::Texture2D, size[0], size[1], 6u);
+    }
+
+    append(TextureDimension::Texture1D, 1u, 1u, 1u);
+    append(TextureDimension::Texture1D, 300u, 1u, 1u);
+    append(TextureDimension::Texture3D, 4u, 4u, 4u);
+    append(TextureDimension::Texture3D, 64u, 32u, 16u);
+}
+
+bool CalculateTextureFootprint(const TextureDesc& desc, TextureFootprint& outFootprint, std::vector<SubresourceFootprint>* outLayouts)
+{
+    const FormatInfo& info = GetFormatInfo(desc.Format);
+    if (info.Channels == 0u || desc.Width == 0u || desc.Height == 0u || desc.DepthOrArraySize == 0u || desc.SampleCount == 0u)
+        return false;
+
+    const bool is1D = desc.Dimension == TextureDimension::Texture1D;
+    const bool is3D = desc.Dimension == TextureDimension::Texture3D;
+    const bool isVideo = (info.Flags & FormatInfoFlags_Video) != 0;
+    const bool isDepth = (info.Flags & (FormatInfoFlags_Depth | FormatInfoFlags_Stencil)) != 0 || info.PlaneCount > 1u;
+    const uint32_t fullMipCount = CalculateFullMipCount(desc);
+    const uint32_t mipLevels = desc.MipLevels ? desc.MipLevels : fullMipCount;
+
+    // The combinations the runtime refuses to create
+    if (mipLevels > fullMipCount || (is1D && desc.Height != 1u))
+        return false;
+    if (is1D && (info.Flags & FormatInfoFlags_BlockCompressed))
+        return false;
+    if (is3D && (isDepth || isVideo))
+        return false;
+    if (desc.SampleCount > 1u && (is1D || is3D || mipLevels > 1u))
+        return false;
+    if (isVideo && info.PlaneCount > 1u && mipLevels > 1u)
+        return false;
+
+    const uint32_t arraySize = is3D ? 1u : desc.DepthOrArraySize;
+    const uint32_t planeCount = info.PlaneCount;
+
+    if (!IsWholeBlocks(desc.Format, desc.Width, is1D ? 1u : desc.Height))
+        return false;
+
+    if (outLayouts)
+        outLayouts->clear();
+
+    uint64_t offset = 0u;
+    uint64_t totalBytes = 0u;
+    for (uint32_t plane = 0u; plane < planeCount; ++plane)
+    {
+        const PlaneLayout layout = GetPlaneLayout(desc.Format, plane);
+        for (uint32_t slice = 0u; slice < arraySize; ++slice)
+        {
+            for (uint32_t mip = 0u; mip < mipLevels; ++mip)
+            {
+                const uint32_t width = std::max(1u, desc.Width >> mip) >> layout.SubsampleShiftX;
+                const uint32_t height = (is1D ? 1u : std::max(1u, desc.Height >> mip)) >> layout.SubsampleShiftY;
+                const uint32_t depth = is3D ? std::max(1u, desc.DepthOrArraySize >> mip) : 1u;
+
+                const uint32_t blocksWide = DivideRoundUp(std::max(1u, width), layout.BlockWidth);
+                const uint32_t blocksHigh = DivideRoundUp(std::max(1u, height), layout.BlockHeight);
+
+                SubresourceFootprint footprint;
+                footprint.Offset = AlignUp(offset, FOOTPRINT_PLACEMENT_ALIGNMENT);
+                footprint.Format = layout.Format;
+                footprint.Width = blocksWide * layout.BlockWidth;
+                footprint.Height = blocksHigh * layout.BlockHeight;
+                footprint.Depth = depth;
+                footprint.RowSizeInBytes = static_cast<uint64_t>(blocksWide) * layout.BytesPerBlock;
+                footprint.RowPitch = static_cast<uint32_t>(AlignUp(footprint.RowSizeInBytes, FOOTPRINT_ROW_PITCH_ALIGNMENT));
+                footprint.NumRows = blocksHigh;
+
+                // The last row of a subresource isn't padded out to the pitch
+                const uint64_t rows = static_cast<uint64_t>(footprint.NumRows) * depth;
+                totalBytes = footprint.Offset + footprint.RowPitch * (rows - 1u) + footprint.RowSizeInBytes;
+                offset = footprint.Offset + footprint.RowPitch * rows;
+
+                if (outLayouts)
+                    outLayouts->push_back(footprint);
+            }
+        }
+    }
+
+    const bool isMSAA = desc.SampleCount > 1u;
+    outFootprint.CopyableBytes = totalBytes;
+    outFootprint.PlacementAlignment = isMSAA ? FOOTPRINT_MSAA_RESOURCE_ALIGNMENT : FOOTPRINT_RESOURCE_ALIGNMENT;
+    outFootprint.PlacedBytesEstimate = AlignUp(offset * desc.SampleCount, outFootprint.PlacementAlignment);
+    outFootprint.MipLevels = mipLevels;
+    outFootprint.SubresourceCount = mipLevels * arraySize * planeCount;
+    return true;
+}
+
+void FootprintTable::Build(const std::vector<DXGI_FORMAT>& formats, const std::vector<uint32_t>& widths, const std::vector<uint32_t>& heights,
+    const uint32_t maxMipLevels, const uint32_t arraySize)
+{
+    m_formats = formats;
+    m_sizeCount = std::min(widths.size(), heights.size());
+    m_maxMipLevels = std::max(1u, maxMipLevels);
+    m_copyableBytes.assign(m_formats.size() * m_sizeCount * m_maxMipLevels, 0u);
+
+    // Scratch rows, one lane per size
+    const size_t lanes = m_sizeCount;
+    std::vector<uint64_t> rowSize(lanes), rowPitch(lanes), numRows(lanes);
+    std::vector<uint64_t> offset(lanes), totalBytes(lanes);
+    std::vector<uint32_t> fullMipCount(lanes);
+    std::vector<uint8_t> sizeValid(lanes);
+
+    for (size_t size = 0u; size < lanes; ++size)
+    {
+        const TextureDesc desc{ DXGI_FORMAT_UNKNOWN, TextureDimension::Texture2D, widths[size], heights[size], arraySize, 0u, 1u };
+        fullMipCount[size] = CalculateFullMipCount(desc);
+    }
+
+    for (size_t format = 0u; format < m_formats.size(); ++format)
+    {
+        const FormatInfo& info = GetFormatInfo(m_formats[format]);
+        const bool isVideo = (info.Flags & FormatInfoFlags_Video) != 0;
+        if (info.Channels == 0u)
+            continue;
+
+        // Same rules as CalculateTextureFootprint() for the sizes this format can't take
+        for (size_t size = 0u; size < lanes; ++size)
+        {
+            const bool valid = widths[size] != 0u && heights[size] != 0u && arraySize != 0u && IsWholeBlocks(m_formats[format], widths[size], heights[size]);
+            sizeValid[size] = valid ? 1u : 0u;
+        }
+
+        const uint32_t maxMips = (isVideo && info.PlaneCount > 1u) ? 1u : m_maxMipLevels;
+        uint64_t* formatBytes = &m_copyableBytes[format * m_sizeCount * m_maxMipLevels];
+        for (uint32_t mipLevels = 1u; mipLevels <= maxMips; ++mipLevels)
+        {
+            // Walk the subresources in D3D12 order, every size advancing in lock step
+            std::fill(offset.begin(), offset.end(), 0u);
+            std::fill(totalBytes.begin(), totalBytes.end(), 0u);
+            for (uint32_t plane = 0u; plane < info.PlaneCount; ++plane)
+            {
+                const PlaneLayout layout = GetPlaneLayout(m_formats[format], plane);
+                for (uint32_t slice = 0u; slice < arraySize; ++slice)
+                {
+                    for (uint32_t mip = 0u; mip < mipLevels; ++mip)
+                    {
+                        for (size_t size = 0u; size < lanes; ++size)
+                        {
+                            const uint32_t width = std::max(1u, std::max(1u, widths[size] >> mip) >> layout.SubsampleShiftX);
+                            const uint32_t height = std::max(1u, std::max(1u, heights[size] >> mip) >> layout.SubsampleShiftY);
+                            rowSize[size] = static_cast<uint64_t>((width + layout.BlockWidth - 1u) / layout.BlockWidth) * layout.BytesPerBlock;
+                            numRows[size] = (height + layout.BlockHeight - 1u) / layout.BlockHeight;
+                        }
+                        for (size_t size = 0u; size < lanes; ++size)
+                        {
+                            rowPitch[size] = AlignUp(rowSize[size], FOOTPRINT_ROW_PITCH_ALIGNMENT);
+                            const uint64_t start = AlignUp(offset[size], FOOTPRINT_PLACEMENT_ALIGNMENT);
+                            totalBytes[size] = start + rowPitch[size] * (numRows[size] - 1u) + rowSize[size];
+                            offset[size] = start + rowPitch[size] * numRows[size];
+                        }
+                    }
+                }
+            }
+
+            for (size_t size = 0u; size < lanes; ++size)
+            {
+                const bool valid = sizeValid[size] && mipLevels <= fullMipCount[size];
+                formatBytes[size * m_maxMipLevels + (mipLevels - 1u)] = valid ? totalBytes[size] : 0u;
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <dxgiformat.h>
+
+// Alignments D3D12 lays copyable footprints and placed resources out with
+#define FOOTPRINT_ROW_PITCH_ALIGNMENT (256u)               // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+#define FOOTPRINT_PLACEMENT_ALIGNMENT (512u)               // D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+#define FOOTPRINT_RESOURCE_ALIGNMENT (64u * 1024u)         // D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT
+#define FOOTPRINT_MSAA_RESOURCE_ALIGNMENT (4u * 1024u * 1024u) // D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT
+
+enum class TextureDimension : uint8_t
+{
+    Texture1D,
+    Texture2D,
+    Texture3D,
+};
+
+struct TextureDesc
+{
+    DXGI_FORMAT Format;
+    TextureDimension Dimension;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t DepthOrArraySize;
+    uint32_t MipLevels;   // 0 for the full chain
+    uint32_t SampleCount;
+};
+
+// Matches D3D12_PLACED_SUBRESOURCE_FOOTPRINT plus the row count and size GetCopyableFootprints returns
+struct SubresourceFootprint
+{
+    uint64_t Offset;
+    DXGI_FORMAT Format; // Per plane, e.g. R32_TYPELESS for the depth plane of D24S8
+    uint32_t Width;     // In texels, rounded up to whole blocks
+    uint32_t Height;
+    uint32_t Depth;
+    uint32_t RowPitch;
+    uint32_t NumRows;
+    uint64_t RowSizeInBytes;
+};
+
+struct TextureFootprint
+{
+    uint64_t CopyableBytes;       // GetCopyableFootprints' total bytes, the upload/readback buffer size
+    uint64_t PlacedBytesEstimate; // Linear layout rounded up to PlacementAlignment, the driver's tiled layout may differ
+    uint64_t PlacementAlignment;
+    uint32_t MipLevels;
+    uint32_t SubresourceCount;
+};
+
+// What ID3D12Device::GetCopyableFootprints returned for a desc, to check the CPU version against.
+// TotalBytes is UINT64_MAX and Layouts is empty where the device rejected the desc.
+struct FootprintRecord
+{
+    TextureDesc Desc;
+    uint64_t TotalBytes;
+    std::vector<SubresourceFootprint> Layouts;
+};
+
+uint32_t CalculateFullMipCount(const TextureDesc& desc);
+
+// A spread of 1D/2D/3D sizes, mip chains and array sizes for one format, valid and invalid,
+// used to record device footprints and to check CalculateTextureFootprint() against them
+void AppendFootprintValidationDescs(const DXGI_FORMAT format, std::vector<TextureDesc>& outDescs);
+
+// CPU-side GetCopyableFootprints over every subresource (mips, then array slices, then planes),
+// no device needed. outLayouts may be null. Returns false for descs D3D12 would reject.
+bool CalculateTextureFootprint(const TextureDesc& desc, TextureFootprint& outFootprint, std::vector<SubresourceFootprint>* outLayouts = nullptr);
+
+// Copyable bytes of every format x size x mip count combination of 2D textures (arrays).
+// Computed a format and mip level at a time across every size, so the inner loops are
+// straight-line integer maths over flat arrays that the compiler vectorises.
+class FootprintTable
+{
+public:
+    void Build(const std::vector<DXGI_FORMAT>& formats, const std::vector<uint32_t>& widths, const std::vector<uint32_t>& heights,
+        const uint32_t maxMipLevels, const uint32_t arraySize);
+
+    // 0 where the combination isn't valid, e.g. more mips than the size has
+    uint64_t GetCopyableBytes(const size_t format, const size_t size, const uint32_t mipLevels) const
+    {
+        return m_copyableBytes[(format * m_sizeCount + size) * m_maxMipLevels + (mipLevels - 1u)];
+    }
+
+    const std::vector<DXGI_FORMAT>& GetFormats() const { return m_formats; }
+    size_t GetSizeCount() const { return m_sizeCount; }
+    uint32_t GetMaxMipLevels() const { return m_maxMipLevels; }
+
+private:
+    std::vector<DXGI_FORMAT> m_formats;
+    size_t m_sizeCount = 0u;
+    uint32_t m_maxMipLevels = 0u;
+    std::vector<uint64_t> m_copyableBytes; // [format][size][mipLevels - 1]
+};
@@ -0,0 +1,243 @@
+#include "TimelineView.h"
+#include "DriverTimeline.h"
+#include "FormatSearch.h"
+#include "StatusBadge.h"
+#include "Utils.h"
+
+#include "../ImGui/imgui.h"
+
+#include <algorithm>
+#include <cstdio>
+
+TimelineView::TimelineView()
+    : m_timelines(nullptr)
+    , m_timeline(0u)
+    , m_capability(0u)
+    , m_onlyChanged(false)
+    , m_rowHeaderWidth(0.0f)
+    , m_columnWidth(0.0f)
+{
+}
+
+void TimelineView::SetTimelines(const DriverTimelineSet& timelines, const uint32_t vendorId, const uint32_t deviceId)
+{
+    m_timelines = &timelines;
+
+    const DriverTimeline* preferred = timelines.Find(vendorId, deviceId);
+    Select(preferred ? static_cast<size_t>(preferred - timelines.GetTimelines().data()) : 0u, m_capability);
+}
+
+void TimelineView::Select(const size_t timeline, const size_t capability)
+{
+    m_timeline = timeline;
+    m_capability = capability;
+    m_driverNames.clear();
+    m_cells.clear();
+    m_rowChanges.clear();
+    m_rowHeaderWidth = 0.0f;
+    if (!m_timelines || m_timeline >= m_timelines->GetTimelines().size())
+        return;
+
+    const DriverTimeline& selected = m_timelines->GetTimelines()[m_timeline];
+    m_capability = std::min(m_capability, selected.GetCapabilities().empty() ? 0u : selected.GetCapabilities().size() - 1u);
+
+    // One pass over the deltas fills every column
+    const size_t rowCount = selected.GetFormats().size();
+    const size_t versionCount = selected.GetVersionCount();
+    const uint64_t bit = 1ull << m_capability;
+    m_cells.resize(rowCount * versionCount);
+    m_driverNames.reserve(versionCount);
+    selected.Replay([&](const size_t version, const uint64_t driverVersion, const std::vector<DriverTimeline::RowState>& rows)
+    {
+        m_driverNames.push_back(DriverVersionToString(driverVersion));
+        for (size_t row = 0u; row < rowCount; ++row)
+        {
+            const FormatSupport support = !(rows[row].Known & bit) ? FormatSupport::UNKN : (rows[row].Pass & bit) ? FormatSupport::PASS : FormatSupport::FAIL;
+            m_cells[row * versionCount + version] = support;
+        }
+    });
+
+    m_rowChanges.assign(rowCount, false);
+    for (size_t row = 0u; row < rowCount; ++row)
+    {
+        for (size_t version = 1u; version < versionCount && !m_rowChanges[row]; ++version)
+            m_rowChanges[row] = HasChanged(row, version);
+    }
+}
+
+void TimelineView::Draw(const StatusBadgeRenderer& badges, const FormatSearchIndex& search)
+{
+    const std::vector<DriverTimeline>* timelines = m_timelines ? &m_timelines->GetTimelines() : nullptr;
+    if (!timelines || timelines->empty())
+    {
+        ImGui::Text("No driver history, import '.csv' reports of the same adapter from different drivers");
+        return;
+    }
+
+    // Adapter and capability pickers
+    const DriverTimeline& selected = (*timelines)[m_timeline];
+    char label[160];
+    std::snprintf(label, sizeof(label), "%s (%04X:%04X), %zu drivers", selected.GetName().c_str(), selected.GetVendorId(), selected.GetDeviceId(),
+        selected.GetVersionCount());
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 22.0f);
+    if (ImGui::BeginCombo("##Adapter", label))
+    {
+        for (size_t timeline = 0u; timeline < timelines->size(); ++timeline)
+        {
+            const DriverTimeline& option = (*timelines)[timeline];
+            std::snprintf(label, sizeof(label), "%s (%04X:%04X), %zu drivers##%zu", option.GetName().c_str(), option.GetVendorId(), option.GetDeviceId(),
+                option.GetVersionCount(), timeline);
+            if (ImGui::Selectable(label, timeline == m_timeline))
+                Select(timeline, m_capability);
+        }
+        ImGui::EndCombo();
+    }
+
+    // Picking an adapter re-selects, so look it up again
+    const DriverTimeline& timeline = (*timelines)[m_timeline];
+    const std::vector<std::string>& capabilities = timeline.GetCapabilities();
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.0f);
+    if (!capabilities.empty() && ImGui::BeginCombo("##Capability", capabilities[m_capability].c_str()))
+    {
+        for (size_t capability = 0u; capability < capabilities.size(); ++capability)
+        {
+            if (ImGui::Selectable(capabilities[capability].c_str(), capability == m_capability))
+                Select(m_timeline, capability);
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Only formats that changed", &m_onlyChanged);
+    ImGui::SameLine();
+    ImGui::Text("%zu bytes of history", timeline.GetEncodedBytes());
+
+    const std::vector<DXGI_FORMAT>& formats = timeline.GetFormats();
+    const size_t columnCount = m_driverNames.size();
+    m_visibleRows.clear();
+    for (uint32_t row = 0u; row < formats.size(); ++row)
+    {
+        if (search.IsVisible(formats[row]) && (!m_onlyChanged || m_rowChanges[row]))
+            m_visibleRows.push_back(row);
+    }
+
+    const ImGuiStyle& style = ImGui::GetStyle();
+    const ImVec2 badgeSize = badges.GetSize();
+    if (m_rowHeaderWidth <= 0.0f)
+    {
+        for (const DXGI_FORMAT format : formats)
+            m_rowHeaderWidth = std::max(m_rowHeaderWidth, ImGui::CalcTextSize(D3DFormatToString(format)).x);
+        m_rowHeaderWidth += style.CellPadding.x * 2.0f;
+
+        m_columnWidth = badgeSize.x;
+        for (const std::string& driverName : m_driverNames)
+            m_columnWidth = std::max(m_columnWidth, ImGui::CalcTextSize(driverName.c_str()).x);
+        m_columnWidth += style.CellPadding.x * 2.0f;
+    }
+
+    const float cellWidth = m_columnWidth;
+    const float cellHeight = badgeSize.y + 2.0f;
+    const float headerHeight = ImGui::GetTextLineHeightWithSpacing();
+
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0.0f, 0.0f });
+    ImGui::BeginChild("##Timeline", ImVec2{ 0.0f, 0.0f }, ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGui::PopStyleVar();
+
+    // Only the extents go through layout, the cells are written straight to the draw list
+    ImGui::Dummy(ImVec2{ m_rowHeaderWidth + columnCount * cellWidth, headerHeight + m_visibleRows.size() * cellHeight });
+
+    const ImVec2 windowPos = ImGui::GetWindowPos();
+    const ImVec2 windowSize = ImGui::GetWindowSize();
+    const float scrollX = ImGui::GetScrollX();
+    const float scrollY = ImGui::GetScrollY();
+    const ImVec2 viewMin = windowPos;
+    const ImVec2 viewMax{ windowPos.x + windowSize.x - (ImGui::GetScrollMaxY() > 0.0f ? style.ScrollbarSize : 0.0f),
+                          windowPos.y + windowSize.y - (ImGui::GetScrollMaxX() > 0.0f ? style.ScrollbarSize : 0.0f) };
+    const ImVec2 cellsMin{ viewMin.x + m_rowHeaderWidth, viewMin.y + headerHeight };
+
+    // Visible window of the grid
+    const size_t firstColumn = static_cast<size_t>(scrollX / cellWidth);
+    const size_t lastColumn = std::min(columnCount, static_cast<size_t>((scrollX + viewMax.x - cellsMin.x) / cellWidth) + 1u);
+    const size_t firstRow = static_cast<size_t>(scrollY / cellHeight);
+    const size_t lastRow = std::min(m_visibleRows.size(), static_cast<size_t>((scrollY + viewMax.y - cellsMin.y) / cellHeight) + 1u);
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const ImU32 changedColor = ImGui::GetColorU32(ImVec4{ 1.0f, 0.8f, 0.0f, 1.0f });
+    const ImU32 headerColor = ImGui::GetColorU32(ImGuiCol_TableHeaderBg);
+    const ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+
+    // Cells, outlined where they changed since the previous driver
+    drawList->PushClipRect(cellsMin, viewMax, true);
+    for (size_t visibleRow = firstRow; visibleRow < lastRow; ++visibleRow)
+    {
+        const size_t row = m_visibleRows[visibleRow];
+        const float y = cellsMin.y + visibleRow * cellHeight - scrollY;
+        for (size_t column = firstColumn; column < lastColumn; ++column)
+        {
+            const float x = cellsMin.x + column * cellWidth - scrollX;
+            if (HasChanged(row, column))
+                drawList->AddRectFilled(ImVec2{ x, y }, ImVec2{ x + cellWidth, y + cellHeight }, changedColor);
+
+            badges.DrawBadge(*drawList, ImVec2{ x + 1.0f, y + 1.0f }, ImVec2{ x + cellWidth - 1.0f, y + cellHeight - 1.0f }, GetCell(row, column));
+        }
+    }
+    drawList->PopClipRect();
+
+    // Frozen column headers
+    drawList->PushClipRect(ImVec2{ cellsMin.x, viewMin.y }, ImVec2{ viewMax.x, cellsMin.y }, true);
+    drawList->AddRectFilled(ImVec2{ cellsMin.x, viewMin.y }, ImVec2{ viewMax.x, cellsMin.y }, headerColor);
+    for (size_t column = firstColumn; column < lastColumn; ++column)
+    {
+        const float x = cellsMin.x + column * cellWidth - scrollX;
+        drawList->AddText(ImVec2{ x + style.CellPadding.x, viewMin.y + style.CellPadding.y }, textColor, m_driverNames[column].c_str());
+    }
+    drawList->PopClipRect();
+
+    // Frozen row headers
+    drawList->PushClipRect(ImVec2{ viewMin.x, cellsMin.y }, ImVec2{ cellsMin.x, viewMax.y }, true);
+    drawList->AddRectFilled(ImVec2{ viewMin.x, cellsMin.y }, ImVec2{ cellsMin.x, viewMax.y }, headerColor);
+    for (size_t visibleRow = firstRow; visibleRow < lastRow; ++visibleRow)
+    {
+        const float y = cellsMin.y + visibleRow * cellHeight - scrollY;
+        const ImVec2 textPos{ viewMin.x + style.CellPadding.x, y + (cellHeight - ImGui::GetFontSize()) * 0.5f };
+        drawList->AddText(textPos, m_rowChanges[m_visibleRows[visibleRow]] ? changedColor : textColor, D3DFormatToString(formats[m_visibleRows[visibleRow]]));
+    }
+    drawList->PopClipRect();
+
+    drawList->AddRectFilled(viewMin, cellsMin, headerColor);
+    drawList->AddText(ImVec2{ viewMin.x + style.CellPadding.x, viewMin.y + style.CellPadding.y }, textColor, "DXGI Format");
+
+    if (ImGui::IsWindowHovered())
+    {
+        const ImVec2 mouse = ImGui::GetIO().MousePos;
+        if (mouse.x >= cellsMin.x && mouse.y >= cellsMin.y && mouse.x < viewMax.x && mouse.y < viewMax.y)
+        {
+            const size_t column = static_cast<size_t>((mouse.x - cellsMin.x + scrollX) / cellWidth);
+            const size_t visibleRow = static_cast<size_t>((mouse.y - cellsMin.y + scrollY) / cellHeight);
+            if (column < columnCount && visibleRow < m_visibleRows.size())
+                DrawTooltip(m_visibleRows[visibleRow], column);
+        }
+    }
+
+    ImGui::EndChild();
+}
+
+void TimelineView::DrawTooltip(const size_t row, const size_t version) const
+{
+    const DriverTimeline& timeline = m_timelines->GetTimelines()[m_timeline];
+    size_t firstPass = 0u;
+    size_t firstRegression = 0u;
+    const bool passed = timeline.FindFirstPass(row, m_capability, firstPass);
+    const bool regressed = timeline.FindFirstRegression(row, m_capability, firstRegression);
+
+    ImGui::BeginTooltip();
+    ImGui::Text("%s", D3DFormatToString(timeline.GetFormats()[row]));
+    ImGui::Text("%s: %s", timeline.GetCapabilities()[m_capability].c_str(), FormatSupportEnumToString(GetCell(row, version)));
+    ImGui::Text("Driver: %s", m_driverNames[version].c_str());
+    if (version > 0u)
+        ImGui::Text("Previous driver: %s", FormatSupportEnumToString(GetCell(row, version - 1u)));
+    ImGui::Separator();
+    ImGui::Text("First passed: %s", passed ? m_driverNames[firstPass].c_str() : "never");
+    ImGui::Text("First regressed: %s", regressed ? m_driverNames[firstRegression].c_str() : "never");
+    ImGui::EndTooltip();
+}
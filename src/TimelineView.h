@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SupportTable.h"
+
+class DriverTimeline;
+class DriverTimelineSet;
+class FormatSearchIndex;
+class StatusBadgeRenderer;
+
+// One adapter's support for one capability across its driver versions, a column per driver.
+// The grid is replayed out of the timeline's deltas once per adapter and capability choice,
+// drawing is virtualised the same way as the comparison view. Cells that changed since the
+// previous driver are outlined, and hovering one looks up the first driver where it passed
+// and regressed, each a binary search over the timeline.
+class TimelineView
+{
+public:
+    TimelineView();
+
+    // The set must outlive the view or be re-set before the next Draw(). Selects the adapter
+    // with the given ids when it's in the set.
+    void SetTimelines(const DriverTimelineSet& timelines, const uint32_t vendorId, const uint32_t deviceId);
+
+    void Draw(const StatusBadgeRenderer& badges, const FormatSearchIndex& search);
+
+private:
+    FormatSupport GetCell(const size_t row, const size_t version) const { return m_cells[row * m_driverNames.size() + version]; }
+    bool HasChanged(const size_t row, const size_t version) const { return version > 0u && GetCell(row, version) != GetCell(row, version - 1u); }
+    void Select(const size_t timeline, const size_t capability);
+    void DrawTooltip(const size_t row, const size_t version) const;
+
+    const DriverTimelineSet* m_timelines;
+    size_t m_timeline;
+    size_t m_capability;
+
+    std::vector<std::string> m_driverNames; // Column headers
+    std::vector<FormatSupport> m_cells;     // [format][version] for the selected capability
+    std::vector<bool> m_rowChanges;         // The format changed at some driver
+
+    std::vector<uint32_t> m_visibleRows;    // Rows left after search and collapsing, rebuilt per frame
+    bool m_onlyChanged;
+    float m_rowHeaderWidth;                 // Measured lazily as it needs the font
+    float m_columnWidth;
+};
@@ -0,0 +1,232 @@
+#include "Trace.h"
+
+#if DFSE_TRACE_ENABLED
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* Name;
+        uint64_t Start; // Nanoseconds on the steady clock
+        uint64_t End;
+    };
+
+    // Only the owning thread writes, Count and Next are what other threads may read
+    struct TraceBlock
+    {
+        TraceEvent Events[TRACE_BLOCK_EVENTS];
+        std::atomic<uint32_t> Count{ 0u };
+        std::atomic<TraceBlock*> Next{ nullptr };
+    };
+
+    // A track of the trace. Owned by one thread at a time, handed to a new thread once its owner exits.
+    struct TraceThread
+    {
+        uint32_t Id;
+        std::atomic<const char*> Name{ nullptr };
+        std::atomic<TraceBlock*> First{ nullptr }; // Allocated with the first event
+        TraceBlock* Current = nullptr;
+        uint32_t EventCount = 0u;
+        std::atomic<uint64_t> Dropped{ 0u };
+        TraceThread* NextThread = nullptr;
+        TraceThread* NextFree = nullptr; // Guarded by g_freeThreadsMutex
+    };
+
+    std::atomic<bool> g_recording{ false };
+    std::atomic<uint64_t> g_traceStart{ 0u };
+
+    // Tracks are pushed onto the front and never removed, there are only ever as many as threads that recorded at once
+    std::atomic<TraceThread*> g_threads{ nullptr };
+    std::atomic<uint32_t> g_threadCount{ 0u };
+
+    // Tracks of threads that have exited, taken by the next thread of the same name to record
+    std::mutex g_freeThreadsMutex;
+    TraceThread* g_freeThreads = nullptr;
+
+    // Per thread: the name until the thread first records, then its track, given back on exit
+    class ThreadSlot
+    {
+    public:
+        ~ThreadSlot()
+        {
+            if (!Thread)
+                return;
+
+            std::lock_guard<std::mutex> lock(g_freeThreadsMutex);
+            Thread->NextFree = g_freeThreads;
+            g_freeThreads = Thread;
+        }
+
+        TraceThread* Thread = nullptr;
+        const char* Name = nullptr;
+    };
+    thread_local ThreadSlot t_slot;
+
+    uint64_t NowNanoseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Only called while recording, a thread that never records never gets a track
+    TraceThread& GetThread()
+    {
+        if (t_slot.Thread)
+            return *t_slot.Thread;
+
+        // Reuse the track of an exited thread with the same name, e.g. the last connection thread's
+        TraceThread* thread = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(g_freeThreadsMutex);
+            for (TraceThread** free = &g_freeThreads; *free; free = &(*free)->NextFree)
+            {
+                const char* name = (*free)->Name.load(std::memory_order_relaxed);
+                if (name == t_slot.Name || (name && t_slot.Name && std::strcmp(name, t_slot.Name) == 0))
+                {
+                    thread = *free;
+                    *free = thread->NextFree;
+                    break;
+                }
+            }
+        }
+
+        if (!thread)
+        {
+            thread = new TraceThread();
+            thread->Id = ++g_threadCount;
+            TraceThread* head = g_threads.load(std::memory_order_relaxed);
+            do
+                thread->NextThread = head;
+            while (!g_threads.compare_exchange_weak(head, thread, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        thread->Name.store(t_slot.Name, std::memory_order_release);
+        t_slot.Thread = thread;
+        return *thread;
+    }
+
+    void RecordEvent(const char* name, const uint64_t start, const uint64_t end)
+    {
+        TraceThread& thread = GetThread();
+        if (thread.EventCount >= TRACE_MAX_EVENTS_PER_THREAD)
+        {
+            thread.Dropped.fetch_add(1u, std::memory_order_relaxed);
+            return;
+        }
+
+        TraceBlock* block = thread.Current;
+        if (!block)
+        {
+            block = new TraceBlock();
+            thread.First.store(block, std::memory_order_release);
+            thread.Current = block;
+        }
+
+        uint32_t count = block->Count.load(std::memory_order_relaxed);
+        if (count == TRACE_BLOCK_EVENTS)
+        {
+            TraceBlock* next = new TraceBlock();
+            block->Next.store(next, std::memory_order_release);
+            thread.Current = block = next;
+            count = 0u;
+        }
+
+        block->Events[count] = TraceEvent{ name, start, end };
+        block->Count.store(count + 1u, std::memory_order_release);
+        thread.EventCount++;
+    }
+
+    void WriteEscaped(std::FILE* file, const char* text)
+    {
+        for (const char* c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                std::fputc('\\', file);
+            std::fputc(*c, file);
+        }
+    }
+}
+
+void StartTrace()
+{
+    g_traceStart.store(NowNanoseconds(), std::memory_order_relaxed);
+    g_recording.store(true, std::memory_order_release);
+}
+
+void StopTrace()
+{
+    g_recording.store(false, std::memory_order_release);
+}
+
+bool IsTraceRecording()
+{
+    return g_recording.load(std::memory_order_relaxed);
+}
+
+void SetTraceThreadName(const char* name)
+{
+    t_slot.Name = name;
+    if (t_slot.Thread)
+        t_slot.Thread->Name.store(name, std::memory_order_release);
+}
+
+bool WriteTraceJSON(const std::filesystem::path& path)
+{
+    std::unique_ptr<std::FILE, int(*)(std::FILE*)> file(std::fopen(path.u8string().c_str(), "wb"), &std::fclose);
+    if (!file)
+        return false;
+
+    // Timestamps in microseconds since StartTrace(), zones from before it are left out
+    const uint64_t traceStart = g_traceStart.load(std::memory_order_relaxed);
+    std::fprintf(file.get(), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(file.get(), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"DXGI Format Support Exporter\"}}");
+    uint64_t dropped = 0u;
+    for (TraceThread* thread = g_threads.load(std::memory_order_acquire); thread; thread = thread->NextThread)
+    {
+        if (const char* name = thread->Name.load(std::memory_order_acquire))
+        {
+            std::fprintf(file.get(), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", thread->Id);
+            WriteEscaped(file.get(), name);
+            std::fprintf(file.get(), "\"}}");
+        }
+
+        for (const TraceBlock* block = thread->First.load(std::memory_order_acquire); block; block = block->Next.load(std::memory_order_acquire))
+        {
+            const uint32_t count = block->Count.load(std::memory_order_acquire);
+            for (uint32_t i = 0u; i < count; ++i)
+            {
+                const TraceEvent& event = block->Events[i];
+                if (event.Start < traceStart)
+                    continue;
+
+                std::fprintf(file.get(), ",\n{\"name\":\"");
+                WriteEscaped(file.get(), event.Name);
+                std::fprintf(file.get(), "\",\"cat\":\"dfse\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", thread->Id,
+                    static_cast<double>(event.Start - traceStart) / 1000.0, static_cast<double>(event.End - event.Start) / 1000.0);
+            }
+        }
+        dropped += thread->Dropped.load(std::memory_order_relaxed);
+    }
+    std::fprintf(file.get(), "\n],\"otherData\":{\"droppedEvents\":%llu}}\n", static_cast<unsigned long long>(dropped));
+    return std::ferror(file.get()) == 0;
+}
+
+TraceZone::TraceZone(const char* name)
+    : m_name(g_recording.load(std::memory_order_relaxed) ? name : nullptr), m_start(m_name ? NowNanoseconds() : 0u)
+{
+}
+
+TraceZone::~TraceZone()
+{
+    if (m_name)
+        RecordEvent(m_name, m_start, NowNanoseconds());
+}
+
+#endif
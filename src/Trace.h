@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+// Set to 0 to compile every TRACE_ZONE() and the recorder out
+#ifndef DFSE_TRACE_ENABLED
+#define DFSE_TRACE_ENABLED 1
+#endif
+
+#define TRACE_BLOCK_EVENTS (4096u)          // Events per block of a thread's buffer
+#define TRACE_MAX_EVENTS_PER_THREAD (1u << 20u) // Later events are dropped and counted
+
+// Scoped-zone tracer written out as Chrome trace-event JSON, for Perfetto or chrome://tracing.
+// Every thread appends to its own buffer of fixed-size blocks, publishing each event with a
+// release store of the block's count, so recording takes no lock and writing the trace can
+// happen while other threads keep recording. Zones cost one relaxed load while not recording.
+// A thread's buffer is only allocated by its first zone while recording, and passes on to the
+// next thread of the same name once it exits, so short-lived threads don't pile up buffers.
+#if DFSE_TRACE_ENABLED
+
+void StartTrace();
+void StopTrace();
+bool IsTraceRecording();
+void SetTraceThreadName(const char* name); // A literal, shown as the thread's track name
+
+// Every zone recorded since StartTrace(), false when the file can't be written
+bool WriteTraceJSON(const std::filesystem::path& path);
+
+// The name has to be a literal or otherwise outlive the trace
+class TraceZone
+{
+public:
+    explicit TraceZone(const char* name);
+    ~TraceZone();
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* m_name; // Null when the zone started while not recording
+    uint64_t m_start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+
+#else
+
+inline void StartTrace() {}
+inline void StopTrace() {}
+inline bool IsTraceRecording() { return false; }
+inline void SetTraceThreadName(const char*) {}
+inline bool WriteTraceJSON(const std::filesystem::path&) { return false; }
+
+#define TRACE_ZONE(name) ((void)0)
+
+#endif
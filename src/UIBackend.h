@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "SupportTable.h"
+
+// Everything ImGuiLayer needs from the app that owns the window and the data.
+// D3D12App implements it for the real tool, the UI benchmark has a null version
+// so the layer can run headless without D3D12.
+class UIBackend
+{
+public:
+    virtual ~UIBackend() = default;
+
+    virtual uint32_t GetWidth() const = 0;
+    virtual uint32_t GetHeight() const = 0;
+
+    virtual const GPUInfo& GetGPUInfo() const = 0;
+    virtual const std::vector<const char*>& GetTableHeaders() const = 0;
+    virtual const SupportTable& GetSupportTable() const = 0;
+    virtual uint32_t GetSupportTableVersion() const = 0; // Bumped whenever the support table changes
+    virtual bool IsSupportTableComplete() const = 0;     // False while probed rows are still streaming in
+
+    virtual const std::vector<SupportReport>& GetImportedReports() const = 0;
+    virtual uint32_t GetImportedReportsVersion() const = 0;
+
+    virtual bool ExportFormatSupportTable() = 0;
+    virtual bool ExportCopyableFootprints() = 0; // What the device reports, to check the CPU footprint calculator against
+    virtual bool ExportAllocationInfo() = 0;     // Heap sizes and alignments the driver gave the probed descs
+    virtual bool IsAllocationInfoReady() const = 0; // False until the allocation probe has finished, after the table
+
+    // Events
+    virtual void OpenFileDialogue() = 0;
+    virtual void SendFileSaveErrorEvent() = 0;
+};
@@ -1,23 +1,46 @@
 #pragma once
 
+#include <cstdint>
 #include <sstream>
+
+#include "SupportTable.h"
+
+#ifdef _WIN32
 #include <comdef.h>
 #include <codecvt> // UTF-16 to UTF-8
 
 #define D3D_VERIFY(x) ThrowIfFailed(x)
+#define D3D_VERIFY_WORKER(x) ThrowOnWorkerFailure(x) // Off the UI thread, see WorkerFailure
+
+// Shows the error and quits, UI thread only: PostQuitMessage() goes to the calling thread's queue
+inline void ReportFailure(const HRESULT hr)
+{
+    const _com_error err(hr);
+    std::wstringstream wss;
+    wss << err.ErrorMessage() << L"\nHRESULT code: 0x" << std::hex << std::uppercase << hr << '\n';
+    MessageBoxW(NULL, wss.str().c_str(), L"Error", MB_OK | MB_ICONERROR);
+
+    PostQuitMessage(hr);
+}
 
 inline void ThrowIfFailed(const HRESULT hr)
 {
     if (FAILED(hr))
-    {
-        const _com_error err(hr);
-        std::wstringstream wss;
-        wss << err.ErrorMessage() << L"\nHRESULT code: 0x" << std::hex << std::uppercase << hr << '\n';
-        MessageBoxW(NULL, wss.str().c_str(), L"Error", MB_OK | MB_ICONERROR);
+        ReportFailure(hr);
+}
 
-        PostQuitMessage(hr);
-    }
+// Thrown by worker threads, it reaches the UI thread through the task's future and is reported there
+struct WorkerFailure
+{
+    HRESULT Code;
+};
+
+inline void ThrowOnWorkerFailure(const HRESULT hr)
+{
+    if (FAILED(hr))
+        throw WorkerFailure{ hr };
 }
+#endif
 
 constexpr float BytesToGigbibytes(const uint32_t bytes)
 {
@@ -29,6 +52,7 @@ constexpr double BytesToGigbibytes(const uint64_t bytes)
     return static_cast<double>(bytes) / 1.074e+9f;
 }
 
+#ifdef _WIN32
 inline std::string UTF16toUTF8(const std::wstring& wideString)
 {
     if (wideString.empty())
@@ -66,6 +90,7 @@ inline const char* D3DFeatureLevelToString(const D3D_FEATURE_LEVEL FL)
     default: return "UNKNOWN FEATURE LEVEL";
     }
 }
+#endif
 
 inline const char* FormatSupportEnumToString(const FormatSupport support)
 {
@@ -207,4 +232,80 @@ inline const char* D3DFormatToString(const DXGI_FORMAT format)
     default:
         return "Unknown format";
     }
+}
+
+inline bool D3DFormatFromString(const std::string& name, DXGI_FORMAT& outFormat)
+{
+    static const std::unordered_map<std::string, DXGI_FORMAT> lookup = []()
+    {
+        std::unordered_map<std::string, DXGI_FORMAT> formats;
+        for (uint32_t i = 0u; i < 256u; ++i)
+        {
+            const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(i);
+            if (format == DXGI_FORMAT_UNKNOWN || std::string(D3DFormatToString(format)) != "Unknown format")
+                formats.emplace(D3DFormatToString(format), format);
+        }
+        return formats;
+    }();
+
+    const auto found = lookup.find(name);
+    if (found == lookup.end())
+        return false;
+
+    outFormat = found->second;
+    return true;
+}
+
+inline FormatSupport FormatSupportFromString(const std::string& support)
+{
+    if (support == "PASS")
+        return FormatSupport::PASS;
+    if (support == "FAIL")
+        return FormatSupport::FAIL;
+
+    return FormatSupport::UNKN;
+}
+
+inline const char* VendorIdToString(const uint32_t vendorId)
+{
+    switch (vendorId)
+    {
+    case 0x1002u: return "AMD";
+    case 0x10DEu: return "NVIDIA";
+    case 0x8086u: return "Intel";
+    case 0x5143u: return "Qualcomm";
+    case 0x1414u: return "Microsoft";
+    case 0x106Bu: return "Apple";
+    case 0x13B5u: return "ARM";
+    case 0x0000u: return "Unknown vendor";
+    default: return "Other vendor";
+    }
+}
+
+inline std::string DriverVersionToString(const uint64_t version)
+{
+    std::stringstream ss;
+    ss << ((version >> 48u) & 0xFFFFu) << '.' << ((version >> 32u) & 0xFFFFu) << '.'
+       << ((version >> 16u) & 0xFFFFu) << '.' << (version & 0xFFFFu);
+    return ss.str();
+}
+
+// Parses "a.b.c.d" as written by DriverVersionToString()
+inline bool DriverVersionFromString(const std::string& str, uint64_t& outVersion)
+{
+    std::stringstream ss(str);
+    uint64_t version = 0u;
+    for (uint32_t part = 0u; part < 4u; ++part)
+    {
+        uint32_t value = 0u;
+        if (!(ss >> value) || value > 0xFFFFu)
+            return false;
+        if (part < 3u && ss.get() != '.')
+            return false;
+
+        version = (version << 16u) | value;
+    }
+
+    outVersion = version;
+    return true;
 }
\ No newline at end of file
@@ -2,15 +2,24 @@
 #include "../resource.h"
 
 #include "D3D12App.h"
+#include "Trace.h"
 
 HWND Win32App::m_hwnd{ 0u };
 DWORD Win32App::m_style{ 0u };
 
+// Posted by RequestRedraw() to wake the message loop
+#define WM_APP_REDRAW (WM_APP + 1)
+#define STARTUP_POLL_INTERVAL_MS (4u) // How often the message loop looks at the startup workers until the first frame
+
 extern LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam); // Extern from IMGUI (used to get input data)
 
 int Win32App::Run(D3D12App* gfxBackend, const HINSTANCE instance)
 {
     m_style = WS_OVERLAPPEDWINDOW;
+    SetTraceThreadName("Main");
+
+    // Device creation and font rasterization don't need the window, get them going first
+    gfxBackend->StartInitialise();
     
     // Initialize the window class.
     WNDCLASSEX windowClass;
@@ -23,27 +32,35 @@ int Win32App::Run(D3D12App* gfxBackend, const HINSTANCE instance)
     windowClass.hCursor = LoadCursorW(NULL, IDC_ARROW);
     windowClass.hbrBackground = static_cast<HBRUSH>(GetStockObject(BLACK_BRUSH)); 
     windowClass.lpszClassName = L"DXGI Format Support Exporter";
-    RegisterClassExW(&windowClass);
 
-    RECT windowRect = { 0, 0, static_cast<LONG>(gfxBackend->GetWidth()), static_cast<LONG>(gfxBackend->GetHeight()) };
-    AdjustWindowRect(&windowRect, m_style, FALSE);
+    {
+        TRACE_ZONE("Create window");
+        RegisterClassExW(&windowClass);
+
+        RECT windowRect = { 0, 0, static_cast<LONG>(gfxBackend->GetWidth()), static_cast<LONG>(gfxBackend->GetHeight()) };
+        AdjustWindowRect(&windowRect, m_style, FALSE);
 
-    m_hwnd = CreateWindowW(
-        windowClass.lpszClassName,
-        L"DXGI Format Support Exporter - Developed by Joe Bevan",
-        m_style,
-        CW_USEDEFAULT,
-        CW_USEDEFAULT,
-        windowRect.right - windowRect.left,
-        windowRect.bottom - windowRect.top,
-        nullptr,        
-        nullptr,        
-        instance,
-        gfxBackend);
+        m_hwnd = CreateWindowW(
+            windowClass.lpszClassName,
+            L"DXGI Format Support Exporter - Developed by Joe Bevan",
+            m_style,
+            CW_USEDEFAULT,
+            CW_USEDEFAULT,
+            windowRect.right - windowRect.left,
+            windowRect.bottom - windowRect.top,
+            nullptr,        
+            nullptr,        
+            instance,
+            gfxBackend);
+    }
 
-    gfxBackend->Initialise();
+    // Shown straight away, it stays black until the first frame
+    {
+        TRACE_ZONE("ShowWindow");
+        ShowWindow(m_hwnd, SW_NORMAL);
+    }
 
-    ShowWindow(m_hwnd, SW_NORMAL);
+    FrameScheduler& scheduler = gfxBackend->GetFrameScheduler();
 
     MSG msg = {};
     while (msg.message != WM_QUIT)
@@ -53,20 +70,54 @@ int Win32App::Run(D3D12App* gfxBackend, const HINSTANCE instance)
         {
             TranslateMessage(&msg);
             DispatchMessage(&msg);
+            continue;
         }
+
+        // The rest of startup runs from here so the window keeps answering while the workers finish
+        if (!gfxBackend->IsInitialised())
+        {
+            if (gfxBackend->PollInitialise())
+                scheduler.RequestFrames();
+            else
+                MsgWaitForMultipleObjectsEx(0u, nullptr, STARTUP_POLL_INTERVAL_MS, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            continue;
+        }
+
+        if (scheduler.IsFrameDue())
+        {
+            gfxBackend->OnRender();
+            continue;
+        }
+
+        // Nothing to draw, sleep until a message arrives or the next timed frame is due
+        const FrameScheduler::Duration wait = scheduler.GetTimeUntilNextFrame();
+        const DWORD timeoutMs = wait == FrameScheduler::Duration::max() ? INFINITE
+            : static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(wait).count());
+        MsgWaitForMultipleObjectsEx(0u, nullptr, timeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
     }
 
     gfxBackend->Shutdown();
     return static_cast<int>(msg.wParam);
 }
 
+void Win32App::RequestRedraw()
+{
+    PostMessageW(m_hwnd, WM_APP_REDRAW, 0, 0);
+}
+
 LRESULT CALLBACK Win32App::WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
+    D3D12App* gfxBackend = reinterpret_cast<D3D12App*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+
+    // Any input may change what ImGui draws
+    const bool isInput = (message >= WM_MOUSEFIRST && message <= WM_MOUSELAST) || (message >= WM_KEYFIRST && message <= WM_KEYLAST)
+        || message == WM_MOUSELEAVE || message == WM_SETFOCUS || message == WM_KILLFOCUS;
+    if (isInput && gfxBackend)
+        gfxBackend->GetFrameScheduler().OnInput();
+
     if (ImGui_ImplWin32_WndProcHandler(hwnd, message, wParam, lParam))
         return true;
 
-    D3D12App* gfxBackend = reinterpret_cast<D3D12App*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
-
     switch (message)
     {
     case WM_CREATE:
@@ -89,15 +140,29 @@ LRESULT CALLBACK Win32App::WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARA
             RECT clientRect = {};
             GetClientRect(hwnd, &clientRect);
             gfxBackend->OnResize(clientRect.right - clientRect.left, clientRect.bottom - clientRect.top, wParam == SIZE_MINIMIZED);
+            gfxBackend->GetFrameScheduler().RequestFrames();
         }
         return 0;
     }
 
     case WM_PAINT:
     {
+        // Until the first frame can be drawn, the default handler paints the class's black brush
+        if (!gfxBackend || !gfxBackend->IsInitialised())
+            break;
+
+        // Render straight away so the window keeps up inside the modal resize loop
+        gfxBackend->OnRender();
+        ValidateRect(hwnd, nullptr);
+        return 0;
+    }
+
+    case WM_APP_REDRAW:
+    {
+        // New data to show, one frame draws it. Not input, so no settle frames or hover wake-up
         if (gfxBackend)
         {
-            gfxBackend->OnRender();
+            gfxBackend->GetFrameScheduler().RequestFrames(1u);
         }
         return 0;
     }
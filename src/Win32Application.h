@@ -11,6 +11,7 @@ class Win32App
 public:
     static int Run(D3D12App* gfxBackend, const HINSTANCE instance);
     static HWND GetHandle() { return m_hwnd; }
+    static void RequestRedraw(); // Safe to call from any thread, e.g. when an async job finishes
 
 private:
     static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
@@ -1,8 +1,35 @@
 #include "D3D12App.h"
+#include "ImGuiAllocator.h"
+#include "Trace.h"
 #include "Win32Application.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
 int APIENTRY WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPSTR lpCmdLine, _In_ int nShowCmd)
 {
+    // Before the app's font atlas exists, ImGui memory has to be freed by the allocator it came from
+    InstallImGuiAllocator();
     D3D12App gfxBackend(960u, 720u);
-    return Win32App::Run(&gfxBackend, hInstance);
+
+    // --collector <port> sends the report to a dfse_collector on this machine
+    if (const char* collector = std::strstr(lpCmdLine, "--collector"))
+        gfxBackend.SetCollectorPort(static_cast<uint16_t>(std::strtoul(collector + std::strlen("--collector"), nullptr, 10)));
+
+    // --trace <file.json> records startup, probing and every frame until exit as a Chrome trace, e.g. for Perfetto
+    std::string tracePath;
+    if (const char* trace = std::strstr(lpCmdLine, "--trace"))
+    {
+        trace += std::strlen("--trace");
+        while (*trace == ' ')
+            ++trace;
+        tracePath.assign(trace, std::strcspn(trace, " "));
+        StartTrace();
+    }
+
+    const int result = Win32App::Run(&gfxBackend, hInstance);
+    if (!tracePath.empty())
+        WriteTraceJSON(tracePath);
+    return result;
 }
\ No newline at end of file
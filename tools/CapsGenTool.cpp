@@ -0,0 +1,68 @@
+// Constexpr capability headers from exported reports, e.g. as a build step.
+//
+// Usage: dfse_capsgen [--namespace Caps] [--out Caps.h] report.csv [more.csv ...]
+//        One report is written as is. Several are reduced to the fleet minimum, what every one of them supports.
+
+#include "../src/CapabilityHeader.h"
+#include "../src/FleetProfile.h"
+#include "../src/ReportIO.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    const char* namespaceName = "Caps";
+    const char* outPath = nullptr;
+    std::vector<const char*> reportPaths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--namespace") == 0 && i + 1 < argc)
+            namespaceName = argv[++i];
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            outPath = argv[++i];
+        else
+            reportPaths.push_back(argv[i]);
+    }
+
+    if (reportPaths.empty())
+    {
+        std::fprintf(stderr, "Usage: dfse_capsgen [--namespace Caps] [--out Caps.h] <report .csv> [more report .csv ...]\n");
+        return 2;
+    }
+
+    // Reports are folded in one at a time, only the last one read is ever in memory
+    SupportReport profile;
+    FleetProfileBuilder fleet;
+    for (const char* reportPath : reportPaths)
+    {
+        if (!ImportSupportReportCSV(reportPath, profile))
+        {
+            std::fprintf(stderr, "Couldn't read '%s'\n", reportPath);
+            return 2;
+        }
+        fleet.AddReport(MakeReportSource(profile));
+    }
+
+    if (reportPaths.size() > 1u)
+    {
+        const std::string name = "Fleet minimum of " + std::to_string(reportPaths.size()) + " reports";
+        fleet.BuildReport(fleet.GetReportCount(), name.c_str(), profile);
+    }
+
+    if (outPath)
+    {
+        if (!ExportCapabilityHeader(outPath, profile, namespaceName))
+        {
+            std::fprintf(stderr, "Couldn't write '%s'\n", outPath);
+            return 2;
+        }
+        return 0;
+    }
+
+    const std::string header = GenerateCapabilityHeader(profile, namespaceName);
+    std::fwrite(header.data(), 1u, header.size(), stdout);
+    return 0;
+}
@@ -0,0 +1,453 @@
+// Collects reports from machines into an append-only segment file.
+//
+// Usage: dfse_collector --listen --segment reports.dfsg [--port 47315] [--batch 4096] [--flush-ms 20]
+//        Runs the collector on the loopback interface until Ctrl+C.
+//
+//        dfse_collector --listen --store <dir> [--rotate-mb 64] [--compact-at 4] [--port 47315] [...]
+//        Collects into a segmented store instead, starting a new segment every --rotate-mb and
+//        compacting in the background once there are --compact-at segments.
+//
+//        dfse_collector --compact <dir>
+//        Merges every segment of a store into one sealed segment.
+//
+//        dfse_collector --find <dir> VENDOR:DEVICE[:DRIVER]
+//        Lists a store's reports from one adapter, ids in hex and the driver as a.b.c.d.
+//
+//        dfse_collector --send [--port 47315] [--repeat 1] <report .csv or directory of them> [...]
+//        Sends reports to a running collector, as the app does with --collector.
+//
+//        dfse_collector --dump reports.dfsg
+//        Lists a segment's records, sealed or not.
+//
+//        dfse_collector --bench [--reports 200000] [--senders 4] [--segment bench.dfsg] [<report .csv> ...]
+//        Runs a collector and senders in one process and measures end to end ingest, received to synced.
+
+#include "../src/ReportCollector.h"
+#include "../src/ReportIO.h"
+#include "../src/SegmentedReportStore.h"
+#include "../src/Utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define COLLECTOR_TOOL_MAX_LISTED_RECORDS (20u)
+
+static volatile std::sig_atomic_t s_stopRequested = 0;
+
+static void OnStopSignal(int)
+{
+    s_stopRequested = 1;
+}
+
+static const char* FindArg(int argc, char** argv, const char* name)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return argv[i + 1];
+    }
+    return nullptr;
+}
+
+static bool HasFlag(int argc, char** argv, const char* name)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static uint32_t FindUintArg(int argc, char** argv, const char* name, const uint32_t fallback)
+{
+    const char* value = FindArg(argc, argv, name);
+    return value ? static_cast<uint32_t>(std::strtoul(value, nullptr, 10)) : fallback;
+}
+
+// Report paths in a stable order, directories expanded to the '.csv' files in them
+static std::vector<std::filesystem::path> CollectReportPaths(int argc, char** argv)
+{
+    static const char* const valueArgs[] = { "--segment", "--port", "--batch", "--flush-ms", "--repeat", "--dump", "--reports", "--senders", "--store",
+        "--rotate-mb", "--compact-at", "--compact", "--find" };
+
+    std::vector<std::filesystem::path> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i][0] == '-')
+        {
+            for (const char* valueArg : valueArgs)
+                i += std::strcmp(argv[i], valueArg) == 0 ? 1 : 0;
+            continue;
+        }
+
+        std::error_code error;
+        if (!std::filesystem::is_directory(argv[i], error))
+        {
+            paths.emplace_back(argv[i]);
+            continue;
+        }
+
+        std::vector<std::filesystem::path> directoryPaths;
+        for (const auto& entry : std::filesystem::directory_iterator(argv[i], error))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".csv")
+                directoryPaths.push_back(entry.path());
+        }
+        std::sort(directoryPaths.begin(), directoryPaths.end());
+        paths.insert(paths.end(), directoryPaths.begin(), directoryPaths.end());
+    }
+    return paths;
+}
+
+static double SecondsSince(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int Listen(ReportCollector::Settings settings, const char* storePath, const uint32_t compactAt)
+{
+    SegmentedReportStore store;
+    if (storePath)
+    {
+        if (!store.Open(storePath))
+        {
+            std::fprintf(stderr, "Couldn't open the store '%s'\n", storePath);
+            return 2;
+        }
+        store.StartBackgroundCompaction(compactAt);
+        settings.Store = &store;
+    }
+
+    const std::string target = storePath ? storePath : settings.SegmentPath.u8string();
+    ReportCollector collector;
+    if (!collector.Start(settings))
+    {
+        std::fprintf(stderr, "Couldn't open '%s' or listen on port %u\n", target.c_str(), settings.Port);
+        return 2;
+    }
+
+    std::signal(SIGINT, OnStopSignal);
+    std::signal(SIGTERM, OnStopSignal);
+    std::printf("Collecting into '%s' on 127.0.0.1:%u, Ctrl+C to stop\n", target.c_str(), collector.GetPort());
+    while (!s_stopRequested && collector.IsRunning())
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    collector.Stop();
+    store.StopBackgroundCompaction();
+    const ReportCollector::Stats stats = collector.GetStats();
+    std::printf("%llu reports received, %llu written in %llu batches, %llu rejected\n", static_cast<unsigned long long>(stats.Received),
+        static_cast<unsigned long long>(stats.Written), static_cast<unsigned long long>(stats.Batches), static_cast<unsigned long long>(stats.Rejected));
+    if (stats.SyncFailures != 0u || stats.RefusedConnections != 0u)
+    {
+        std::printf("%llu failed syncs retried, %llu connections refused\n", static_cast<unsigned long long>(stats.SyncFailures),
+            static_cast<unsigned long long>(stats.RefusedConnections));
+    }
+    if (storePath)
+    {
+        std::printf("%zu segments, %llu records in the store\n", store.GetSegmentCount(), static_cast<unsigned long long>(store.GetRecordCount()));
+    }
+    if (stats.WriterStopped)
+    {
+        std::fprintf(stderr, "Couldn't open a new segment in '%s', stopped collecting\n", target.c_str());
+        return 2;
+    }
+    return 0;
+}
+
+static int Compact(const char* storePath)
+{
+    SegmentedReportStore store;
+    SegmentedReportStore::CompactionStats stats{};
+    const auto start = std::chrono::steady_clock::now();
+    if (!store.Open(storePath) || !store.Compact(true, &stats))
+    {
+        std::fprintf(stderr, "Couldn't compact '%s'\n", storePath);
+        return 2;
+    }
+
+    std::printf("%u segments merged in %.3f s, %llu records of %llu reports read, %llu written, %llu duplicates merged\n", stats.SegmentsMerged,
+        SecondsSince(start), static_cast<unsigned long long>(stats.RecordsRead), static_cast<unsigned long long>(stats.ReportsRead),
+        static_cast<unsigned long long>(stats.RecordsWritten), static_cast<unsigned long long>(stats.DuplicatesMerged));
+    return 0;
+}
+
+// VENDOR:DEVICE[:DRIVER] as the key range covering it
+static bool ParseAdapterKey(const char* text, ReportKey& outFirst, ReportKey& outLast)
+{
+    char* end = nullptr;
+    outFirst = ReportKey{};
+    outFirst.VendorId = static_cast<uint32_t>(std::strtoul(text, &end, 16));
+    if (end == text || *end != ':')
+        return false;
+
+    const char* device = end + 1;
+    outFirst.DeviceId = static_cast<uint32_t>(std::strtoul(device, &end, 16));
+    if (end == device || (*end != ':' && *end != '\0'))
+        return false;
+
+    outLast = outFirst;
+    outLast.DriverVersion = UINT64_MAX;
+    outLast.Timestamp = UINT64_MAX;
+    if (*end == ':')
+    {
+        if (!DriverVersionFromString(end + 1, outFirst.DriverVersion))
+            return false;
+        outLast.DriverVersion = outFirst.DriverVersion;
+    }
+    return true;
+}
+
+static int Find(const char* storePath, const char* adapterKey)
+{
+    ReportKey first{};
+    ReportKey last{};
+    if (!ParseAdapterKey(adapterKey, first, last))
+    {
+        std::fprintf(stderr, "'%s' isn't VENDOR:DEVICE[:DRIVER]\n", adapterKey);
+        return 2;
+    }
+
+    SegmentedReportStore store;
+    if (!store.Open(storePath))
+    {
+        std::fprintf(stderr, "Couldn't open the store '%s'\n", storePath);
+        return 2;
+    }
+
+    uint64_t matches = 0u;
+    uint32_t pagesTouched = 0u;
+    SupportReport report;
+    const auto start = std::chrono::steady_clock::now();
+    store.Find(first, last, [&](const uint64_t timestamp, const uint8_t* payload, const uint32_t size, const uint32_t weight)
+    {
+        if (matches++ < COLLECTOR_TOOL_MAX_LISTED_RECORDS && DecodeReportPayload(payload, size, report))
+        {
+            std::printf("%llu  %-32s %04X:%04X %s x%u\n", static_cast<unsigned long long>(timestamp), report.Adapter.Name.c_str(), report.Adapter.VendorId,
+                report.Adapter.DeviceId, DriverVersionToString(report.Adapter.DriverVersion).c_str(), weight);
+        }
+    }, &pagesTouched);
+    const double microseconds = SecondsSince(start) * 1e6;
+
+    std::printf("%llu reports in %zu segments, %u record pages touched, %.0f us\n", static_cast<unsigned long long>(matches), store.GetSegmentCount(),
+        pagesTouched, microseconds);
+    return 0;
+}
+
+static int Send(const uint16_t port, const std::vector<std::filesystem::path>& paths, const uint32_t repeat)
+{
+    std::vector<uint8_t> frames;
+    SupportReport report;
+    for (const std::filesystem::path& path : paths)
+    {
+        if (!ImportSupportReportCSV(path, report))
+        {
+            std::fprintf(stderr, "Skipping '%s', couldn't read it\n", path.u8string().c_str());
+            continue;
+        }
+        AppendReportFrame(report, frames);
+    }
+
+    ReportSender sender;
+    if (!sender.Connect(port))
+    {
+        std::fprintf(stderr, "No collector on port %u\n", port);
+        return 2;
+    }
+
+    for (uint32_t i = 0u; i < repeat; ++i)
+    {
+        if (!sender.SendFrames(frames.data(), frames.size()))
+        {
+            std::fprintf(stderr, "The collector closed the connection\n");
+            return 2;
+        }
+    }
+
+    const bool sent = sender.Flush();
+    sender.Close();
+    return sent ? 0 : 2;
+}
+
+static int Dump(const std::filesystem::path& segmentPath)
+{
+    SegmentReader reader;
+    if (!reader.Open(segmentPath))
+    {
+        std::fprintf(stderr, "'%s' isn't a segment\n", segmentPath.u8string().c_str());
+        return 2;
+    }
+
+    uint64_t records = 0u;
+    uint64_t undecodable = 0u;
+    SupportReport report;
+    uint64_t reports = 0u;
+    reader.ForEach([&](const uint64_t timestamp, const uint8_t* payload, const uint32_t size, const uint32_t weight)
+    {
+        if (!DecodeReportPayload(payload, size, report))
+        {
+            undecodable++;
+            return;
+        }
+
+        reports += weight;
+        if (records++ < COLLECTOR_TOOL_MAX_LISTED_RECORDS)
+        {
+            std::printf("%llu  %-32s %04X:%04X %s x%u\n", static_cast<unsigned long long>(timestamp), report.Adapter.Name.c_str(), report.Adapter.VendorId,
+                report.Adapter.DeviceId, DriverVersionToString(report.Adapter.DriverVersion).c_str(), weight);
+        }
+    });
+
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(segmentPath, error);
+    if (reader.IsSealed())
+    {
+        std::printf("%llu records of %llu reports, %llu undecodable, sealed, %llu bytes of records and %llu of index\n",
+            static_cast<unsigned long long>(records), static_cast<unsigned long long>(reports), static_cast<unsigned long long>(undecodable), static_cast<unsigned long long>(reader.GetValidBytes()),
+            static_cast<unsigned long long>(fileSize - reader.GetValidBytes()));
+        return 0;
+    }
+
+    std::printf("%llu records of %llu reports, %llu undecodable, %llu of %llu bytes intact\n", static_cast<unsigned long long>(records),
+        static_cast<unsigned long long>(reports), static_cast<unsigned long long>(undecodable), static_cast<unsigned long long>(reader.GetValidBytes()), static_cast<unsigned long long>(fileSize));
+    return 0;
+}
+
+// Stand-in report when the bench isn't given any
+static SupportReport MakeBenchReport()
+{
+    SupportReport report;
+    report.Adapter.Name = "Bench adapter";
+    report.Adapter.VendorId = 0x10DEu;
+    report.Adapter.DeviceId = 0x2204u;
+    report.Capabilities = { "Texture1D", "Texture2D", "Texture3D", "Texture Cube", "Render Target", "Depth Target", "Display", "Mipmaps" };
+    for (uint32_t format = 1u; format <= 115u; ++format)
+    {
+        std::vector<FormatSupport> supportFlags(report.Capabilities.size());
+        for (size_t capability = 0u; capability < supportFlags.size(); ++capability)
+            supportFlags[capability] = ((format * 7u + capability) % 3u) ? FormatSupport::PASS : FormatSupport::FAIL;
+        report.Table[static_cast<DXGI_FORMAT>(format)] = std::move(supportFlags);
+    }
+    return report;
+}
+
+static int Bench(const std::filesystem::path& segmentPath, const std::vector<std::filesystem::path>& paths, const uint32_t reportCount,
+    const uint32_t senderCount)
+{
+    std::vector<uint8_t> frames;
+    SupportReport report;
+    for (const std::filesystem::path& path : paths)
+    {
+        if (ImportSupportReportCSV(path, report))
+            AppendReportFrame(report, frames);
+    }
+    const size_t framesPerPass = paths.empty() ? 1u : paths.size();
+    if (frames.empty())
+        AppendReportFrame(MakeBenchReport(), frames);
+
+    std::error_code error;
+    std::filesystem::remove(segmentPath, error);
+    ReportCollector::Settings settings;
+    settings.Port = 0u;
+    settings.SegmentPath = segmentPath;
+    ReportCollector collector;
+    if (!collector.Start(settings))
+    {
+        std::fprintf(stderr, "Couldn't start a collector on '%s'\n", segmentPath.u8string().c_str());
+        return 2;
+    }
+
+    // Each sender sends whole passes over the reports until its share is covered
+    const uint32_t passes = static_cast<uint32_t>((reportCount + framesPerPass - 1u) / framesPerPass);
+    const uint64_t expected = static_cast<uint64_t>(passes) * framesPerPass;
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> senders;
+    for (uint32_t senderIndex = 0u; senderIndex < senderCount; ++senderIndex)
+    {
+        senders.emplace_back([&, senderIndex]()
+        {
+            ReportSender sender;
+            if (!sender.Connect(collector.GetPort()))
+                return;
+            for (uint32_t pass = senderIndex; pass < passes; pass += senderCount)
+                sender.SendFrames(frames.data(), frames.size());
+        });
+    }
+    for (std::thread& sender : senders)
+        sender.join();
+
+    // Done once everything sent is synced, or everyone hung up and whatever did arrive is
+    for (ReportCollector::Stats stats = collector.GetStats();
+         stats.Written < expected && (stats.OpenConnections > 0u || stats.Written < stats.Received) && !stats.WriterStopped; stats = collector.GetStats())
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    const double seconds = SecondsSince(start);
+    collector.Stop();
+
+    const ReportCollector::Stats stats = collector.GetStats();
+    uint64_t recordsRead = 0u;
+    ReadSegment(segmentPath, [&recordsRead](const uint64_t, const uint8_t*, const uint32_t, const uint32_t) { recordsRead++; });
+    std::printf("%llu reports from %u senders synced in %.3f s, %.0f reports/s, %llu batches, %llu bytes\n",
+        static_cast<unsigned long long>(stats.Written), senderCount, seconds, static_cast<double>(stats.Written) / seconds,
+        static_cast<unsigned long long>(stats.Batches), static_cast<unsigned long long>(std::filesystem::file_size(segmentPath, error)));
+    if (recordsRead != expected || stats.Written != expected)
+    {
+        std::fprintf(stderr, "Expected %llu reports, %llu written, %llu in the segment\n", static_cast<unsigned long long>(expected),
+            static_cast<unsigned long long>(stats.Written), static_cast<unsigned long long>(recordsRead));
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const std::vector<std::filesystem::path> paths = CollectReportPaths(argc, argv);
+    const uint16_t port = static_cast<uint16_t>(FindUintArg(argc, argv, "--port", REPORT_COLLECTOR_DEFAULT_PORT));
+    const char* segmentPath = FindArg(argc, argv, "--segment");
+
+    const char* storePath = FindArg(argc, argv, "--store");
+
+    if (HasFlag(argc, argv, "--listen") && (segmentPath || storePath))
+    {
+        ReportCollector::Settings settings;
+        settings.Port = port;
+        settings.SegmentPath = segmentPath ? segmentPath : "";
+        settings.BatchReports = std::max(1u, FindUintArg(argc, argv, "--batch", settings.BatchReports));
+        settings.FlushIntervalMs = FindUintArg(argc, argv, "--flush-ms", settings.FlushIntervalMs);
+        settings.RotateBytes = std::max(1ull, static_cast<unsigned long long>(FindUintArg(argc, argv, "--rotate-mb", 64u))) << 20u;
+        return Listen(settings, storePath, FindUintArg(argc, argv, "--compact-at", SEGMENTED_STORE_COMPACTION_THRESHOLD));
+    }
+    if (const char* compactPath = FindArg(argc, argv, "--compact"))
+        return Compact(compactPath);
+    for (int i = 1; i + 2 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--find") == 0)
+            return Find(argv[i + 1], argv[i + 2]);
+    }
+    if (HasFlag(argc, argv, "--send") && !paths.empty())
+        return Send(port, paths, std::max(1u, FindUintArg(argc, argv, "--repeat", 1u)));
+    if (const char* dumpPath = FindArg(argc, argv, "--dump"))
+        return Dump(dumpPath);
+    if (HasFlag(argc, argv, "--bench"))
+    {
+        return Bench(segmentPath ? segmentPath : "bench.dfsg", paths, std::max(1u, FindUintArg(argc, argv, "--reports", 200000u)),
+            std::max(1u, FindUintArg(argc, argv, "--senders", 4u)));
+    }
+
+    std::fprintf(stderr, "Usage: dfse_collector --listen --segment <file> [--port %u] [--batch 4096] [--flush-ms 20]\n"
+        "       dfse_collector --listen --store <dir> [--rotate-mb 64] [--compact-at %u] [--port %u] [--batch 4096] [--flush-ms 20]\n"
+        "       dfse_collector --compact <dir>\n"
+        "       dfse_collector --find <dir> VENDOR:DEVICE[:DRIVER]\n"
+        "       dfse_collector --send [--port %u] [--repeat 1] <report .csv or directory> [...]\n"
+        "       dfse_collector --dump <segment>\n"
+        "       dfse_collector --bench [--reports 200000] [--senders 4] [--segment bench.dfsg] [<report .csv> ...]\n",
+        REPORT_COLLECTOR_DEFAULT_PORT, SEGMENTED_STORE_COMPACTION_THRESHOLD, REPORT_COLLECTOR_DEFAULT_PORT, REPORT_COLLECTOR_DEFAULT_PORT);
+    return 2;
+}
@@ -0,0 +1,569 @@
+// Fleet-wide profiles from exported reports.
+//
+// Usage: dfse_fleet --ingest fleet.dfss <report .csv or directory of them> [...]
+//        Adds reports to a deduplicated store, identical reports are kept once with a count.
+//
+//        dfse_fleet --profile [--threshold 0.99] [--out-dir .] [--store fleet.dfss] [<report .csv or directory> ...]
+//        Streams every report, or every unique report of a store weighted by its count, through FleetProfileBuilder
+//        and writes Fleet_Intersection.csv (what every report supports) and Fleet_<threshold>pct.csv (what that
+//        fraction of them support) as ordinary reports, which import into the app and capability header
+//        generator like any other.
+//
+//        dfse_fleet --query "!R11G11B10_FLOAT:Render Target & BC7_UNORM:Texture2D" [--store fleet.dfss] [<report .csv or directory> ...]
+//        Indexes the reports and lists the ones matching a boolean expression of FORMAT:Capability terms.
+//
+//        dfse_fleet --timeline 10DE:2204 [--cell "BC7_UNORM:Texture2D"] [--store fleet.dfss] [<report .csv or directory> ...]
+//        Builds one adapter's driver timeline, ids in hex, and lists what each driver changed, or with --cell
+//        the first driver where that cell passed and the first where it regressed.
+//
+//        dfse_fleet --arrow out-dir [--store fleet.dfss] [<report .csv or directory> ...]
+//        Writes Fleet_Reports.arrow, a row per report and format with a bool column per capability, and
+//        Fleet_Aggregate.arrow, pass and known counts per format for the whole fleet and per vendor, as Arrow
+//        IPC files for pandas, Polars and the like to memory map.
+//
+//        dfse_fleet --parse-bench <reports .csv> [--threads 0] [--repeat 5]
+//        Parses a file of one or more reports, e.g. a fleet's exports concatenated, with ReportCSVParser and prints
+//        the throughput of the best run. --threads 0 uses every core.
+//
+//        --store also takes what dfse_collector gathered, a store directory or a single .dfsg segment, each record
+//        counted with its weight.
+//
+//        Any of them also takes --trace trace.json, which records where the time went as Chrome trace-event JSON
+//        for Perfetto or chrome://tracing.
+
+#include "../src/ArrowExport.h"
+#include "../src/DriverTimeline.h"
+#include "../src/FleetAggregate.h"
+#include "../src/FleetIndex.h"
+#include "../src/FleetProfile.h"
+#include "../src/MappedFile.h"
+#include "../src/ReportIO.h"
+#include "../src/ReportParser.h"
+#include "../src/ReportStore.h"
+#include "../src/SegmentedReportStore.h"
+#include "../src/Trace.h"
+#include "../src/Utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define FLEET_TOOL_MAX_LISTED_MACHINES (20u)
+#define FLEET_TOOL_MAX_LISTED_VERSIONS (40u)
+
+static const char* FindArg(int argc, char** argv, const char* name)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return argv[i + 1];
+    }
+    return nullptr;
+}
+
+static bool HasFlag(int argc, char** argv, const char* name)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static double MillisecondsSince(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Report paths in a stable order, directories expanded to the '.csv' files in them
+static std::vector<std::filesystem::path> CollectReportPaths(int argc, char** argv)
+{
+    std::vector<std::filesystem::path> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i][0] == '-')
+        {
+            if (std::strcmp(argv[i], "--threshold") == 0 || std::strcmp(argv[i], "--out-dir") == 0 || std::strcmp(argv[i], "--store") == 0
+                || std::strcmp(argv[i], "--ingest") == 0 || std::strcmp(argv[i], "--query") == 0 || std::strcmp(argv[i], "--timeline") == 0
+                || std::strcmp(argv[i], "--cell") == 0 || std::strcmp(argv[i], "--threads") == 0 || std::strcmp(argv[i], "--repeat") == 0
+                || std::strcmp(argv[i], "--arrow") == 0 || std::strcmp(argv[i], "--trace") == 0)
+                ++i;
+            continue;
+        }
+
+        std::error_code error;
+        if (!std::filesystem::is_directory(argv[i], error))
+        {
+            paths.emplace_back(argv[i]);
+            continue;
+        }
+
+        std::vector<std::filesystem::path> directoryPaths;
+        for (const auto& entry : std::filesystem::directory_iterator(argv[i], error))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".csv")
+                directoryPaths.push_back(entry.path());
+        }
+        std::sort(directoryPaths.begin(), directoryPaths.end());
+        paths.insert(paths.end(), directoryPaths.begin(), directoryPaths.end());
+    }
+    return paths;
+}
+
+static int Ingest(const std::filesystem::path& storePath, const std::vector<std::filesystem::path>& paths)
+{
+    ReportStore store;
+    std::error_code error;
+    if (std::filesystem::exists(storePath, error) && !store.Load(storePath))
+    {
+        std::fprintf(stderr, "'%s' isn't a report store\n", storePath.u8string().c_str());
+        return 2;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t read = 0u;
+    size_t added = 0u;
+    uintmax_t csvBytes = 0u;
+    for (const std::filesystem::path& path : paths)
+    {
+        const bool imported = ImportSupportReportsCSV(path, [&](const SupportReport& report)
+        {
+            read++;
+            added += store.Add(report) ? 1u : 0u;
+        });
+        if (!imported)
+        {
+            std::fprintf(stderr, "Skipping '%s', couldn't read it\n", path.u8string().c_str());
+            continue;
+        }
+        csvBytes += std::filesystem::file_size(path, error);
+    }
+
+    if (!store.Save(storePath))
+    {
+        std::fprintf(stderr, "Couldn't write '%s'\n", storePath.u8string().c_str());
+        return 2;
+    }
+
+    std::printf("%zu reports read (%llu bytes of .csv), %zu new\n", read, static_cast<unsigned long long>(csvBytes), added);
+    std::printf("Store holds %llu reports as %zu unique, %zu bytes, %.3f ms\n", static_cast<unsigned long long>(store.GetReportCount()),
+        store.GetUniqueCount(), store.GetStoredBytes(), MillisecondsSince(start));
+    return 0;
+}
+
+static int WriteProfiles(const FleetProfileBuilder& fleet, const double threshold, const std::filesystem::path& outDir)
+{
+    const uint64_t everywhere = fleet.GetReportCount();
+    const uint64_t thresholdCount = fleet.GetThresholdCount(threshold);
+
+    const uint32_t percent = static_cast<uint32_t>(threshold * 100.0 + 0.5);
+    const std::string intersectionName = "Fleet intersection of " + std::to_string(everywhere) + " reports";
+    const std::string thresholdName = "Fleet " + std::to_string(percent) + "% of " + std::to_string(everywhere) + " reports";
+    const std::filesystem::path intersectionPath = outDir / "Fleet_Intersection.csv";
+    const std::filesystem::path thresholdPath = outDir / ("Fleet_" + std::to_string(percent) + "pct.csv");
+
+    SupportReport profile;
+    fleet.BuildReport(everywhere, intersectionName.c_str(), profile);
+    bool written = ExportSupportReportCSV(intersectionPath, profile);
+    fleet.BuildReport(thresholdCount, thresholdName.c_str(), profile);
+    written = ExportSupportReportCSV(thresholdPath, profile) && written;
+    if (!written)
+    {
+        std::fprintf(stderr, "Couldn't write the profiles to '%s'\n", outDir.u8string().c_str());
+        return 2;
+    }
+
+    std::printf("%-24s %10s %10s\n", "Formats passing", "all", (std::to_string(percent) + "%").c_str());
+    for (size_t capability = 0u; capability < fleet.GetCapabilities().size(); ++capability)
+    {
+        std::printf("%-24s %10u %10u\n", fleet.GetCapabilities()[capability].c_str(), fleet.CountFormats(capability, everywhere),
+            fleet.CountFormats(capability, thresholdCount));
+    }
+    std::printf("%llu reports, %u%% = %llu of them\n", static_cast<unsigned long long>(everywhere), percent, static_cast<unsigned long long>(thresholdCount));
+    return 0;
+}
+
+// A report store (.dfss), or what a collector gathered, as a store directory or a single segment (.dfsg).
+// Segment records keep their weights, identical reports across segments are merged like ingest does.
+static bool LoadReportStore(const char* storePath, ReportStore& outStore)
+{
+    std::error_code error;
+    const bool directory = std::filesystem::is_directory(storePath, error);
+    if (!directory && std::filesystem::path(storePath).extension() != ".dfsg")
+        return outStore.Load(storePath);
+
+    SupportReport report;
+    bool decoded = true;
+    const SegmentReader::RecordCallback addRecord = [&](const uint64_t, const uint8_t* payload, const uint32_t size, const uint32_t weight)
+    {
+        if (DecodeReportPayload(payload, size, report))
+            outStore.Add(report, weight);
+        else
+            decoded = false;
+    };
+
+    if (directory)
+    {
+        SegmentedReportStore segments;
+        if (!segments.Open(storePath, true))
+            return false;
+        segments.ForEach(addRecord);
+    }
+    else if (!ReadSegment(storePath, addRecord))
+    {
+        return false;
+    }
+
+    if (!decoded)
+        std::fprintf(stderr, "Skipped records of '%s' that didn't decode\n", storePath);
+    return true;
+}
+
+// Hands every report of the store, weighted, then every report file to callback
+static bool ForEachReport(const char* storePath, const std::vector<std::filesystem::path>& paths,
+    const std::function<void(const SupportReport&, const ReportSource&)>& callback)
+{
+    if (storePath)
+    {
+        ReportStore store;
+        if (!LoadReportStore(storePath, store))
+        {
+            std::fprintf(stderr, "Couldn't read '%s'\n", storePath);
+            return false;
+        }
+        store.ForEachReport(callback);
+    }
+
+    // A file may hold any number of reports one after another, e.g. several exports concatenated
+    for (const std::filesystem::path& path : paths)
+    {
+        const bool imported = ImportSupportReportsCSV(path, [&callback](const SupportReport& report) { callback(report, MakeReportSource(report)); });
+        if (!imported)
+            std::fprintf(stderr, "Skipping '%s', couldn't read it\n", path.u8string().c_str());
+    }
+    return true;
+}
+
+static bool ForEachSource(const char* storePath, const std::vector<std::filesystem::path>& paths,
+    const std::function<void(const ReportSource&)>& callback)
+{
+    return ForEachReport(storePath, paths, [&callback](const SupportReport&, const ReportSource& source) { callback(source); });
+}
+
+static int BuildProfiles(const char* storePath, const std::vector<std::filesystem::path>& paths, const double threshold,
+    const std::filesystem::path& outDir)
+{
+    const auto start = std::chrono::steady_clock::now();
+    FleetProfileBuilder fleet;
+    size_t reportsWalked = 0u;
+    const bool read = ForEachSource(storePath, paths, [&fleet, &reportsWalked](const ReportSource& source)
+    {
+        fleet.AddReport(source);
+        reportsWalked++;
+    });
+    if (!read)
+        return 2;
+
+    if (fleet.GetReportCount() == 0u)
+    {
+        std::fprintf(stderr, "No reports read\n");
+        return 2;
+    }
+
+    const double buildMs = MillisecondsSince(start);
+    const int result = WriteProfiles(fleet, threshold, outDir);
+    std::printf("%zu reports walked in %.3f ms\n", reportsWalked, buildMs);
+    return result;
+}
+
+static int ExportArrow(const char* storePath, const std::vector<std::filesystem::path>& paths, const std::filesystem::path& outDir)
+{
+    // The aggregate needs every report at once, the report table is built on the way
+    const auto start = std::chrono::steady_clock::now();
+    ArrowTableWriter reportTable;
+    std::vector<SupportReport> reports;
+    std::vector<uint32_t> weights;
+    const bool read = ForEachReport(storePath, paths, [&](const SupportReport& report, const ReportSource& source)
+    {
+        AppendSupportReportRows(reportTable, report, source.Weight);
+        reports.push_back(report);
+        weights.push_back(source.Weight);
+    });
+    if (!read)
+        return 2;
+    if (reports.empty())
+    {
+        std::fprintf(stderr, "No reports read\n");
+        return 2;
+    }
+
+    std::vector<ReportSource> sources;
+    for (size_t report = 0u; report < reports.size(); ++report)
+    {
+        sources.push_back(MakeReportSource(reports[report]));
+        sources.back().Weight = weights[report];
+    }
+    FleetAggregate aggregate;
+    aggregate.Build(sources);
+    ArrowTableWriter aggregateTable;
+    AppendFleetAggregateRows(aggregateTable, aggregate);
+
+    const std::filesystem::path reportsPath = outDir / "Fleet_Reports.arrow";
+    const std::filesystem::path aggregatePath = outDir / "Fleet_Aggregate.arrow";
+    if (!reportTable.Write(reportsPath) || !aggregateTable.Write(aggregatePath))
+    {
+        std::fprintf(stderr, "Couldn't write the Arrow files to '%s'\n", outDir.u8string().c_str());
+        return 2;
+    }
+
+    std::error_code error;
+    std::printf("%s: %zu rows, %llu bytes\n", reportsPath.u8string().c_str(), reportTable.GetRowCount(),
+        static_cast<unsigned long long>(std::filesystem::file_size(reportsPath, error)));
+    std::printf("%s: %zu rows, %llu bytes\n", aggregatePath.u8string().c_str(), aggregateTable.GetRowCount(),
+        static_cast<unsigned long long>(std::filesystem::file_size(aggregatePath, error)));
+    std::printf("%zu reports exported in %.3f ms\n", reports.size(), MillisecondsSince(start));
+    return 0;
+}
+
+static int RunQuery(const char* expression, const char* storePath, const std::vector<std::filesystem::path>& paths)
+{
+    const auto start = std::chrono::steady_clock::now();
+    FleetIndex index;
+    if (!ForEachSource(storePath, paths, [&index](const ReportSource& source) { index.AddReport(source); }))
+        return 2;
+    const double buildMs = MillisecondsSince(start);
+
+    MachineSet machines;
+    std::string error;
+    const auto queryStart = std::chrono::steady_clock::now();
+    const bool parsed = index.Query(expression, machines, error);
+    const double queryMs = MillisecondsSince(queryStart);
+    if (!parsed)
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+
+    const std::vector<uint32_t> ids = machines.ToVector();
+    for (size_t i = 0u; i < ids.size() && i < FLEET_TOOL_MAX_LISTED_MACHINES; ++i)
+        std::printf("%8u  %s\n", ids[i], index.GetMachineName(ids[i]).c_str());
+    if (ids.size() > FLEET_TOOL_MAX_LISTED_MACHINES)
+        std::printf("... and %zu more\n", ids.size() - FLEET_TOOL_MAX_LISTED_MACHINES);
+
+    std::printf("%zu of %u reports (%llu of %llu machines) match\n", ids.size(), index.GetMachineCount(),
+        static_cast<unsigned long long>(index.GetWeightedCount(machines)), static_cast<unsigned long long>(index.GetWeightedCount(index.GetAll())));
+    std::printf("Index built in %.3f ms, %zu bytes, query took %.1f us\n", buildMs, index.GetMemoryBytes(), queryMs * 1000.0);
+    return 0;
+}
+
+static size_t CountBits(const uint64_t word)
+{
+    return std::bitset<64>(word).count();
+}
+
+static std::string DriverString(const DriverTimeline& timeline, const size_t version)
+{
+    return DriverVersionToString(timeline.GetDriverVersion(version));
+}
+
+// "FORMAT:Capability" as a timeline row and capability, the DXGI_FORMAT_ prefix is optional
+static bool ParseCell(const DriverTimeline& timeline, const std::string& cell, size_t& outRow, size_t& outCapability)
+{
+    const size_t colon = cell.find(':');
+    if (colon == std::string::npos)
+        return false;
+
+    std::string formatName = cell.substr(0u, colon);
+    if (formatName.compare(0u, 12u, "DXGI_FORMAT_") != 0)
+        formatName = "DXGI_FORMAT_" + formatName;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    if (!D3DFormatFromString(formatName, format))
+        return false;
+
+    const std::vector<DXGI_FORMAT>& formats = timeline.GetFormats();
+    const std::vector<std::string>& capabilities = timeline.GetCapabilities();
+    outRow = std::find(formats.begin(), formats.end(), format) - formats.begin();
+    outCapability = std::find(capabilities.begin(), capabilities.end(), cell.substr(colon + 1u)) - capabilities.begin();
+    return outRow < formats.size() && outCapability < capabilities.size();
+}
+
+static int RunTimeline(const char* adapter, const char* cell, const char* storePath, const std::vector<std::filesystem::path>& paths)
+{
+    char* end = nullptr;
+    const uint32_t vendorId = static_cast<uint32_t>(std::strtoul(adapter, &end, 16));
+    const uint32_t deviceId = *end == ':' ? static_cast<uint32_t>(std::strtoul(end + 1, nullptr, 16)) : 0u;
+    if (*end != ':')
+    {
+        std::fprintf(stderr, "'%s' isn't VENDOR:DEVICE\n", adapter);
+        return 2;
+    }
+
+    // Only the adapter's own reports are kept
+    std::vector<SupportReport> reports;
+    const bool read = ForEachReport(storePath, paths, [&](const SupportReport& report, const ReportSource&)
+    {
+        if (report.Adapter.VendorId == vendorId && report.Adapter.DeviceId == deviceId)
+            reports.push_back(report);
+    });
+    if (!read)
+        return 2;
+
+    std::vector<const SupportReport*> adapterReports;
+    for (const SupportReport& report : reports)
+        adapterReports.push_back(&report);
+    const auto start = std::chrono::steady_clock::now();
+    DriverTimeline timeline;
+    timeline.Build(adapterReports);
+    const double buildMs = MillisecondsSince(start);
+    if (timeline.GetVersionCount() == 0u)
+    {
+        std::fprintf(stderr, "No reports from %04X:%04X\n", vendorId, deviceId);
+        return 2;
+    }
+
+    std::printf("%s (%04X:%04X), %zu driver versions from %zu reports\n", timeline.GetName().c_str(), vendorId, deviceId, timeline.GetVersionCount(),
+        reports.size());
+    std::printf("Built in %.3f ms, %zu bytes: %zu of deltas (%.1f per driver after the first), %zu keyframes\n", buildMs, timeline.GetEncodedBytes(),
+        timeline.GetDeltaBytes(), timeline.GetVersionCount() > 1u ? static_cast<double>(timeline.GetDeltaBytes()) / (timeline.GetVersionCount() - 1u) : 0.0,
+        timeline.GetKeyframeCount());
+
+    if (cell)
+    {
+        size_t row = 0u;
+        size_t capability = 0u;
+        if (!ParseCell(timeline, cell, row, capability))
+        {
+            std::fprintf(stderr, "'%s' isn't a FORMAT:Capability this adapter reported\n", cell);
+            return 2;
+        }
+
+        size_t firstPass = 0u;
+        size_t firstRegression = 0u;
+        const auto searchStart = std::chrono::steady_clock::now();
+        const bool passed = timeline.FindFirstPass(row, capability, firstPass);
+        const bool regressed = timeline.FindFirstRegression(row, capability, firstRegression);
+        const double searchMs = MillisecondsSince(searchStart);
+        std::printf("First passed:    %s\n", passed ? DriverString(timeline, firstPass).c_str() : "never");
+        std::printf("First regressed: %s\n", regressed ? DriverString(timeline, firstRegression).c_str() : "never");
+        std::printf("Both found in %.1f us\n", searchMs * 1000.0);
+        return 0;
+    }
+
+    // What every driver changed against the one before it
+    std::vector<DriverTimeline::RowState> previous;
+    size_t listed = 0u;
+    timeline.Replay([&](const size_t version, const uint64_t driverVersion, const std::vector<DriverTimeline::RowState>& rows)
+    {
+        uint32_t gained = 0u;
+        uint32_t lost = 0u;
+        for (size_t row = 0u; version > 0u && row < rows.size(); ++row)
+        {
+            gained += static_cast<uint32_t>(CountBits(rows[row].Pass & ~previous[row].Pass));
+            lost += static_cast<uint32_t>(CountBits(previous[row].Pass & ~rows[row].Pass));
+        }
+        previous = rows;
+
+        if ((version == 0u || gained || lost) && listed++ < FLEET_TOOL_MAX_LISTED_VERSIONS)
+            std::printf("%-20s +%u -%u\n", DriverVersionToString(driverVersion).c_str(), gained, lost);
+    });
+    if (listed > FLEET_TOOL_MAX_LISTED_VERSIONS)
+        std::printf("... and %zu more that changed something\n", listed - FLEET_TOOL_MAX_LISTED_VERSIONS);
+    return 0;
+}
+
+static int RunParseBench(const std::vector<std::filesystem::path>& paths, const uint32_t threadCount, const uint32_t repeat)
+{
+    MappedFile file;
+    if (paths.size() != 1u || !file.Open(paths.front()))
+    {
+        std::fprintf(stderr, "--parse-bench takes one readable report file\n");
+        return 2;
+    }
+
+    const auto planStart = std::chrono::steady_clock::now();
+    ReportCSVParser parser;
+    parser.Plan(reinterpret_cast<const char*>(file.GetData()), file.GetSize(), threadCount);
+    const double planMs = MillisecondsSince(planStart);
+
+    // The first run also faults the file in, so it only counts when it's the only one
+    std::atomic<uint64_t> rows{ 0u };
+    ReportCSVParser::Stats stats{};
+    double bestMs = 0.0;
+    for (uint32_t run = 0u; run <= repeat; ++run)
+    {
+        rows = 0u;
+        const auto start = std::chrono::steady_clock::now();
+        stats = parser.Parse(paths.front().stem().u8string().c_str(), [&rows](const size_t, const SupportReport& report) { rows += report.Table.size(); });
+        const double ms = MillisecondsSince(start);
+        if (run == 1u || repeat == 0u || ms < bestMs)
+            bestMs = ms;
+    }
+
+    std::printf("%llu bytes, %llu reports, %llu format rows\n", static_cast<unsigned long long>(stats.Bytes),
+        static_cast<unsigned long long>(stats.Reports), static_cast<unsigned long long>(rows.load()));
+    std::printf("%zu chunks on %u threads, %s scanner, planned in %.3f ms\n", stats.Chunks, stats.Threads, ReportCSVParser::GetScannerName(), planMs);
+    std::printf("Best of %u: %.3f ms, %.2f GB/s\n", std::max(repeat, 1u), bestMs, static_cast<double>(stats.Bytes) / (bestMs * 1e6));
+    return 0;
+}
+
+static int RunCommand(int argc, char** argv)
+{
+    const std::vector<std::filesystem::path> paths = CollectReportPaths(argc, argv);
+    if (const char* storePath = FindArg(argc, argv, "--ingest"))
+        return Ingest(storePath, paths);
+
+    if (HasFlag(argc, argv, "--parse-bench"))
+    {
+        const char* threads = FindArg(argc, argv, "--threads");
+        const char* repeat = FindArg(argc, argv, "--repeat");
+        return RunParseBench(paths, threads ? static_cast<uint32_t>(std::strtoul(threads, nullptr, 10)) : 0u,
+            repeat ? static_cast<uint32_t>(std::strtoul(repeat, nullptr, 10)) : 5u);
+    }
+
+    const char* storePath = FindArg(argc, argv, "--store");
+    if (const char* expression = FindArg(argc, argv, "--query"))
+        return RunQuery(expression, storePath, paths);
+    if (const char* adapter = FindArg(argc, argv, "--timeline"))
+        return RunTimeline(adapter, FindArg(argc, argv, "--cell"), storePath, paths);
+    if (const char* outDir = FindArg(argc, argv, "--arrow"))
+        return ExportArrow(storePath, paths, outDir);
+
+    if (!HasFlag(argc, argv, "--profile") || (paths.empty() && !storePath))
+    {
+        std::fprintf(stderr, "Usage: dfse_fleet --ingest <store> <report .csv or directory> [...]\n"
+            "       dfse_fleet --profile [--threshold 0.99] [--out-dir .] [--store <store>] [<report .csv or directory> ...]\n"
+            "       dfse_fleet --query <expression> [--store <store>] [<report .csv or directory> ...]\n"
+            "       dfse_fleet --timeline VENDOR:DEVICE [--cell FORMAT:Capability] [--store <store>] [<report .csv or directory> ...]\n"
+            "       dfse_fleet --arrow <out-dir> [--store <store>] [<report .csv or directory> ...]\n"
+            "       dfse_fleet --parse-bench <reports .csv> [--threads 0] [--repeat 5]\n");
+        return 2;
+    }
+
+    const char* threshold = FindArg(argc, argv, "--threshold");
+    const char* outDir = FindArg(argc, argv, "--out-dir");
+    return BuildProfiles(storePath, paths, threshold ? std::strtod(threshold, nullptr) : 0.99, outDir ? outDir : ".");
+}
+
+int main(int argc, char** argv)
+{
+    const char* tracePath = FindArg(argc, argv, "--trace");
+    if (tracePath)
+    {
+        SetTraceThreadName("Main");
+        StartTrace();
+    }
+
+    const int result = RunCommand(argc, argv);
+    if (tracePath && !WriteTraceJSON(tracePath))
+        std::fprintf(stderr, "Couldn't write %s\n", tracePath);
+    return result;
+}
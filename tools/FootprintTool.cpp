@@ -0,0 +1,209 @@
+// Texture footprints without a device.
+//
+// Usage: dfse_footprint --table [--mips N] [--array N]   CSV of copyable bytes for every format x square power of two size x mip count
+//        dfse_footprint --validate DXGI_Footprints.csv   Check the CPU calculator against footprints recorded on a device
+//                                                         (File > Export copyable footprints in the app)
+//        dfse_footprint --allocations DXGI_AllocationInfo.csv [--report DXGI_Output.csv]
+//                                                         Run the allocation probe against a recording (File > Export allocation sizes)
+//                                                         and compare the driver's sizes with the CPU estimate
+
+#include "../src/AllocationProbe.h"
+#include "../src/FormatInfo.h"
+#include "../src/ReportIO.h"
+#include "../src/TextureFootprint.h"
+#include "../src/Utils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const char* FindArg(int argc, char** argv, const char* name)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return argv[i + 1];
+    }
+    return nullptr;
+}
+
+static bool HasFlag(int argc, char** argv, const char* name)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static int PrintTable(const uint32_t maxMips, const uint32_t arraySize)
+{
+    std::vector<DXGI_FORMAT> formats;
+    for (uint32_t i = 1u; i < FORMAT_INFO_MAX_FORMATS; ++i)
+    {
+        if (GetFormatInfo(static_cast<DXGI_FORMAT>(i)).Channels != 0u)
+            formats.push_back(static_cast<DXGI_FORMAT>(i));
+    }
+
+    std::vector<uint32_t> sizes;
+    for (uint32_t size = 1u; size <= 16384u; size *= 2u)
+        sizes.push_back(size);
+
+    const auto start = std::chrono::steady_clock::now();
+    FootprintTable table;
+    table.Build(formats, sizes, sizes, maxMips, arraySize);
+    const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("DXGI Format,Size");
+    for (uint32_t mips = 1u; mips <= table.GetMaxMipLevels(); ++mips)
+        std::printf(",%u mips", mips);
+    std::printf("\n");
+
+    for (size_t format = 0u; format < formats.size(); ++format)
+    {
+        for (size_t size = 0u; size < sizes.size(); ++size)
+        {
+            std::printf("%s,%ux%u", D3DFormatToString(formats[format]), sizes[size], sizes[size]);
+            for (uint32_t mips = 1u; mips <= table.GetMaxMipLevels(); ++mips)
+                std::printf(",%llu", static_cast<unsigned long long>(table.GetCopyableBytes(format, size, mips)));
+            std::printf("\n");
+        }
+    }
+
+    std::fprintf(stderr, "%zu formats x %zu sizes x %u mip counts in %.3f ms\n", formats.size(), sizes.size(), table.GetMaxMipLevels(), buildMs);
+    return 0;
+}
+
+static int Validate(const char* path)
+{
+    std::vector<FootprintRecord> records;
+    if (!ImportFootprintRecordsCSV(path, records) || records.empty())
+    {
+        std::fprintf(stderr, "Couldn't read any footprints from '%s'\n", path);
+        return 2;
+    }
+
+    size_t mismatches = 0u;
+    std::vector<SubresourceFootprint> layouts;
+    for (const FootprintRecord& record : records)
+    {
+        TextureFootprint footprint{};
+        const bool valid = CalculateTextureFootprint(record.Desc, footprint, &layouts);
+        const bool deviceValid = record.TotalBytes != UINT64_MAX;
+
+        bool match = valid == deviceValid;
+        if (match && valid)
+        {
+            match = footprint.CopyableBytes == record.TotalBytes && layouts.size() == record.Layouts.size();
+            for (size_t i = 0u; match && i < layouts.size(); ++i)
+            {
+                match = layouts[i].Offset == record.Layouts[i].Offset && layouts[i].RowPitch == record.Layouts[i].RowPitch
+                    && layouts[i].NumRows == record.Layouts[i].NumRows && layouts[i].RowSizeInBytes == record.Layouts[i].RowSizeInBytes;
+            }
+        }
+
+        if (!match)
+        {
+            mismatches++;
+            std::printf("MISMATCH %s dim %u %ux%ux%u mips %u: device %lld bytes, calculated %lld bytes\n", D3DFormatToString(record.Desc.Format),
+                static_cast<uint32_t>(record.Desc.Dimension) + 1u, record.Desc.Width, record.Desc.Height, record.Desc.DepthOrArraySize, record.Desc.MipLevels,
+                deviceValid ? static_cast<long long>(record.TotalBytes) : -1ll, valid ? static_cast<long long>(footprint.CopyableBytes) : -1ll);
+        }
+    }
+
+    std::printf("%zu of %zu recorded footprints match\n", records.size() - mismatches, records.size());
+    return mismatches == 0u ? 0 : 1;
+}
+
+static int ReplayAllocations(const char* path, const char* reportPath)
+{
+    std::vector<AllocationRecord> recorded;
+    if (!ImportAllocationRecordsCSV(path, recorded))
+    {
+        std::fprintf(stderr, "Couldn't read '%s'\n", path);
+        return 2;
+    }
+
+    // The support table the recording was probed with, or one rebuilt from the recorded descs
+    SupportTable table;
+    if (reportPath)
+    {
+        SupportReport report;
+        if (!ImportSupportReportCSV(reportPath, report))
+        {
+            std::fprintf(stderr, "Couldn't read '%s'\n", reportPath);
+            return 2;
+        }
+        table = std::move(report.Table);
+    }
+    else
+    {
+        for (const AllocationRecord& record : recorded)
+        {
+            std::vector<FormatSupport>& supportFlags = table[record.Probe.Desc.Format];
+            supportFlags.resize(SUPPORT_FLAGS_COUNT, FormatSupport::FAIL);
+            supportFlags[1] = FormatSupport::PASS;
+            if (record.Probe.Usage & AllocationUsage_RenderTarget)
+                supportFlags[4] = FormatSupport::PASS;
+            if (record.Probe.Usage & AllocationUsage_DepthStencil)
+                supportFlags[5] = FormatSupport::PASS;
+        }
+    }
+
+    std::vector<AllocationProbeDesc> descs;
+    AppendAllocationProbeDescs(table, descs);
+
+    ReplayAllocationProvider provider(recorded);
+    std::vector<AllocationRecord> records;
+    const auto start = std::chrono::steady_clock::now();
+    const AllocationProbeStats stats = RunAllocationProbe(provider, descs, records);
+    const double probeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // How far the linear layout estimate is from what the driver wants in a heap
+    size_t underestimated = 0u;
+    size_t compared = 0u;
+    for (const AllocationRecord& record : records)
+    {
+        TextureFootprint footprint{};
+        if (record.Info.SizeInBytes == UINT64_MAX || !CalculateTextureFootprint(record.Probe.Desc, footprint))
+            continue;
+
+        compared++;
+        if (footprint.PlacedBytesEstimate < record.Info.SizeInBytes)
+        {
+            underestimated++;
+            std::printf("UNDER %s %ux%u mips %u %s: driver %llu bytes (%llu aligned), estimated %llu bytes\n", D3DFormatToString(record.Probe.Desc.Format),
+                record.Probe.Desc.Width, record.Probe.Desc.Height, record.Probe.Desc.MipLevels, AllocationUsageToString(record.Probe.Usage).c_str(),
+                static_cast<unsigned long long>(record.Info.SizeInBytes), static_cast<unsigned long long>(record.Info.Alignment),
+                static_cast<unsigned long long>(footprint.PlacedBytesEstimate));
+        }
+    }
+
+    std::printf("%zu descs in %zu calls, %zu rejected, %.3f ms\n", stats.Descs, stats.Calls, stats.Rejected, probeMs);
+    std::printf("%zu of %zu estimates cover the driver's size\n", compared - underestimated, compared);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (const char* path = FindArg(argc, argv, "--allocations"))
+        return ReplayAllocations(path, FindArg(argc, argv, "--report"));
+
+    if (const char* path = FindArg(argc, argv, "--validate"))
+        return Validate(path);
+
+    if (HasFlag(argc, argv, "--table"))
+    {
+        const char* mips = FindArg(argc, argv, "--mips");
+        const char* arraySize = FindArg(argc, argv, "--array");
+        return PrintTable(mips ? static_cast<uint32_t>(std::strtoul(mips, nullptr, 10)) : 15u,
+            arraySize ? static_cast<uint32_t>(std::strtoul(arraySize, nullptr, 10)) : 1u);
+    }
+
+    std::fprintf(stderr, "Usage: dfse_footprint --table [--mips N] [--array N] | --validate <recorded footprints .csv>"
+        " | --allocations <recorded allocation info .csv> [--report <support table .csv>]\n");
+    return 2;
+}
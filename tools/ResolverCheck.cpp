@@ -0,0 +1,99 @@
+// Known-answer checks for the format fallback resolver, run by ctest.
+// Depth/stencil formats, their typeless resources and their plane views only fall back within
+// the same role and plane layout, and colour formats never fall back to any of them.
+
+#include "../src/FormatInfo.h"
+#include "../src/FormatResolver.h"
+#include "../src/Utils.h"
+
+#include <cstdio>
+#include <vector>
+
+static int g_failures = 0;
+
+static void CheckChain(const DXGI_FORMAT desired, const std::vector<DXGI_FORMAT>& expected)
+{
+    const std::vector<DXGI_FORMAT>& chain = FormatResolver::GetFallbackChain(desired);
+    if (chain == expected)
+        return;
+
+    g_failures++;
+    std::printf("FAIL: chain of %s is", D3DFormatToString(desired));
+    for (const DXGI_FORMAT format : chain)
+        std::printf(" %s", D3DFormatToString(format));
+    std::printf("\n");
+}
+
+static void CheckResolve(const FormatResolver& resolver, const DXGI_FORMAT desired, const uint32_t usage, const DXGI_FORMAT expected)
+{
+    const DXGI_FORMAT resolved = resolver.Resolve(desired, usage);
+    if (resolved == expected)
+        return;
+
+    g_failures++;
+    std::printf("FAIL: %s for usage 0x%x resolved to %s, expected %s\n", D3DFormatToString(desired), usage, D3DFormatToString(resolved), D3DFormatToString(expected));
+}
+
+int main()
+{
+    // D24 and D32 families: DSVs, typeless resources, depth SRVs and stencil SRVs
+    CheckChain(DXGI_FORMAT_D24_UNORM_S8_UINT, { DXGI_FORMAT_D24_UNORM_S8_UINT, DXGI_FORMAT_D32_FLOAT_S8X24_UINT });
+    CheckChain(DXGI_FORMAT_D32_FLOAT_S8X24_UINT, { DXGI_FORMAT_D32_FLOAT_S8X24_UINT });
+    CheckChain(DXGI_FORMAT_D16_UNORM, { DXGI_FORMAT_D16_UNORM, DXGI_FORMAT_D32_FLOAT });
+    CheckChain(DXGI_FORMAT_D32_FLOAT, { DXGI_FORMAT_D32_FLOAT });
+    CheckChain(DXGI_FORMAT_R24G8_TYPELESS, { DXGI_FORMAT_R24G8_TYPELESS, DXGI_FORMAT_R32G8X24_TYPELESS });
+    CheckChain(DXGI_FORMAT_R32G8X24_TYPELESS, { DXGI_FORMAT_R32G8X24_TYPELESS });
+    CheckChain(DXGI_FORMAT_R24_UNORM_X8_TYPELESS, { DXGI_FORMAT_R24_UNORM_X8_TYPELESS, DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS });
+    CheckChain(DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS, { DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS });
+    CheckChain(DXGI_FORMAT_X24_TYPELESS_G8_UINT, { DXGI_FORMAT_X24_TYPELESS_G8_UINT, DXGI_FORMAT_X32_TYPELESS_G8X24_UINT });
+    CheckChain(DXGI_FORMAT_X32_TYPELESS_G8X24_UINT, { DXGI_FORMAT_X32_TYPELESS_G8X24_UINT });
+
+    // No colour chain reaches into the depth family
+    for (uint32_t i = 1u; i < FORMAT_INFO_MAX_FORMATS; ++i)
+    {
+        const DXGI_FORMAT desired = static_cast<DXGI_FORMAT>(i);
+        const FormatInfo& info = GetFormatInfo(desired);
+        if (info.Channels == 0u || info.PlaneCount > 1u || (info.Flags & (FormatInfoFlags_Depth | FormatInfoFlags_Stencil)))
+            continue;
+
+        for (const DXGI_FORMAT candidate : FormatResolver::GetFallbackChain(desired))
+        {
+            const FormatInfo& candidateInfo = GetFormatInfo(candidate);
+            if (candidateInfo.PlaneCount > 1u || (candidateInfo.Flags & (FormatInfoFlags_Depth | FormatInfoFlags_Stencil)))
+            {
+                g_failures++;
+                std::printf("FAIL: colour format %s falls back to %s\n", D3DFormatToString(desired), D3DFormatToString(candidate));
+            }
+        }
+    }
+
+    // An adapter with only the 32-bit depth family: the D24 resource and both its views move there together
+    SupportTable table;
+    const std::vector<FormatSupport> allPass(SUPPORT_FLAGS_COUNT, FormatSupport::PASS);
+    const std::vector<FormatSupport> allFail(SUPPORT_FLAGS_COUNT, FormatSupport::FAIL);
+    table[DXGI_FORMAT_R24G8_TYPELESS] = allFail;
+    table[DXGI_FORMAT_D24_UNORM_S8_UINT] = allFail;
+    table[DXGI_FORMAT_R24_UNORM_X8_TYPELESS] = allFail;
+    table[DXGI_FORMAT_X24_TYPELESS_G8_UINT] = allFail;
+    table[DXGI_FORMAT_R32G8X24_TYPELESS] = allPass;
+    table[DXGI_FORMAT_D32_FLOAT_S8X24_UINT] = allPass;
+    table[DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS] = allPass;
+    table[DXGI_FORMAT_X32_TYPELESS_G8X24_UINT] = allPass;
+    table[DXGI_FORMAT_R32G32_TYPELESS] = allPass;
+    table[DXGI_FORMAT_R32_FLOAT] = allPass;
+
+    FormatResolver resolver;
+    resolver.Build(table);
+    CheckResolve(resolver, DXGI_FORMAT_R24G8_TYPELESS, 1u, DXGI_FORMAT_R32G8X24_TYPELESS);
+    CheckResolve(resolver, DXGI_FORMAT_D24_UNORM_S8_UINT, 1u, DXGI_FORMAT_D32_FLOAT_S8X24_UINT);
+    CheckResolve(resolver, DXGI_FORMAT_R24_UNORM_X8_TYPELESS, 1u, DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS);
+    CheckResolve(resolver, DXGI_FORMAT_X24_TYPELESS_G8_UINT, 1u, DXGI_FORMAT_X32_TYPELESS_G8X24_UINT);
+    CheckResolve(resolver, DXGI_FORMAT_D32_FLOAT_S8X24_UINT, 1u, DXGI_FORMAT_D32_FLOAT_S8X24_UINT);
+    CheckResolve(resolver, DXGI_FORMAT_R32G8X24_TYPELESS, 1u, DXGI_FORMAT_R32G8X24_TYPELESS);
+
+    if (g_failures)
+        std::printf("%d resolver check(s) failed\n", g_failures);
+    else
+        std::printf("Resolver checks passed\n");
+    return g_failures ? 1 : 0;
+}
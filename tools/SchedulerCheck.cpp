@@ -0,0 +1,91 @@
+// Frame scheduler rules stepped with a fake clock, run by ctest.
+// Input gets its settle frames and a late hover frame, a redraw request gets exactly one frame,
+// and the message loop is told to sleep until the next timed frame or the next event.
+
+#include "../src/FrameScheduler.h"
+
+#include <cstdio>
+
+static int g_failures = 0;
+
+static void Check(const bool passed, const char* what)
+{
+    if (passed)
+        return;
+
+    g_failures++;
+    std::printf("FAIL: %s\n", what);
+}
+
+// Renders frames until none is due, returns how many it took
+static uint32_t DrainFrames(FrameScheduler& scheduler)
+{
+    uint32_t frames = 0u;
+    for (; scheduler.IsFrameDue() && frames < 100u; ++frames)
+        scheduler.ConsumeFrame();
+    return frames;
+}
+
+int main()
+{
+    using namespace std::chrono_literals;
+    FrameScheduler::TimePoint now{};
+    FrameScheduler scheduler([&now]() { return now; });
+
+    // The first frame is always drawn, then nothing until an event
+    Check(scheduler.IsFrameDue(), "first frame is due");
+    Check(scheduler.GetTimeUntilNextFrame() == FrameScheduler::Duration::zero(), "no sleep before the first frame");
+    Check(DrainFrames(scheduler) == 1u, "one first frame");
+    Check(scheduler.GetTimeUntilNextFrame() == FrameScheduler::Duration::max(), "idle sleeps until the next event");
+
+    // Input: settle frames straight away, then one more once hover delays have expired
+    scheduler.OnInput();
+    Check(DrainFrames(scheduler) == FrameScheduler::SettleFrameCount, "input draws the settle frames");
+    Check(scheduler.GetTimeUntilNextFrame() == FrameScheduler::HoverSettleDelay, "input schedules the hover frame");
+    now += FrameScheduler::HoverSettleDelay - 1ms;
+    Check(!scheduler.IsFrameDue(), "hover frame not due early");
+    Check(scheduler.GetTimeUntilNextFrame() == 1ms, "sleep until the hover frame");
+    now += 1ms;
+    Check(DrainFrames(scheduler) == 1u, "hover frame drawn once due");
+    Check(scheduler.GetTimeUntilNextFrame() == FrameScheduler::Duration::max(), "idle after the hover frame");
+
+    // A redraw request (new data from a worker) is one frame, no settle frames or hover wake-up
+    scheduler.RequestFrames(1u);
+    Check(DrainFrames(scheduler) == 1u, "redraw draws one frame");
+    Check(scheduler.GetTimeUntilNextFrame() == FrameScheduler::Duration::max(), "redraw schedules nothing after it");
+
+    // A smaller request doesn't cut pending settle frames short
+    scheduler.OnInput();
+    scheduler.RequestFrames(1u);
+    Check(DrainFrames(scheduler) == FrameScheduler::SettleFrameCount, "redraw keeps pending settle frames");
+    now += FrameScheduler::HoverSettleDelay;
+    DrainFrames(scheduler);
+
+    // Timed frames: the earliest is next, later ones stay scheduled once it has been drawn
+    scheduler.RequestFrameIn(400ms);
+    scheduler.RequestFrameIn(100ms);
+    scheduler.RequestFrameIn(800ms);
+    Check(!scheduler.IsFrameDue(), "timed frame not due yet");
+    Check(scheduler.GetTimeUntilNextFrame() == 100ms, "earliest timed frame is next");
+    now += 450ms;
+    Check(scheduler.GetTimeUntilNextFrame() == FrameScheduler::Duration::zero(), "overdue timed frame doesn't sleep");
+    Check(DrainFrames(scheduler) == 1u, "overdue timed frames drawn once");
+    Check(scheduler.GetTimeUntilNextFrame() == 350ms, "later timed frame still scheduled");
+    now += 350ms;
+    Check(DrainFrames(scheduler) == 1u, "later timed frame drawn once due");
+    Check(scheduler.GetTimeUntilNextFrame() == FrameScheduler::Duration::max(), "idle after the last timed frame");
+
+    // A hover frame followed by a longer request keeps both
+    scheduler.OnInput();
+    scheduler.RequestFrameIn(FrameScheduler::HoverSettleDelay + 400ms);
+    DrainFrames(scheduler);
+    now += FrameScheduler::HoverSettleDelay;
+    Check(DrainFrames(scheduler) == 1u, "hover frame drawn");
+    Check(scheduler.GetTimeUntilNextFrame() == 400ms, "request after the hover frame kept");
+
+    if (g_failures)
+        std::printf("%d scheduler check(s) failed\n", g_failures);
+    else
+        std::printf("Scheduler checks passed\n");
+    return g_failures ? 1 : 0;
+}
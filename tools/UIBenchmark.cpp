@@ -0,0 +1,290 @@
+// Headless benchmark for the support table UI.
+// Runs ImGuiLayer::OnRender against a null backend (no window, no D3D12, draw data is only
+// counted) with a synthetic support table, and reports CPU time, draw-list size and heap
+// allocations per frame. ImGui allocates through the app's pool allocator, as in the app.
+//
+// Usage: dfse_ui_bench [--rows N] [--cols N] [--frames N] [--width N] [--height N]
+//                      [--reports N --compare]   (comparison view against N-1 imported reports)
+//                      [--reports N --heatmap]   (fleet coverage heatmap over N reports)
+//                      [--reports N --timeline]  (driver timeline over N-1 drivers of the live adapter)
+//                      [--trace trace.json]      (Chrome trace-event JSON of every frame's zones)
+//                      [--font-cache file]       (load the baked font atlas from file, or bake and save it there)
+//                      [--alloc-overlay]         (draw the allocator stats overlay every frame)
+
+#include "../src/ImGuiAllocator.h"
+#include "../src/ImGuiLayer.h"
+#include "../src/Trace.h"
+#include "../src/UIBackend.h"
+#include "../ImGui/imgui.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count every operator new the process makes, ImGui's go through the pool allocator's counters
+static std::atomic<uint64_t> g_newCount{ 0u };
+
+void* operator new(size_t size)
+{
+    g_newCount++;
+    if (void* ptr = std::malloc(size ? size : 1u))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+class NullBackend : public UIBackend
+{
+public:
+    NullBackend(const uint32_t rows, const uint32_t columns, const uint32_t reports, const bool driverHistory, const uint32_t width, const uint32_t height)
+        : m_width(width), m_height(height)
+    {
+        m_gpuInfo.Name = "Null adapter";
+        m_gpuInfo.MaxFeatureLevel = "12_1";
+        m_gpuInfo.VendorId = 0x10DEu;
+
+        m_headerNames.reserve(columns);
+        for (uint32_t column = 0; column < columns; ++column)
+            m_headerNames.push_back("Capability " + std::to_string(column));
+
+        m_tableHeaders.push_back("DXGI Format");
+        for (const std::string& name : m_headerNames)
+            m_tableHeaders.push_back(name.c_str());
+
+        // Deterministic mix of PASS/FAIL/UNKN so every badge type gets drawn
+        uint32_t seed = 0x9E3779B9u;
+        m_supportTable.reserve(rows);
+        for (uint32_t row = 0; row < rows; ++row)
+        {
+            std::vector<FormatSupport> flags(columns);
+            for (FormatSupport& flag : flags)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const uint32_t roll = seed >> 24u;
+                flag = roll < 150u ? FormatSupport::PASS : (roll < 250u ? FormatSupport::FAIL : FormatSupport::UNKN);
+            }
+            m_supportTable.emplace(static_cast<DXGI_FORMAT>(row), std::move(flags));
+        }
+
+        const std::vector<uint32_t> referenceVendors{ 0x1002u, 0x10DEu, 0x8086u };
+
+        // References mostly agree with the live table, with a few cells flipped each. As a driver
+        // history they're all the live adapter, one driver after another.
+        for (uint32_t report = 1u; report < reports; ++report)
+        {
+            SupportReport reference;
+            reference.Adapter.Name = "Reference GPU " + std::to_string(report);
+            reference.Adapter.VendorId = driverHistory ? m_gpuInfo.VendorId : referenceVendors[report % referenceVendors.size()];
+            reference.Adapter.DriverVersion = driverHistory ? (31ull << 48u) | report : 0u;
+            reference.Capabilities = m_headerNames;
+            reference.Table = m_supportTable;
+            for (auto& [format, flags] : reference.Table)
+            {
+                for (FormatSupport& flag : flags)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    if ((seed >> 24u) < 8u)
+                        flag = (flag == FormatSupport::PASS) ? FormatSupport::FAIL : FormatSupport::PASS;
+                }
+            }
+            m_importedReports.push_back(std::move(reference));
+        }
+    }
+
+    uint32_t GetWidth() const override { return m_width; }
+    uint32_t GetHeight() const override { return m_height; }
+
+    const GPUInfo& GetGPUInfo() const override { return m_gpuInfo; }
+    const std::vector<const char*>& GetTableHeaders() const override { return m_tableHeaders; }
+    const SupportTable& GetSupportTable() const override { return m_supportTable; }
+    uint32_t GetSupportTableVersion() const override { return 1u; }
+    bool IsSupportTableComplete() const override { return true; }
+    const std::vector<SupportReport>& GetImportedReports() const override { return m_importedReports; }
+    uint32_t GetImportedReportsVersion() const override { return 1u; }
+
+    bool ExportFormatSupportTable() override { return false; }
+    bool ExportCopyableFootprints() override { return false; }
+    bool ExportAllocationInfo() override { return false; }
+    bool IsAllocationInfoReady() const override { return true; }
+    void OpenFileDialogue() override {}
+    void SendFileSaveErrorEvent() override {}
+
+private:
+    uint32_t m_width;
+    uint32_t m_height;
+    GPUInfo m_gpuInfo;
+    std::vector<std::string> m_headerNames;
+    std::vector<const char*> m_tableHeaders;
+    SupportTable m_supportTable;
+    std::vector<SupportReport> m_importedReports;
+};
+
+struct FrameStats
+{
+    double CpuMs = 0.0;
+    uint64_t HeapAllocs = 0u;
+    uint64_t ImGuiAllocs = 0u;
+    uint64_t ImGuiSystemAllocs = 0u; // ImGui allocations the pools couldn't serve
+    int Vertices = 0;
+    int Indices = 0;
+    int DrawCmds = 0;
+    int DrawLists = 0;
+};
+
+static FrameStats RunFrame(ImGuiLayer& layer)
+{
+    const uint64_t newBefore = g_newCount.load();
+    const ImGuiAllocatorStats imguiBefore = GetImGuiAllocatorStats();
+    const auto start = std::chrono::steady_clock::now();
+
+    ImGui::NewFrame();
+    layer.OnRender();
+    ImGui::Render();
+
+    // The null renderer: walk the draw data like a backend would, but only count it
+    FrameStats stats;
+    const ImDrawData* drawData = ImGui::GetDrawData();
+    stats.Vertices = drawData->TotalVtxCount;
+    stats.Indices = drawData->TotalIdxCount;
+    stats.DrawLists = drawData->CmdListsCount;
+    for (const ImDrawList* drawList : drawData->CmdLists)
+        stats.DrawCmds += drawList->CmdBuffer.Size;
+
+    stats.CpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    stats.HeapAllocs = g_newCount.load() - newBefore;
+    const ImGuiAllocatorStats imguiAfter = GetImGuiAllocatorStats();
+    stats.ImGuiAllocs = imguiAfter.Allocs - imguiBefore.Allocs;
+    stats.ImGuiSystemAllocs = imguiAfter.SystemAllocs - imguiBefore.SystemAllocs;
+    return stats;
+}
+
+static bool HasFlag(int argc, char** argv, const char* name)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static uint32_t ParseArg(int argc, char** argv, const char* name, const uint32_t fallback)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+    }
+    return fallback;
+}
+
+static const char* FindArg(int argc, char** argv, const char* name)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return argv[i + 1];
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t rows = ParseArg(argc, argv, "--rows", 120u);
+    const uint32_t columns = std::max(1u, ParseArg(argc, argv, "--cols", SUPPORT_FLAGS_COUNT));
+    const uint32_t frames = std::max(1u, ParseArg(argc, argv, "--frames", 200u));
+    const uint32_t width = ParseArg(argc, argv, "--width", 1280u);
+    const uint32_t height = ParseArg(argc, argv, "--height", 720u);
+    const uint32_t reports = std::max(1u, ParseArg(argc, argv, "--reports", 1u));
+    const bool compare = HasFlag(argc, argv, "--compare");
+    const bool heatmap = HasFlag(argc, argv, "--heatmap");
+    const bool timeline = HasFlag(argc, argv, "--timeline");
+    const char* tracePath = FindArg(argc, argv, "--trace");
+    if (tracePath)
+    {
+        SetTraceThreadName("Main");
+        StartTrace();
+    }
+
+    InstallImGuiAllocator();
+    ImGui::CreateContext();
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.BackendRendererName = "null";
+    io.IniFilename = nullptr;
+    io.LogFilename = nullptr;
+    io.DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui::StyleColorsDark();
+
+    NullBackend backend(rows, columns, reports, timeline, width, height);
+    ImGuiLayer layer;
+    layer.BindBackend(backend);
+    ImGuiLayer::ViewMode viewMode = ImGuiLayer::ViewMode::SupportTable;
+    if (compare)
+        viewMode = ImGuiLayer::ViewMode::Comparison;
+    if (heatmap)
+        viewMode = ImGuiLayer::ViewMode::Heatmap;
+    if (timeline)
+        viewMode = ImGuiLayer::ViewMode::Timeline;
+    layer.SetViewMode(viewMode);
+    layer.SetShowAllocatorStats(HasFlag(argc, argv, "--alloc-overlay"));
+    // Font atlas bake or cache load, up to the RGBA conversion the renderer would upload
+    const char* fontCachePath = FindArg(argc, argv, "--font-cache");
+    const auto initialiseStart = std::chrono::steady_clock::now();
+    if (fontCachePath)
+        layer.Initialise(*io.Fonts, fontCachePath);
+    else
+        layer.Initialise();
+
+    // The null renderer never uploads the atlas, but NewFrame() expects it to be built
+    unsigned char* pixels = nullptr;
+    int texWidth = 0;
+    int texHeight = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &texWidth, &texHeight);
+    const double initialiseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initialiseStart).count();
+
+    // First frames build the sort cache and settle table layout, keep them out of the numbers
+    const FrameStats firstFrame = RunFrame(layer);
+    for (int i = 0; i < 2; ++i)
+        RunFrame(layer);
+
+    FrameStats total;
+    double minMs = 1e30;
+    double maxMs = 0.0;
+    FrameStats last;
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        last = RunFrame(layer);
+        total.CpuMs += last.CpuMs;
+        total.HeapAllocs += last.HeapAllocs;
+        total.ImGuiAllocs += last.ImGuiAllocs;
+        total.ImGuiSystemAllocs += last.ImGuiSystemAllocs;
+        minMs = std::min(minMs, last.CpuMs);
+        maxMs = std::max(maxMs, last.CpuMs);
+    }
+
+    const char* viewName = timeline ? " (timeline view)" : (heatmap ? " (heatmap view)" : (compare ? " (comparison view)" : ""));
+    std::printf("rows %u, capability columns %u, reports %u%s, %ux%u, %u frames\n", rows, columns, reports, viewName, width, height, frames);
+    std::printf("font atlas       %.3f ms%s\n", initialiseMs, fontCachePath ? " (with --font-cache)" : "");
+    std::printf("first frame      %.3f ms\n", firstFrame.CpuMs);
+    std::printf("cpu per frame    mean %.3f ms, min %.3f ms, max %.3f ms\n", total.CpuMs / frames, minMs, maxMs);
+    std::printf("draw data        %d vertices, %d indices, %d draw cmds in %d draw lists\n", last.Vertices, last.Indices, last.DrawCmds, last.DrawLists);
+    std::printf("allocs per frame %.2f heap (operator new), %.2f ImGui, %.2f ImGui reaching malloc\n", static_cast<double>(total.HeapAllocs) / frames,
+        static_cast<double>(total.ImGuiAllocs) / frames, static_cast<double>(total.ImGuiSystemAllocs) / frames);
+
+    ImGui::DestroyContext();
+    if (tracePath && !WriteTraceJSON(tracePath))
+    {
+        std::fprintf(stderr, "Couldn't write %s\n", tracePath);
+        return 1;
+    }
+    return 0;
+}